@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <utility>
+
+/**
+ * Stack over one growable contiguous block. Elements are constructed in
+ * place, so they need not be default constructible.
+ */
+template <typename T>
+class ArrayStack {
+   private:
+    static const constexpr size_t min_capacity = 16;
+    static const constexpr int size_multiplier = 2;
+
+    T* m_array;
+    size_t m_capacity;
+    size_t m_size;
+
+    void reallocate(size_t capacity) {
+        T* array = static_cast<T*>(::operator new(capacity * sizeof(T)));
+        for (size_t i = 0; i < m_size; ++i) {
+            new (array + i) T(std::move(m_array[i]));
+            m_array[i].~T();
+        }
+        ::operator delete(m_array);
+        m_array = array;
+        m_capacity = capacity;
+    }
+
+   public:
+    ArrayStack() : m_array(nullptr), m_capacity(0), m_size(0) {}
+    ArrayStack(const ArrayStack& o) : ArrayStack() {
+        reserve(o.m_size);
+        for (; m_size < o.m_size; ++m_size)
+            new (m_array + m_size) T(o.m_array[m_size]);
+    }
+    ArrayStack& operator=(const ArrayStack& o) {
+        auto copy = o;
+        std::swap(*this, copy);
+        return *this;
+    }
+    ArrayStack(ArrayStack&& o) : ArrayStack() { *this = std::move(o); }
+    ArrayStack& operator=(ArrayStack&& o) {
+        std::swap(m_array, o.m_array);
+        std::swap(m_capacity, o.m_capacity);
+        std::swap(m_size, o.m_size);
+        return *this;
+    }
+    ~ArrayStack() {
+        clear();
+        ::operator delete(m_array);
+    }
+
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    void reserve(size_t capacity) {
+        if (capacity > m_capacity) reallocate(capacity);
+    }
+
+    template <typename... Args>
+    T& emplace(Args&&... args) {
+        if (m_size == m_capacity)
+            reallocate(m_capacity ? m_capacity * size_multiplier
+                                  : min_capacity);
+        return *new (m_array + m_size++) T(std::forward<Args>(args)...);
+    }
+    template <typename TT>
+    void push(TT&& t) {
+        emplace(std::forward<TT>(t));
+    }
+    T& top() { return m_array[m_size - 1]; }
+    const T& top() const { return m_array[m_size - 1]; }
+    T pop() {
+        T t = std::move(m_array[--m_size]);
+        m_array[m_size].~T();
+        return t;
+    }
+    void clear() {
+        for (; m_size > 0; --m_size) m_array[m_size - 1].~T();
+    }
+};
@@ -115,6 +115,26 @@ class ForwardList {
         delete current;
         return true;
     }
+    template <typename F>
+    size_t remove_if(F f) {
+        size_t removed = 0;
+        Node* previous = nullptr;
+        for (Node* current = m_head; current;) {
+            Node* next = current->m_next;
+            if (f(current->m_value)) {
+                if (previous)
+                    previous->m_next = next;
+                else
+                    m_head = next;
+                delete current;
+                ++removed;
+            } else
+                previous = current;
+            current = next;
+        }
+        m_tail = previous;
+        return removed;
+    }
     bool empty() const { return m_head == nullptr; }
     void clear() {
         remove_nodes();
@@ -1,9 +1,12 @@
 #pragma once
 
 #include <iostream>
+#include <memory>
 
 #include "forward_list.h"
 #include "graph_common.h"
+#include "hash_map.h"
+#include "small_vector.h"
 #include "vector.h"
 
 namespace Graph {
@@ -17,6 +20,7 @@ class Edge {
 
    public:
     using value_type = T;
+    Edge() = default;
     Edge(const T& t) : m_weight(t) {}
     T weight() const { return m_weight; }
     void set_weight(const T& weight) { m_weight = weight; }
@@ -28,6 +32,7 @@ class FlowEdge : public Edge<T> {
     T m_flow;
 
    public:
+    FlowEdge() = default;
     FlowEdge(const T& cap, const T& flow) : Edge<T>(cap), m_flow(flow) {}
     T cap() const { return Edge<T>::m_weight; }
     T flow() const { return m_flow; }
@@ -58,10 +63,35 @@ class VertexLink<T_graph_type, Edge<bool>> : public VertexLinkBase {
         : VertexLinkBase(target) {}
 };
 
+/**
+ * Edge storage policies: a linked list with one node per edge, or a
+ * contiguous array keeping the first N links inline in the vertex. Only
+ * random access storage supports the hub index of high degree vertices.
+ * Adding or removing a link of a vertex may move the others, invalidating
+ * the iterators over its links and the edges returned by get_edge. Inline
+ * links move with their vertex, so with SmallVectorLinks create_vertex
+ * invalidates the edges of every vertex as well.
+ */
+struct ForwardListLinks {
+    template <typename T>
+    using container_type = ForwardList<T>;
+    static const constexpr bool random_access = false;
+};
+
+template <size_t N = 4>
+struct SmallVectorLinks {
+    template <typename T>
+    using container_type = SmallVector<T, N>;
+    static const constexpr bool random_access = true;
+};
+
+using DefaultLinks = SmallVectorLinks<>;
+
 template <GraphType TT_graph_type, typename VV>
 class AdjacencyListsBase;
 
-template <GraphType T_graph_type, typename VT, typename E, typename D>
+template <GraphType T_graph_type, typename VT, typename E, typename D,
+          typename S = DefaultLinks>
 class AdjListsVertexBase : public VertexBase<VT> {
    private:
     template <bool T_is_const>
@@ -70,32 +100,130 @@ class AdjListsVertexBase : public VertexBase<VT> {
     class Edges_iterator;
     template <GraphType TT_graph_type, typename VV, typename ET>
     friend class AdjacencyLists;
+    template <GraphType TT_graph_type, typename VV>
+    friend class AdjacencyListsBase;
 
     using vertex_link_type = VertexLink<T_graph_type, E>;
+    using links_type = typename S::template container_type<vertex_link_type>;
 
     inline D* derived() { return static_cast<D*>(this); }
     inline const D* derived() const { return static_cast<const D*>(this); }
 
+    using hub_index_type = HashMap<size_t, size_t>;
+
+    // target -> position of its first link in m_links, allocated only while
+    // the degree is above the hub threshold of the graph
+    std::unique_ptr<hub_index_type> m_hub_index;
+
+    bool hub_index_valid() const {
+        return m_hub_index && !m_adjacency_lists->m_bulk_load;
+    }
+    const vertex_link_type* find_link(size_t target) const {
+        if constexpr (S::random_access)
+            if (hub_index_valid()) {
+                auto position = m_hub_index->find(target);
+                return position ? &m_links[*position] : nullptr;
+            }
+        for (auto link = m_links.cbegin(); link != m_links.cend(); ++link)
+            if (link->target() == target) return &*link;
+        return nullptr;
+    }
+    void update_hub_index() {
+        if constexpr (S::random_access) {
+            m_hub_index.reset();
+            if (m_links.size() <= m_adjacency_lists->m_hub_threshold) return;
+            m_hub_index = std::make_unique<hub_index_type>();
+            m_hub_index->reserve(m_links.size());
+            for (size_t i = 0; i < m_links.size(); ++i)
+                m_hub_index->insert(m_links[i].target(), i);
+        }
+    }
+    // the link to target at position removed is gone and the later ones
+    // moved down one slot
+    void repair_hub_index(size_t target, size_t removed) {
+        if (m_links.size() <= m_adjacency_lists->m_hub_threshold) {
+            m_hub_index.reset();
+            return;
+        }
+        m_hub_index->erase(target);
+        for (size_t i = removed; i < m_links.size(); ++i) {
+            auto inserted = m_hub_index->insert(m_links[i].target(), i);
+            if (*inserted.first > i) *inserted.first = i;
+        }
+    }
+    // keeps the first link to every target (both copies of an undirected
+    // self loop); seen[w] == index() + 1 marks an already linked target
+    void remove_duplicate_links(Array<size_t>& seen) {
+        size_t self = index();
+        size_t self_loops = 0;
+        m_links.remove_if([&](const vertex_link_type& link) {
+            if (T_graph_type == GraphType::GRAPH && link.target() == self)
+                return ++self_loops > 2;
+            if (seen[link.target()] == self + 1) return true;
+            seen[link.target()] = self + 1;
+            return false;
+        });
+        update_hub_index();
+    }
+
    protected:
     using adj_lists_type = AdjacencyListsBase<T_graph_type, D>;
     adj_lists_type* m_adjacency_lists;
-    ForwardList<vertex_link_type> m_links;
+    links_type m_links;
 
     AdjListsVertexBase(const VT& value, adj_lists_type* adjacency_lists)
         : VertexBase<VT>(value), m_adjacency_lists(adjacency_lists) {}
     AdjListsVertexBase() : m_adjacency_lists(nullptr) {}
 
-    bool link_exists(const AdjListsVertexBase& v) {
-        for (auto link = m_links.begin(); link != m_links.end(); ++link)
-            if (link->target() == v.index()) return true;
-        return false;
+    AdjListsVertexBase(const AdjListsVertexBase& o)
+        : VertexBase<VT>(o),
+          m_hub_index(o.m_hub_index
+                          ? std::make_unique<hub_index_type>(*o.m_hub_index)
+                          : nullptr),
+          m_adjacency_lists(o.m_adjacency_lists),
+          m_links(o.m_links) {}
+    AdjListsVertexBase& operator=(const AdjListsVertexBase& o) {
+        auto copy = o;
+        return *this = std::move(copy);
+    }
+    AdjListsVertexBase(AdjListsVertexBase&&) = default;
+    AdjListsVertexBase& operator=(AdjListsVertexBase&&) = default;
+
+    bool link_exists(const AdjListsVertexBase& v) const {
+        return find_link(v.index()) != nullptr;
     }
+    // while bulk loading the hub indices go stale, rebuilt by the commit
     void add_link(const AdjListsVertexBase& v, const E& edge) {
         m_links.emplace_back(v.index(), edge);
+        if constexpr (S::random_access) {
+            if (m_adjacency_lists->m_bulk_load) return;
+            if (m_hub_index)
+                m_hub_index->insert(v.index(), m_links.size() - 1);
+            else if (m_links.size() > m_adjacency_lists->m_hub_threshold)
+                update_hub_index();
+        }
+    }
+    void reserve_links(size_t count) {
+        if constexpr (S::random_access) m_links.reserve(m_links.size() + count);
+    }
+    template <typename F>
+    void remove_first_link_if(F f) {
+        if constexpr (S::random_access) {
+            for (size_t i = 0; i < m_links.size(); ++i)
+                if (f(m_links[i])) {
+                    auto target = m_links[i].target();
+                    m_links.erase(i);
+                    if (hub_index_valid()) repair_hub_index(target, i);
+                    return;
+                }
+        } else {
+            m_links.remove_first_if(f);
+        }
     }
 
    public:
     using edge_type = E;
+    using links_policy_type = S;
 
     using iterator = Iterator<false>;
     using const_iterator = Iterator<true>;
@@ -122,33 +250,26 @@ class AdjListsVertexBase : public VertexBase<VT> {
     }
 
     void remove_edge(const AdjListsVertexBase& v) {
-        m_links.remove_first_if([&v](const vertex_link_type& edge) {
+        remove_first_link_if([&v](const vertex_link_type& edge) {
             return v.index() == edge.target();
         });
     }
     bool has_edge(const AdjListsVertexBase& v) const {
-        for (auto l = cbegin(); l != cend(); ++l)
-            if (*l == v) return true;
-        return false;
-    }
-    const E* get_edge(size_t v) const {
-        for (auto e = cedges_begin(); e != cedges_end(); ++e)
-            if (e->target().index() == v) return e->m_edge;
-        return nullptr;
+        return find_link(v.index()) != nullptr;
     }
+    const E* get_edge(size_t v) const { return find_link(v); }
     E* get_edge(size_t v) {
-        for (auto e = edges_begin(); e != edges_end(); ++e)
-            if (e->target().index() == v) return e->m_edge;
-        return nullptr;
+        return const_cast<vertex_link_type*>(find_link(v));
     }
 };
 
-template <GraphType T_graph_type, typename VT, typename E>
+template <GraphType T_graph_type, typename VT, typename E,
+          typename S = DefaultLinks>
 class Vertex : public AdjListsVertexBase<T_graph_type, VT, E,
-                                         Vertex<T_graph_type, VT, E>> {
+                                         Vertex<T_graph_type, VT, E, S>, S> {
    private:
-    using Base =
-        AdjListsVertexBase<T_graph_type, VT, E, Vertex<T_graph_type, VT, E>>;
+    using Base = AdjListsVertexBase<T_graph_type, VT, E,
+                                    Vertex<T_graph_type, VT, E, S>, S>;
     template <GraphType TT_graph_type, typename VV>
     friend class AdjacencyListsBase;
     template <GraphType TT_graph_type, typename VV, typename ET>
@@ -176,19 +297,30 @@ class AdjacencyListsBase {
 
    protected:
     Vector<vertex_type> m_vertices;
+    size_t m_hub_threshold = no_hub_index;
+    bool m_bulk_load = false;
+
+    bool accepts_link(const vertex_type& v, const vertex_type& w) const {
+        return m_bulk_load || !v.link_exists(w);
+    }
 
    private:
-    template <GraphType TT_graph_type, typename VV, typename EE, typename D>
+    template <GraphType TT_graph_type, typename VV, typename EE, typename D,
+              typename SS>
     friend class AdjListsVertexBase;
     void update_vertices_this_link() {
         for (auto& v : m_vertices) v.m_adjacency_lists = this;
     }
 
    public:
+    static const constexpr size_t no_hub_index = static_cast<size_t>(-1);
+
     AdjacencyListsBase() = default;
 
     AdjacencyListsBase(const AdjacencyListsBase& o, bool update_links)
-        : m_vertices(o.m_vertices) {}
+        : m_vertices(o.m_vertices),
+          m_hub_threshold(o.m_hub_threshold),
+          m_bulk_load(o.m_bulk_load) {}
     AdjacencyListsBase(const AdjacencyListsBase& o)
         : AdjacencyListsBase(o, true) {
         update_vertices_this_link();
@@ -199,11 +331,15 @@ class AdjacencyListsBase {
         return *this;
     }
     AdjacencyListsBase(AdjacencyListsBase&& o)
-        : m_vertices(std::move(o.m_vertices)) {
+        : m_vertices(std::move(o.m_vertices)),
+          m_hub_threshold(o.m_hub_threshold),
+          m_bulk_load(o.m_bulk_load) {
         update_vertices_this_link();
     }
     AdjacencyListsBase& operator=(AdjacencyListsBase&& o) {
         std::swap(m_vertices, o.m_vertices);
+        std::swap(m_hub_threshold, o.m_hub_threshold);
+        std::swap(m_bulk_load, o.m_bulk_load);
         update_vertices_this_link();
         o.update_vertices_this_link();
         return *this;
@@ -216,6 +352,33 @@ class AdjacencyListsBase {
 
     size_t vertices_count() const { return m_vertices.size(); }
 
+    /**
+     * Vertices with more than threshold links keep a hash index over their
+     * targets, so duplicate checks and edge lookups on hubs take O(1).
+     */
+    void set_hub_index_threshold(size_t threshold) {
+        m_hub_threshold = threshold;
+        if (!m_bulk_load)
+            for (auto& v : m_vertices) v.update_hub_index();
+    }
+    size_t hub_index_threshold() const { return m_hub_threshold; }
+
+    /**
+     * Between these calls add_edge appends links without looking for
+     * duplicates; the commit drops them in one O(V + E) pass that keeps the
+     * first copy of every edge, so the result matches checked insertion.
+     */
+    void begin_bulk_load() { m_bulk_load = true; }
+    void commit_bulk_load() {
+        m_bulk_load = false;
+        Array<size_t> seen(m_vertices.size(), 0);
+        for (auto& v : m_vertices) v.remove_duplicate_links(seen);
+    }
+    bool bulk_loading() const { return m_bulk_load; }
+
+    // room for count more links of v, where the links storage allows it
+    void reserve_links(vertex_type& v, size_t count) { v.reserve_links(count); }
+
     const vertex_type& operator[](size_t index) const {
         return m_vertices[index];
     }
@@ -265,7 +428,7 @@ class AdjacencyLists : public AdjacencyListsBase<T_graph_type, V>,
                        public EdgesRemover<T_graph_type, V> {
    public:
     AdjacencyLists& add_edge(V& v1, V& v2, const typename V::edge_type& edge) {
-        if (!v1.link_exists(v2)) {
+        if (this->accepts_link(v1, v2)) {
             v1.add_link(v2, edge);
             v2.add_link(v1, edge);
         }
@@ -279,7 +442,7 @@ class AdjacencyLists<GraphType::GRAPH, V, bool>
       public EdgesRemover<GraphType::GRAPH, V> {
    public:
     AdjacencyLists& add_edge(V& v1, V& v2) {
-        if (!v1.link_exists(v2)) {
+        if (this->accepts_link(v1, v2)) {
             v1.add_link(v2, true);
             v2.add_link(v1, true);
         }
@@ -293,7 +456,7 @@ class AdjacencyLists<GraphType::DIGRAPH, V, ET>
       public EdgesRemover<GraphType::DIGRAPH, V> {
    public:
     AdjacencyLists& add_edge(V& v1, V& v2, const typename V::edge_type& edge) {
-        if (!v1.link_exists(v2)) v1.add_link(v2, edge);
+        if (this->accepts_link(v1, v2)) v1.add_link(v2, edge);
         return *this;
     }
 };
@@ -304,20 +467,21 @@ class AdjacencyLists<GraphType::DIGRAPH, V, bool>
       public EdgesRemover<GraphType::DIGRAPH, V> {
    public:
     AdjacencyLists& add_edge(V& v1, V& v2) {
-        if (!v1.link_exists(v2)) v1.add_link(v2, true);
+        if (this->accepts_link(v1, v2)) v1.add_link(v2, true);
         return *this;
     }
 };
 
-template <GraphType T_graph_type, typename VT, typename E, typename D>
+template <GraphType T_graph_type, typename VT, typename E, typename D,
+          typename S>
 template <bool T_is_const>
-class AdjListsVertexBase<T_graph_type, VT, E, D>::Iterator {
+class AdjListsVertexBase<T_graph_type, VT, E, D, S>::Iterator {
    private:
     using value_type = std::conditional_t<T_is_const, const D, D>;
 
    protected:
     using link_type = VertexLink<T_graph_type, E>;
-    using links_type = ForwardList<link_type>;
+    using links_type = typename AdjListsVertexBase::links_type;
     using links_iterator_type =
         std::conditional_t<T_is_const, typename links_type::const_iterator,
                            typename links_type::iterator>;
@@ -342,9 +506,10 @@ class AdjListsVertexBase<T_graph_type, VT, E, D>::Iterator {
     }
 };
 
-template <GraphType T_graph_type, typename VT, typename E, typename D>
+template <GraphType T_graph_type, typename VT, typename E, typename D,
+          typename S>
 template <bool T_is_const>
-class AdjListsVertexBase<T_graph_type, VT, E, D>::Edges_iterator
+class AdjListsVertexBase<T_graph_type, VT, E, D, S>::Edges_iterator
     : public Iterator<T_is_const> {
    private:
     using Base = Iterator<T_is_const>;
@@ -360,10 +525,8 @@ class AdjListsVertexBase<T_graph_type, VT, E, D>::Edges_iterator
 
     entry_type m_entry;
 
-    static auto links_end(ForwardList<link_type>& links) { return links.end(); }
-    static auto links_end(const ForwardList<link_type>& links) {
-        return links.cend();
-    }
+    static auto links_end(links_type& links) { return links.end(); }
+    static auto links_end(const links_type& links) { return links.cend(); }
 
     template <typename VV, typename EE, bool TT_is_const, typename It>
     static void update_edge_p(EdgesIteratorEntry<VV, EE, TT_is_const>& entry,
@@ -405,24 +568,25 @@ struct InternalPrinterBase {
     }
 };
 
-template <GraphType TT_graph_type, typename VV, typename EE>
+template <GraphType TT_graph_type, typename VV, typename EE, typename SS>
 struct InternalPrinter
     : public InternalPrinterBase<
-          AdjacencyLists<TT_graph_type, Vertex<TT_graph_type, VV, EE>>,
-          InternalPrinter<TT_graph_type, VV, EE>> {
-    static void print_vertex(const Vertex<TT_graph_type, VV, EE>& v,
+          AdjacencyLists<TT_graph_type, Vertex<TT_graph_type, VV, EE, SS>>,
+          InternalPrinter<TT_graph_type, VV, EE, SS>> {
+    static void print_vertex(const Vertex<TT_graph_type, VV, EE, SS>& v,
                              std::ostream& stream) {
         for (auto w = v.cedges_begin(); w != v.cedges_end(); ++w)
             stream << w->target().index() << "(" << w->edge().weight() << ") ";
     }
 };
 
-template <GraphType TT_graph_type, typename VV>
-struct InternalPrinter<TT_graph_type, VV, Edge<bool>>
+template <GraphType TT_graph_type, typename VV, typename SS>
+struct InternalPrinter<TT_graph_type, VV, Edge<bool>, SS>
     : public InternalPrinterBase<
-          AdjacencyLists<TT_graph_type, Vertex<TT_graph_type, VV, Edge<bool>>>,
-          InternalPrinter<TT_graph_type, VV, Edge<bool>>> {
-    static void print_vertex(const Vertex<TT_graph_type, VV, Edge<bool>>& v,
+          AdjacencyLists<TT_graph_type,
+                         Vertex<TT_graph_type, VV, Edge<bool>, SS>>,
+          InternalPrinter<TT_graph_type, VV, Edge<bool>, SS>> {
+    static void print_vertex(const Vertex<TT_graph_type, VV, Edge<bool>, SS>& v,
                              std::ostream& stream) {
         for (auto w = v.cedges_begin(); w != v.cedges_end(); ++w)
             stream << w->target().index() << " ";
@@ -432,17 +596,18 @@ struct InternalPrinter<TT_graph_type, VV, Edge<bool>>
 }  // namespace Adjacency_lists_ns
 
 template <GraphType T_graph_type, typename V, typename TE = bool,
-          typename E = Adjacency_lists_ns::Edge<TE>>
+          typename E = Adjacency_lists_ns::Edge<TE>,
+          typename S = Adjacency_lists_ns::DefaultLinks>
 using AdjacencyLists = Adjacency_lists_ns::AdjacencyLists<
-    T_graph_type, Adjacency_lists_ns::Vertex<T_graph_type, V, E>>;
+    T_graph_type, Adjacency_lists_ns::Vertex<T_graph_type, V, E, S>>;
 
 template <GraphType T_graph_type, typename V>
 void print_representation(
     const Adjacency_lists_ns::AdjacencyLists<T_graph_type, V>& g,
     std::ostream& stream) {
-    Adjacency_lists_ns::InternalPrinter<T_graph_type, typename V::value_type,
-                                        typename V::edge_type>::print(g,
-                                                                      stream);
+    Adjacency_lists_ns::InternalPrinter<
+        T_graph_type, typename V::value_type, typename V::edge_type,
+        typename V::links_policy_type>::print(g, stream);
 }
 
 }  // namespace Graph
@@ -1,6 +1,14 @@
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
 #include <iostream>
+#include <memory>
+#include <new>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#endif
 
 #include "graph_common.h"
 #include "vector.h"
@@ -30,6 +38,276 @@ constexpr bool Edge<bool>::empty_value() {
     return false;
 }
 
+/**
+ * Square row-major matrix in one flat buffer. Rows are padded to whole cache
+ * lines and the capacity grows geometrically, so adding a vertex costs
+ * amortized O(V) and a copy is a single pass over the buffer.
+ */
+template <typename E>
+class MatrixStorage {
+   private:
+    static const constexpr size_t cache_line = 64;
+    static const constexpr size_t min_capacity = 8;
+    static const constexpr size_t cells_per_line =
+        sizeof(E) < cache_line ? cache_line / sizeof(E) : 1;
+
+    E* m_cells;
+    size_t m_size;
+    size_t m_capacity;
+    size_t m_stride;
+
+    static E* allocate(size_t count) {
+        return static_cast<E*>(::operator new(
+            count * sizeof(E), std::align_val_t(cache_line)));
+    }
+    void destroy() {
+        std::destroy_n(m_cells, m_capacity * m_stride);
+        ::operator delete(m_cells, std::align_val_t(cache_line));
+    }
+    void grow(size_t capacity) {
+        size_t stride = (capacity + cells_per_line - 1) / cells_per_line *
+                        cells_per_line;
+        E* cells = allocate(capacity * stride);
+        std::uninitialized_fill_n(cells, capacity * stride, E());
+        for (size_t r = 0; r < m_size; ++r)
+            std::copy_n(row(r), m_size, cells + r * stride);
+        destroy();
+        m_cells = cells;
+        m_capacity = capacity;
+        m_stride = stride;
+    }
+
+   public:
+    MatrixStorage()
+        : m_cells(nullptr), m_size(0), m_capacity(0), m_stride(0) {}
+    MatrixStorage(const MatrixStorage& o)
+        : m_cells(allocate(o.m_capacity * o.m_stride)),
+          m_size(o.m_size),
+          m_capacity(o.m_capacity),
+          m_stride(o.m_stride) {
+        std::uninitialized_copy_n(o.m_cells, m_capacity * m_stride, m_cells);
+    }
+    MatrixStorage& operator=(const MatrixStorage& o) {
+        auto copy = o;
+        std::swap(*this, copy);
+        return *this;
+    }
+    MatrixStorage(MatrixStorage&& o) : MatrixStorage() { *this = std::move(o); }
+    MatrixStorage& operator=(MatrixStorage&& o) {
+        std::swap(m_cells, o.m_cells);
+        std::swap(m_size, o.m_size);
+        std::swap(m_capacity, o.m_capacity);
+        std::swap(m_stride, o.m_stride);
+        return *this;
+    }
+    ~MatrixStorage() { destroy(); }
+
+    size_t size() const { return m_size; }
+    size_t stride() const { return m_stride; }
+    void resize(size_t size) {
+        if (size > m_capacity)
+            grow(std::max({size, m_capacity * 2, min_capacity}));
+        m_size = size;
+    }
+
+    E* row(size_t r) { return m_cells + r * m_stride; }
+    const E* row(size_t r) const { return m_cells + r * m_stride; }
+    E& operator()(size_t r, size_t c) { return row(r)[c]; }
+    const E& operator()(size_t r, size_t c) const { return row(r)[c]; }
+    bool exists(size_t r, size_t c) const { return row(r)[c].exists(); }
+    void set(size_t r, size_t c, const E& e) { row(r)[c] = e; }
+    // the edge in row r and column c, nullptr if there is none
+    const E* edge(size_t r, size_t c) const {
+        auto& e = row(r)[c];
+        return e.exists() ? &e : nullptr;
+    }
+    E* edge(size_t r, size_t c) {
+        auto& e = row(r)[c];
+        return e.exists() ? &e : nullptr;
+    }
+
+    // first column at or after c holding an edge, size() if there is none
+    size_t find_next(size_t r, size_t c) const {
+        auto cells = row(r);
+        for (; c < m_size && !cells[c].exists(); ++c)
+            ;
+        return c;
+    }
+};
+
+/**
+ * Row OR kernels: target[w] |= source[w] for w < n, selected once for the
+ * processor, since the debug build leaves plain loops unvectorized.
+ */
+using OrRow = void (*)(uint64_t* target, const uint64_t* source, size_t n);
+
+inline void or_row_scalar(uint64_t* target, const uint64_t* source,
+                          size_t n) {
+    for (size_t w = 0; w < n; ++w) target[w] |= source[w];
+}
+
+#if defined(__GNUC__) && defined(__x86_64__)
+
+inline void or_row_sse2(uint64_t* target, const uint64_t* source, size_t n) {
+    size_t w = 0;
+    for (; w + 2 <= n; w += 2) {
+        auto p = reinterpret_cast<__m128i*>(target + w);
+        _mm_storeu_si128(
+            p, _mm_or_si128(_mm_loadu_si128(p),
+                            _mm_loadu_si128(
+                                reinterpret_cast<const __m128i*>(source + w))));
+    }
+    or_row_scalar(target + w, source + w, n - w);
+}
+
+__attribute__((target("avx2"))) inline void or_row_avx2(
+    uint64_t* target, const uint64_t* source, size_t n) {
+    size_t w = 0;
+    for (; w + 4 <= n; w += 4) {
+        auto p = reinterpret_cast<__m256i*>(target + w);
+        _mm256_storeu_si256(
+            p, _mm256_or_si256(
+                   _mm256_loadu_si256(p),
+                   _mm256_loadu_si256(
+                       reinterpret_cast<const __m256i*>(source + w))));
+    }
+    or_row_scalar(target + w, source + w, n - w);
+}
+
+#endif
+
+inline OrRow select_or_row() {
+#if defined(__GNUC__) && defined(__x86_64__)
+    if (__builtin_cpu_supports("avx2")) return or_row_avx2;
+    return or_row_sse2;
+#endif
+    return or_row_scalar;
+}
+
+/**
+ * Boolean matrix packed into 64-bit words, so a row of V edges takes V / 8
+ * bytes and whole rows can be combined a word at a time.
+ */
+template <>
+class MatrixStorage<Edge<bool>> {
+   private:
+    using word_type = uint64_t;
+    static const constexpr size_t word_bits = 64;
+    static const constexpr size_t cache_line = 64;
+    static const constexpr size_t min_capacity = 64;
+    static const constexpr size_t words_per_line =
+        cache_line / sizeof(word_type);
+
+    word_type* m_words;
+    size_t m_size;
+    size_t m_capacity;
+    size_t m_stride;
+
+    static size_t words_count(size_t bits) {
+        return (bits + word_bits - 1) / word_bits;
+    }
+    static word_type* allocate(size_t count) {
+        return static_cast<word_type*>(::operator new(
+            count * sizeof(word_type), std::align_val_t(cache_line)));
+    }
+    static void deallocate(word_type* words) {
+        ::operator delete(words, std::align_val_t(cache_line));
+    }
+    void grow(size_t capacity) {
+        size_t stride = (words_count(capacity) + words_per_line - 1) /
+                        words_per_line * words_per_line;
+        word_type* words = allocate(capacity * stride);
+        std::fill_n(words, capacity * stride, 0);
+        for (size_t r = 0; r < m_size; ++r)
+            std::copy_n(row(r), m_stride, words + r * stride);
+        deallocate(m_words);
+        m_words = words;
+        m_capacity = capacity;
+        m_stride = stride;
+    }
+    word_type* row(size_t r) { return m_words + r * m_stride; }
+    const word_type* row(size_t r) const { return m_words + r * m_stride; }
+
+   public:
+    MatrixStorage()
+        : m_words(nullptr), m_size(0), m_capacity(0), m_stride(0) {}
+    MatrixStorage(const MatrixStorage& o)
+        : m_words(allocate(o.m_capacity * o.m_stride)),
+          m_size(o.m_size),
+          m_capacity(o.m_capacity),
+          m_stride(o.m_stride) {
+        std::copy_n(o.m_words, m_capacity * m_stride, m_words);
+    }
+    MatrixStorage& operator=(const MatrixStorage& o) {
+        auto copy = o;
+        std::swap(*this, copy);
+        return *this;
+    }
+    MatrixStorage(MatrixStorage&& o) : MatrixStorage() { *this = std::move(o); }
+    MatrixStorage& operator=(MatrixStorage&& o) {
+        std::swap(m_words, o.m_words);
+        std::swap(m_size, o.m_size);
+        std::swap(m_capacity, o.m_capacity);
+        std::swap(m_stride, o.m_stride);
+        return *this;
+    }
+    ~MatrixStorage() { deallocate(m_words); }
+
+    size_t size() const { return m_size; }
+    void resize(size_t size) {
+        if (size > m_capacity)
+            grow(std::max({size, m_capacity * 2, min_capacity}));
+        m_size = size;
+    }
+
+    bool exists(size_t r, size_t c) const {
+        return row(r)[c / word_bits] >> (c % word_bits) & 1;
+    }
+    // a bit has no address: every edge is the same read-only true edge
+    const Edge<bool>* edge(size_t r, size_t c) const {
+        static const Edge<bool> present(true);
+        return exists(r, c) ? &present : nullptr;
+    }
+    void set(size_t r, size_t c, const Edge<bool>& e) {
+        word_type bit = word_type(1) << (c % word_bits);
+        if (e.exists())
+            row(r)[c / word_bits] |= bit;
+        else
+            row(r)[c / word_bits] &= ~bit;
+    }
+
+    size_t find_next(size_t r, size_t c) const {
+        if (c >= m_size) return m_size;
+        auto words = row(r);
+        size_t w = c / word_bits;
+        word_type bits = words[w] & (~word_type(0) << (c % word_bits));
+        for (size_t end = words_count(m_size); !bits;) {
+            if (++w == end) return m_size;
+            bits = words[w];
+        }
+        return w * word_bits + __builtin_ctzll(bits);
+    }
+
+    /**
+     * Warshall's algorithm on whole rows: once row s reaches i it takes over
+     * everything i reaches, ORed in by the widest row kernel available.
+     */
+    void close_transitively() {
+        for (size_t i = 0; i < m_size; ++i) set(i, i, true);
+        size_t words = words_count(m_size);
+        auto or_row = select_or_row();
+        for (size_t i = 0; i < m_size; ++i) {
+            const word_type* source = row(i);
+            word_type bit = word_type(1) << (i % word_bits);
+            for (size_t s = 0; s < m_size; ++s) {
+                word_type* target = row(s);
+                if (target[i / word_bits] & bit)
+                    or_row(target, source, words);
+            }
+        }
+    }
+};
+
 template <typename V, typename E>
 class AdjacencyMatrixBase {
    private:
@@ -42,15 +320,13 @@ class AdjacencyMatrixBase {
 
    protected:
     using vertex_type = Vertex;
-    Vector<Vector<E>> m_edges;
+    MatrixStorage<E> m_edges;
 
    public:
     using value_type = V;
     using edge_type = E;
 
-    AdjacencyMatrixBase() : m_edges(100) {
-        for (auto& l : m_edges) l = Vector<E>(100);
-    }
+    AdjacencyMatrixBase() = default;
 
     AdjacencyMatrixBase(const AdjacencyMatrixBase& o)
         : m_vertices(o.m_vertices), m_edges(o.m_edges) {
@@ -74,6 +350,7 @@ class AdjacencyMatrixBase {
 
     vertex_type& create_vertex(const V& t) {
         m_vertices.emplace_back(t, this);
+        m_edges.resize(m_vertices.size());
         return m_vertices[m_vertices.size() - 1];
     }
     size_t vertices_count() const { return m_vertices.size(); }
@@ -82,16 +359,15 @@ class AdjacencyMatrixBase {
         return m_vertices[index];
     }
     vertex_type& operator[](size_t index) { return m_vertices[index]; }
-    bool has_edge(const vertex_type& v, const vertex_type& w) {
-        return m_edges[v][w];
+    bool has_edge(const vertex_type& v, const vertex_type& w) const {
+        return m_edges.exists(v, w);
     }
     const E* get_edge(const vertex_type& v, const vertex_type& w) const {
-        auto& edge = m_edges[v][w];
-        return edge.exists() ? &edge : nullptr;
+        return m_edges.edge(v, w);
     }
-    E* get_edge(const vertex_type& v, const vertex_type& w) {
-        return const_cast<E*>(
-            static_cast<const AdjacencyMatrixBase*>(this)->get_edge(v, w));
+    // read-only for boolean matrices, changed through add and remove_edge
+    auto get_edge(const vertex_type& v, const vertex_type& w) {
+        return m_edges.edge(v, w);
     }
 
     auto begin() { return m_vertices.begin(); }
@@ -101,11 +377,14 @@ class AdjacencyMatrixBase {
     auto crbegin() const { return m_vertices.crbegin(); }
     auto crend() const { return m_vertices.crend(); }
 
+    // reflexive transitive closure in place, boolean matrices only
+    void close_transitively() { m_edges.close_transitively(); }
+
     void print_internal(std::ostream& stream) const {
         auto size = m_vertices.size();
         for (size_t r = 0; r < size; ++r) {
             for (size_t c = 0; c < size; ++c) {
-                stream << m_edges[r][c] << " ";
+                stream << m_edges.exists(r, c) << " ";
             }
             stream << std::endl;
         }
@@ -152,8 +431,8 @@ class AdjacencyMatrix
                               V, E, ET>;
     using vertex_type = typename Base::vertex_type;
     void set_edge(const vertex_type& v1, const vertex_type& v2, const E& e) {
-        Base::m_edges[v1][v2] = e;
-        Base::m_edges[v2][v1] = e;
+        Base::m_edges.set(v1, v2, e);
+        Base::m_edges.set(v2, v1, e);
     }
 };
 
@@ -166,7 +445,7 @@ class AdjacencyMatrix<GraphType::DIGRAPH, V, E, ET>
                               GraphType::DIGRAPH, V, E, ET>;
     using vertex_type = typename Base::vertex_type;
     void set_edge(const vertex_type& v1, const vertex_type& v2, const E& e) {
-        Base::m_edges[v1][v2] = e;
+        Base::m_edges.set(v1, v2, e);
     }
 };
 
@@ -186,14 +465,13 @@ class AdjacencyMatrixBase<V, E>::Vertex : public VertexBase<V> {
         : VertexBase<V>(value), m_matrix(matrix) {}
     Vertex() : m_matrix(nullptr) {}
 
-    Vector<E>& edges() const { return m_matrix->m_edges[*this]; }
     template <typename It, typename VV>
     static It create_begin_it(VV* vertex) {
-        return It(vertex, vertex->edges().begin()).move_to_non_empty();
+        return It(vertex, vertex->m_matrix->m_edges.find_next(*vertex, 0));
     }
     template <typename It, typename VV>
     static It create_end_it(VV* vertex) {
-        return It(vertex, vertex->edges().end());
+        return It(vertex, vertex->m_matrix->m_vertices.size());
     }
 
    public:
@@ -225,39 +503,28 @@ template <bool T_is_const>
 class AdjacencyMatrixBase<V, E>::Vertex::Iterator {
    private:
     using value_type = std::conditional_t<T_is_const, const Vertex, Vertex>;
-    using vertices_type =
-        std::conditional_t<T_is_const, const Vector<Vertex>, Vector<Vertex>>;
     friend class Vertex;
-    Iterator& move_to_non_empty() {
-        for (; m_it != m_edges.end() && !*m_it; ++m_it)
-            ;
-        return *this;
-    }
-    Iterator(value_type* vertex, const typename Vector<E>::iterator& it)
-        : m_vertices(vertex->m_matrix->m_vertices),
-          m_edges(vertex->m_matrix->m_edges[vertex->index()]),
-          m_it(it) {}
-    static Iterator create_begin_it(value_type* vertex) {
-        return Iterator(vertex, vertex->edges().begin()).move_to_non_empty();
-    }
-    static Iterator create_end_it(value_type* vertex) {
-        return {vertex, vertex->edges().end()};
-    }
+    Iterator(value_type* vertex, size_t column)
+        : m_vertex(vertex), m_column(column) {}
 
    protected:
-    vertices_type& m_vertices;
-    Vector<E>& m_edges;
-    typename Vector<E>::iterator m_it;
+    value_type* m_vertex;
+    size_t m_column;
+
+    size_t row() const { return m_vertex->index(); }
+    auto& storage() const { return m_vertex->m_matrix->m_edges; }
+    bool at_end() const { return m_column == storage().size(); }
 
    public:
     Iterator& operator++() {
-        ++m_it;
-        move_to_non_empty();
+        m_column = storage().find_next(row(), m_column + 1);
         return *this;
     }
-    bool operator==(const Iterator& o) const { return m_it == o.m_it; }
+    bool operator==(const Iterator& o) const { return m_column == o.m_column; }
     bool operator!=(const Iterator& o) const { return !operator==(o); }
-    value_type& operator*() const { return m_vertices[m_it - m_edges.begin()]; }
+    value_type& operator*() const {
+        return m_vertex->m_matrix->m_vertices[m_column];
+    }
     value_type* operator->() const { return &operator*(); }
 };
 
@@ -275,26 +542,20 @@ class AdjacencyMatrixBase<V, E>::Vertex::Edges_iterator
 
     entry_type m_entry;
 
-    Edges_iterator(vertex_type* vertex, const typename Vector<E>::iterator& it)
-        : Base(vertex, it), m_entry(vertex) {}
-    Edges_iterator& move_to_non_empty() {
-        Base::move_to_non_empty();
+    Edges_iterator(vertex_type* vertex, size_t column)
+        : Base(vertex, column), m_entry(vertex) {
         update_entry();
-        return *this;
     }
-    template <typename VV, typename EE, bool TT_is_const, typename It>
-    static void update_edge_p(EdgesIteratorEntry<VV, EE, TT_is_const>& entry,
-                              const It& it) {
-        entry.m_edge = &*it;
+    template <typename VV, typename EE, bool TT_is_const>
+    void update_edge_p(EdgesIteratorEntry<VV, EE, TT_is_const>& entry) {
+        entry.m_edge = &Base::storage()(Base::row(), Base::m_column);
     }
-    template <typename VV, bool TT_is_const, typename It>
-    static void update_edge_p(
-        EdgesIteratorEntry<VV, Edge<bool>, TT_is_const>& entry, const It& it) {}
+    template <typename VV, bool TT_is_const>
+    void update_edge_p(EdgesIteratorEntry<VV, Edge<bool>, TT_is_const>&) {}
     void update_entry() {
-        if (Base::m_it != Base::m_edges.end()) {
-            m_entry.m_target =
-                &Base::m_vertices[Base::m_it - Base::m_edges.begin()];
-            update_edge_p(m_entry, Base::m_it);
+        if (!Base::at_end()) {
+            m_entry.m_target = &Base::operator*();
+            update_edge_p(m_entry);
         }
     }
 
@@ -314,6 +575,17 @@ template <GraphType graph_type, typename V, typename TE = bool,
           typename E = Adjacency_matrix_ns::Edge<TE>>
 using AdjacencyMatrix = Adjacency_matrix_ns::AdjacencyMatrix<graph_type, V, E>;
 
+template <GraphType graph_type, typename V>
+Adjacency_matrix_ns::AdjacencyMatrix<graph_type, V,
+                                     Adjacency_matrix_ns::Edge<bool>>
+warshall_transitive_closure(
+    const Adjacency_matrix_ns::AdjacencyMatrix<
+        graph_type, V, Adjacency_matrix_ns::Edge<bool>>& g) {
+    auto closure = g;
+    closure.close_transitively();
+    return closure;
+}
+
 template <GraphType graph_type, typename V, typename E>
 void print_representation(
     const Adjacency_matrix_ns::AdjacencyMatrix<graph_type, V, E>& g,
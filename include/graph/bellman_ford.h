@@ -0,0 +1,261 @@
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+
+#include "array.h"
+#include "array_queue.h"
+#include "graph_common.h"
+#include "parallel.h"
+#include "vector.h"
+
+namespace Graph {
+
+/**
+ * Bellman-Ford engine over the vertices 0..count-1, for graphs given as an
+ * arc enumerator: arcs(v, relax) calls relax(w, weight, payload) for every
+ * arc v -> w. The payload of the arc entering every vertex of the shortest
+ * paths tree is kept in m_parent_arc.
+ *
+ * search() is the queue based variant (SPFA): a vertex is queued at most
+ * once, in a ring buffer of count slots. The tree is threaded in preorder
+ * with the depths of the vertices, so that when the distance of w drops its
+ * subtree is taken out of the tree (Tarjan's subtree disassembly): those
+ * vertices are skipped when dequeued, their distances being stale, and an
+ * arc v -> w with v in the subtree closes a negative cycle, found as soon as
+ * it is relaxed.
+ *
+ * search_parallel() relaxes the arcs of the whole frontier in rounds, the
+ * vertices being owned by threads as in DeltaStepping. The tree is then
+ * checked for a cycle after every power of two rounds, and after every
+ * round past count.
+ */
+template <typename W, typename P>
+class BellmanFord {
+   public:
+    static const constexpr size_t none = -1;
+
+    Array<W> m_distance;
+    Array<size_t> m_parent;
+    Array<P> m_parent_arc;
+
+   private:
+    const size_t m_count;
+    const W m_max_weight;
+    // the tree threaded in preorder from the root m_count, the parent of the
+    // sources; vertices out of the tree have the depth none
+    Array<size_t> m_next;
+    Array<size_t> m_prev;
+    Array<size_t> m_depth;
+    Array<bool> m_queued;
+    ArrayQueue<size_t> m_queue;
+    // a vertex of the negative cycle
+    size_t m_cycle;
+    std::unique_ptr<ThreadPool> m_pool;
+
+    struct Request {
+        size_t m_target;
+        size_t m_source;
+        W m_distance;
+        P m_payload;
+    };
+
+    void link(size_t v, size_t w) {
+        m_depth[w] = m_depth[v] + 1;
+        m_next[w] = m_next[v];
+        m_prev[w] = v;
+        m_prev[m_next[v]] = w;
+        m_next[v] = w;
+    }
+
+    // takes the subtree of w out of the tree, unless v is in it
+    bool unlink(size_t w, size_t v) {
+        if (w == v) return false;
+        auto depth = m_depth[w];
+        auto x = m_next[w];
+        for (; x != m_count && m_depth[x] > depth; x = m_next[x]) {
+            if (x == v) return false;
+            m_depth[x] = none;
+        }
+        m_depth[w] = none;
+        m_next[m_prev[w]] = x;
+        m_prev[x] = m_prev[w];
+        return true;
+    }
+
+    void enqueue(size_t v) {
+        if (m_queued[v]) return;
+        m_queued[v] = true;
+        m_queue.push(v);
+    }
+
+    // a vertex on a cycle of the parents, or none
+    size_t find_parents_cycle() const {
+        Array<size_t> walk(m_count, none);
+        for (size_t s = 0; s < m_count; ++s) {
+            auto v = s;
+            for (; walk[v] == none && m_parent[v] != none; v = m_parent[v])
+                walk[v] = s;
+            if (walk[v] == s) return v;
+        }
+        return none;
+    }
+
+   public:
+    BellmanFord(size_t count, W max_weight)
+        : m_distance(count),
+          m_parent(count),
+          m_parent_arc(count),
+          m_count(count),
+          m_max_weight(max_weight),
+          m_next(count + 1),
+          m_prev(count + 1),
+          m_depth(count + 1),
+          m_queued(count),
+          m_queue(count) {
+        reset();
+    }
+    BellmanFord(const BellmanFord&) = delete;
+    BellmanFord& operator=(const BellmanFord&) = delete;
+
+    void reset() {
+        m_distance.fill(m_max_weight);
+        m_parent.fill(none);
+        m_depth.fill(none);
+        m_queued.fill(false);
+        m_depth[m_count] = 0;
+        m_next[m_count] = m_prev[m_count] = m_count;
+        while (!m_queue.empty()) m_queue.pop();
+        m_cycle = none;
+    }
+
+    void add_source(size_t s, W distance = W()) {
+        m_distance[s] = distance;
+        link(m_count, s);
+        enqueue(s);
+    }
+
+    /**
+     * Returns false when a negative cycle is reachable from the sources.
+     */
+    template <typename A>
+    bool search(A arcs) {
+        while (!m_queue.empty()) {
+            auto v = m_queue.pop();
+            m_queued[v] = false;
+            if (m_depth[v] == none) continue;
+            bool cycle = false;
+            arcs(v, [&](size_t w, W weight, const P& payload) {
+                auto distance = m_distance[v] + weight;
+                if (cycle || !(distance < m_distance[w])) return;
+                if (m_depth[w] != none && !unlink(w, v)) cycle = true;
+                m_distance[w] = distance;
+                m_parent[w] = v;
+                m_parent_arc[w] = payload;
+                if (cycle) {
+                    m_cycle = w;
+                    return;
+                }
+                link(v, w);
+                enqueue(w);
+            });
+            if (cycle) return false;
+        }
+        return true;
+    }
+
+    /**
+     * As search(), but arcs is called concurrently and must not write. The
+     * threads are started on the first call and kept for the next ones.
+     */
+    template <typename A>
+    bool search_parallel(A arcs, size_t threads = hardware_threads()) {
+        threads = std::max<size_t>(1, threads);
+        if (!m_pool || m_pool->threads() != threads)
+            m_pool = std::make_unique<ThreadPool>(threads);
+        return search_parallel(arcs, *m_pool);
+    }
+    // on the threads of the caller's pool
+    template <typename A>
+    bool search_parallel(A arcs, ThreadPool& pool) {
+        auto count = pool.threads();
+        auto owner = [count](size_t v) { return v % count; };
+        Array<Vector<size_t>> frontiers(count);
+        Array<Array<Vector<Request>>> requests(count);
+        for (auto& r : requests) r = Array<Vector<Request>>(count);
+        Array<size_t> round_of(m_count, none);
+        while (!m_queue.empty()) {
+            auto v = m_queue.pop();
+            m_queued[v] = false;
+            frontiers[owner(v)].push_back(v);
+        }
+
+        for (size_t round = 1;; ++round) {
+            pool.blocks(count, [&](size_t sender, size_t, size_t) {
+                auto& outgoing = requests[sender];
+                for (auto& r : outgoing) r.clear();
+                for (auto v : frontiers[sender])
+                    arcs(v, [&](size_t w, W weight, const P& payload) {
+                        auto distance = m_distance[v] + weight;
+                        if (distance < m_distance[w])
+                            outgoing[owner(w)].push_back(
+                                Request{w, v, distance, payload});
+                    });
+            });
+            Array<char> found(count, false);
+            pool.blocks(count, [&](size_t t, size_t, size_t) {
+                auto& frontier = frontiers[t];
+                frontier.clear();
+                for (size_t sender = 0; sender < count; ++sender)
+                    for (auto& r : requests[sender][t]) {
+                        auto w = r.m_target;
+                        if (!(r.m_distance < m_distance[w])) continue;
+                        m_distance[w] = r.m_distance;
+                        m_parent[w] = r.m_source;
+                        m_parent_arc[w] = r.m_payload;
+                        if (round_of[w] == round) continue;
+                        round_of[w] = round;
+                        frontier.push_back(w);
+                    }
+                found[t] = !frontier.empty();
+            });
+            bool done = true;
+            for (size_t t = 0; t < count; ++t) done = done && !found[t];
+            if (done) return true;
+            if ((round & (round - 1)) == 0 || round > m_count) {
+                m_cycle = find_parents_cycle();
+                if (m_cycle != none) return false;
+            }
+        }
+    }
+
+    bool has_cycle() const { return m_cycle != none; }
+    size_t cycle_vertex() const { return m_cycle; }
+
+    /**
+     * The negative cycle found by the last search, along the arcs.
+     */
+    ArrayCycle negative_cycle() const {
+        if (m_cycle == none) return {{}, none};
+        Array<size_t> cycle(m_count, none);
+        for (auto w = m_cycle; cycle[m_parent[w]] == none; w = m_parent[w])
+            cycle[m_parent[w]] = w;
+        return {std::move(cycle), none};
+    }
+};
+
+/**
+ * The arcs of a graph for BellmanFord: its edges, whose entries are the
+ * payloads.
+ */
+template <typename G>
+auto edge_arcs(const G& g) {
+    return [&g](size_t v, auto relax) {
+        auto& vertex = g[v];
+        for (auto e = vertex.cedges_begin(); e != vertex.cedges_end(); ++e)
+            relax(size_t(e->target()), e->edge().weight(), *e);
+    };
+}
+
+}  // namespace Graph
@@ -0,0 +1,274 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "array.h"
+#include "graph_common.h"
+#include "parallel.h"
+
+namespace Graph {
+
+namespace Bfs_ns {
+
+/**
+ * Neighbour indices of every vertex in one flat array, the CSR rows without
+ * the edges.
+ */
+class AdjacencyIndex {
+   private:
+    Array<size_t> m_offsets;
+    Array<size_t> m_targets;
+
+   public:
+    AdjacencyIndex() : m_offsets(1, 0) {}
+
+    template <typename G>
+    static AdjacencyIndex out_edges(const G& g) {
+        AdjacencyIndex index;
+        index.m_offsets = Array<size_t>(g.vertices_count() + 1);
+        size_t p = 0;
+        for (auto v = g.cbegin(); v != g.cend(); ++v) {
+            index.m_offsets[*v] = p;
+            for (auto w = v->cbegin(); w != v->cend(); ++w) ++p;
+        }
+        index.m_offsets[g.vertices_count()] = p;
+        index.m_targets = Array<size_t>(p);
+        p = 0;
+        for (auto v = g.cbegin(); v != g.cend(); ++v)
+            for (auto w = v->cbegin(); w != v->cend(); ++w)
+                index.m_targets[p++] = *w;
+        return index;
+    }
+
+    /**
+     * Row v lists the sources of the edges entering v, in the order of the
+     * sources.
+     */
+    template <typename G>
+    static AdjacencyIndex in_edges(const G& g) {
+        AdjacencyIndex index;
+        auto count = g.vertices_count();
+        index.m_offsets = Array<size_t>(count + 1, 0);
+        for (auto v = g.cbegin(); v != g.cend(); ++v)
+            for (auto w = v->cbegin(); w != v->cend(); ++w)
+                ++index.m_offsets[size_t(*w) + 1];
+        for (size_t v = 0; v < count; ++v)
+            index.m_offsets[v + 1] += index.m_offsets[v];
+        index.m_targets = Array<size_t>(index.m_offsets[count]);
+        Array<size_t> next(count);
+        for (size_t v = 0; v < count; ++v) next[v] = index.m_offsets[v];
+        for (auto v = g.cbegin(); v != g.cend(); ++v)
+            for (auto w = v->cbegin(); w != v->cend(); ++w)
+                index.m_targets[next[*w]++] = *v;
+        return index;
+    }
+
+    size_t vertices_count() const { return m_offsets.size() - 1; }
+    size_t edges_count() const { return m_targets.size(); }
+    size_t degree(size_t v) const { return m_offsets[v + 1] - m_offsets[v]; }
+    const size_t* cbegin(size_t v) const {
+        return m_targets.cbegin() + m_offsets[v];
+    }
+    const size_t* cend(size_t v) const {
+        return m_targets.cbegin() + m_offsets[v + 1];
+    }
+};
+
+}  // namespace Bfs_ns
+
+/**
+ * Direction-optimizing BFS (Beamer et al.). A level is expanded top-down
+ * from the frontier list while the frontier is small, and bottom-up, every
+ * unvisited vertex looking for a parent in the frontier bitmap, once the
+ * frontier edges outweigh the unexplored ones. Both directions run on a
+ * thread pool. The graph is indexed once on construction, so one engine
+ * serves many searches.
+ */
+template <typename G>
+class ParallelBfs {
+   public:
+    enum class Direction { AUTOMATIC, TOP_DOWN, BOTTOM_UP };
+    static const constexpr size_t unreached = -1;
+
+    Array<size_t> m_distances;
+    Array<size_t> m_parents;
+
+   private:
+    using word_type = uint64_t;
+    using bitmap_type = Array<std::atomic<word_type>>;
+    static const constexpr size_t word_bits = 64;
+    static const constexpr size_t top_down_factor = 14;
+    static const constexpr size_t bottom_up_factor = 24;
+
+    Bfs_ns::AdjacencyIndex m_out;
+    Bfs_ns::AdjacencyIndex m_in;
+    ThreadPool m_pool;
+    Direction m_direction;
+    size_t m_bottom_up_levels;
+
+    bitmap_type m_visited;
+    bitmap_type m_frontier;
+    bitmap_type m_next;
+    Array<size_t> m_queue;
+    size_t m_queue_size;
+    Array<size_t> m_block_counts;
+
+    size_t words_count() const { return m_visited.size(); }
+    const Bfs_ns::AdjacencyIndex& in() const {
+        return is_undirected_v<G> ? m_out : m_in;
+    }
+    static void set(bitmap_type& bits, size_t v) {
+        bits[v / word_bits].fetch_or(word_type(1) << v % word_bits,
+                                     std::memory_order_relaxed);
+    }
+    static bool test(const bitmap_type& bits, size_t v) {
+        return bits[v / word_bits].load(std::memory_order_relaxed) >>
+                   v % word_bits &
+               1;
+    }
+
+    void reach(size_t v, size_t parent, size_t distance) {
+        m_parents[v] = parent;
+        m_distances[v] = distance;
+    }
+
+    void top_down(size_t level) {
+        m_pool.blocks(m_queue_size, [&](size_t, size_t b, size_t e) {
+            for (size_t i = b; i < e; ++i) {
+                auto v = m_queue[i];
+                for (auto w = m_out.cbegin(v); w != m_out.cend(v); ++w) {
+                    auto mask = word_type(1) << *w % word_bits;
+                    auto& word = m_visited[*w / word_bits];
+                    if (word.load(std::memory_order_relaxed) & mask ||
+                        word.fetch_or(mask, std::memory_order_relaxed) & mask)
+                        continue;
+                    reach(*w, v, level + 1);
+                    set(m_next, *w);
+                }
+            }
+        });
+    }
+
+    // blocks own whole words, so the visited and next words need no atomic
+    // read-modify-write here
+    void bottom_up(size_t level) {
+        auto& in = this->in();
+        auto count = m_distances.size();
+        m_pool.blocks(words_count(), [&](size_t, size_t b, size_t e) {
+            for (size_t i = b; i < e; ++i) {
+                auto visited = m_visited[i].load(std::memory_order_relaxed);
+                word_type next = 0;
+                for (auto v = i * word_bits;
+                     v < count && v < (i + 1) * word_bits; ++v) {
+                    auto mask = word_type(1) << v % word_bits;
+                    if (visited & mask) continue;
+                    for (auto u = in.cbegin(v); u != in.cend(v); ++u)
+                        if (test(m_frontier, *u)) {
+                            reach(v, *u, level + 1);
+                            next |= mask;
+                            break;
+                        }
+                }
+                m_visited[i].store(visited | next, std::memory_order_relaxed);
+                m_next[i].store(next, std::memory_order_relaxed);
+            }
+        });
+    }
+
+    /**
+     * Makes the next bitmap the frontier, listing it in m_queue, and returns
+     * the sum of the out degrees of the new frontier.
+     */
+    size_t advance() {
+        Array<size_t> degrees(m_pool.threads(), 0);
+        m_pool.blocks(words_count(), [&](size_t block, size_t b, size_t e) {
+            size_t count = 0;
+            for (size_t i = b; i < e; ++i) {
+                count += __builtin_popcountll(m_next[i]);
+                m_frontier[i].store(0, std::memory_order_relaxed);
+            }
+            m_block_counts[block] = count;
+        });
+        size_t blocks = std::min(m_pool.threads(), words_count());
+        Array<size_t> starts(blocks + 1);
+        starts[0] = 0;
+        for (size_t block = 0; block < blocks; ++block)
+            starts[block + 1] = starts[block] + m_block_counts[block];
+        m_queue_size = starts[blocks];
+        m_pool.blocks(words_count(), [&](size_t block, size_t b, size_t e) {
+            auto p = starts[block];
+            size_t degree = 0;
+            for (size_t i = b; i < e; ++i)
+                for (word_type bits = m_next[i]; bits; bits &= bits - 1) {
+                    auto v = i * word_bits + __builtin_ctzll(bits);
+                    m_queue[p++] = v;
+                    degree += m_out.degree(v);
+                }
+            degrees[block] = degree;
+        });
+        std::swap(m_frontier, m_next);
+        size_t degree = 0;
+        for (auto d : degrees) degree += d;
+        return degree;
+    }
+
+   public:
+    explicit ParallelBfs(const G& g, size_t threads = hardware_threads())
+        : m_distances(g.vertices_count()),
+          m_parents(g.vertices_count()),
+          m_out(Bfs_ns::AdjacencyIndex::out_edges(g)),
+          m_pool(threads),
+          m_direction(Direction::AUTOMATIC),
+          m_bottom_up_levels(0),
+          m_visited((g.vertices_count() + word_bits - 1) / word_bits),
+          m_frontier(m_visited.size()),
+          m_next(m_visited.size()),
+          m_queue(g.vertices_count()),
+          m_queue_size(0),
+          m_block_counts(m_pool.threads()) {
+        if (!is_undirected_v<G>) m_in = Bfs_ns::AdjacencyIndex::in_edges(g);
+    }
+
+    void set_direction(Direction direction) { m_direction = direction; }
+    size_t bottom_up_levels() const { return m_bottom_up_levels; }
+    bool is_reached(size_t v) const { return m_distances[v] != unreached; }
+
+    /**
+     * Fills m_distances and m_parents for the vertices reachable from the
+     * source; the source is its own parent.
+     */
+    void search(size_t source) {
+        auto count = m_distances.size();
+        m_pool.for_each(count,
+                        [&](size_t v) { reach(v, unreached, unreached); });
+        m_pool.for_each(words_count(), [&](size_t i) {
+            m_visited[i].store(0, std::memory_order_relaxed);
+            m_next[i].store(0, std::memory_order_relaxed);
+        });
+        m_bottom_up_levels = 0;
+        reach(source, source, 0);
+        set(m_visited, source);
+        set(m_next, source);
+        size_t frontier_edges = advance();
+        size_t unexplored_edges = m_out.edges_count() - frontier_edges;
+        bool upward = false;
+        for (size_t level = 0; m_queue_size; ++level) {
+            if (m_direction != Direction::AUTOMATIC)
+                upward = m_direction == Direction::BOTTOM_UP;
+            else if (!upward)
+                upward = frontier_edges > unexplored_edges / top_down_factor;
+            else
+                upward = m_queue_size >= count / bottom_up_factor;
+            if (upward) {
+                bottom_up(level);
+                ++m_bottom_up_levels;
+            } else
+                top_down(level);
+            frontier_edges = advance();
+            unexplored_edges -= std::min(unexplored_edges, frontier_edges);
+        }
+    }
+};
+
+}  // namespace Graph
@@ -0,0 +1,589 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <utility>
+
+#include "array.h"
+#include "array_stack.h"
+#include "bfs.h"
+#include "parallel.h"
+#include "vector.h"
+
+namespace Graph {
+
+namespace Biconnectivity_ns {
+
+static const constexpr size_t none = -1;
+
+/**
+ * The edges of an undirected graph numbered once, by their lower endpoint
+ * then in its adjacency order, with the edge of every arc. A self loop is
+ * one edge over its two arcs.
+ */
+class EdgeIndex {
+   private:
+    Bfs_ns::AdjacencyIndex m_arcs;
+    Array<size_t> m_arc_edges;
+    Array<size_t> m_sources;
+    Array<size_t> m_targets;
+
+   public:
+    template <typename G>
+    explicit EdgeIndex(const G& g)
+        : m_arcs(Bfs_ns::AdjacencyIndex::out_edges(g)),
+          m_arc_edges(m_arcs.edges_count(), none) {
+        auto count = m_arcs.vertices_count();
+        auto arc = [&](size_t v, size_t i) { return m_arcs.cbegin(v) + i; };
+        auto arc_index = [&](const size_t* w) {
+            return size_t(w - m_arcs.cbegin(0));
+        };
+        // the arcs to higher vertices and self loops make the edges
+        size_t edges = 0;
+        Array<size_t> higher(count + 1, 0);
+        for (size_t v = 0; v < count; ++v) {
+            bool open_loop = false;
+            for (auto w = m_arcs.cbegin(v); w != m_arcs.cend(v); ++w)
+                if (v < *w) {
+                    ++edges;
+                    ++higher[*w + 1];
+                } else if (v == *w) {
+                    edges += !open_loop;
+                    open_loop = !open_loop;
+                }
+        }
+        m_sources = Array<size_t>(edges);
+        m_targets = Array<size_t>(edges);
+        for (size_t v = 0; v < count; ++v) higher[v + 1] += higher[v];
+        // by higher endpoint, in the order of the lower ones
+        Array<size_t> by_higher(higher[count]);
+        size_t e = 0;
+        for (size_t v = 0; v < count; ++v) {
+            size_t loop = none;
+            for (auto w = m_arcs.cbegin(v); w != m_arcs.cend(v); ++w) {
+                if (v > *w) continue;
+                if (v == *w && loop != none) {
+                    m_arc_edges[arc_index(w)] = loop;
+                    loop = none;
+                    continue;
+                }
+                m_sources[e] = v;
+                m_targets[e] = *w;
+                m_arc_edges[arc_index(w)] = e;
+                if (v == *w)
+                    loop = e;
+                else
+                    by_higher[higher[*w]++] = e;
+                ++e;
+            }
+        }
+        // the arcs to lower vertices, sorted by target, take those edges;
+        // higher[v] now ends the bucket of v
+        Vector<size_t> lower;
+        for (size_t v = 0; v < count; ++v) {
+            lower.clear();
+            for (size_t i = 0; i < m_arcs.degree(v); ++i)
+                if (*arc(v, i) < v) lower.push_back(i);
+            std::stable_sort(lower.begin(), lower.end(),
+                             [&](size_t i, size_t j) {
+                                 return *arc(v, i) < *arc(v, j);
+                             });
+            auto begin = higher[v] - lower.size();
+            for (size_t i = 0; i < lower.size(); ++i)
+                m_arc_edges[arc_index(arc(v, lower[i]))] = by_higher[begin + i];
+        }
+    }
+
+    size_t vertices_count() const { return m_arcs.vertices_count(); }
+    size_t edges_count() const { return m_sources.size(); }
+    size_t source(size_t e) const { return m_sources[e]; }
+    size_t target(size_t e) const { return m_targets[e]; }
+    size_t other(size_t e, size_t v) const {
+        return m_sources[e] == v ? m_targets[e] : m_sources[e];
+    }
+
+    size_t arcs_begin(size_t v) const {
+        return m_arcs.cbegin(v) - m_arcs.cbegin(0);
+    }
+    size_t arcs_end(size_t v) const {
+        return m_arcs.cend(v) - m_arcs.cbegin(0);
+    }
+    size_t arc_target(size_t p) const { return *(m_arcs.cbegin(0) + p); }
+    size_t arc_edge(size_t p) const { return m_arc_edges[p]; }
+};
+
+/**
+ * Disjoint sets which threads unite concurrently: a root is only linked
+ * below a lower one, by compare and swap, and finds halve their paths, so
+ * parents never exceed their children.
+ */
+class ConcurrentUnionFind {
+   private:
+    Array<std::atomic<size_t>> m_parents;
+
+   public:
+    explicit ConcurrentUnionFind(size_t size) : m_parents(size) {
+        for (size_t i = 0; i < size; ++i) m_parents[i] = i;
+    }
+
+    size_t find(size_t i) {
+        for (;;) {
+            auto parent = m_parents[i].load();
+            if (parent == i) return i;
+            auto grandparent = m_parents[parent].load();
+            if (grandparent != parent)
+                m_parents[i].compare_exchange_weak(parent, grandparent);
+            i = grandparent;
+        }
+    }
+    // false when i and j are in the same set already
+    bool unite(size_t i, size_t j) {
+        for (;;) {
+            i = find(i);
+            j = find(j);
+            if (i == j) return false;
+            if (i < j) std::swap(i, j);
+            auto root = i;
+            if (m_parents[i].compare_exchange_strong(root, j)) return true;
+        }
+    }
+};
+
+/**
+ * Minima, or maxima, of the ranges of an array in O(1): the extrema of the
+ * prefixes and suffixes of its blocks, and a sparse table over the blocks,
+ * built in O(n) with a pool round per level.
+ */
+template <bool T_max>
+class RangeExtremum {
+   private:
+    static const constexpr size_t block = 64;
+
+    const Array<size_t>& m_values;
+    Array<size_t> m_prefixes;
+    Array<size_t> m_suffixes;
+    // level k holds the extrema of 2^k blocks from every block
+    Vector<Array<size_t>> m_levels;
+
+    static size_t pick(size_t a, size_t b) {
+        return T_max ? std::max(a, b) : std::min(a, b);
+    }
+
+   public:
+    RangeExtremum(ThreadPool& pool, const Array<size_t>& values)
+        : m_values(values),
+          m_prefixes(values.size()),
+          m_suffixes(values.size()) {
+        auto count = values.size();
+        auto blocks = (count + block - 1) / block;
+        Array<size_t> extrema(blocks);
+        pool.for_each(blocks, [&](size_t b) {
+            auto begin = b * block, end = std::min(count, begin + block);
+            m_prefixes[begin] = values[begin];
+            for (auto i = begin + 1; i < end; ++i)
+                m_prefixes[i] = pick(m_prefixes[i - 1], values[i]);
+            m_suffixes[end - 1] = values[end - 1];
+            for (auto i = end - 1; i-- > begin;)
+                m_suffixes[i] = pick(m_suffixes[i + 1], values[i]);
+            extrema[b] = m_prefixes[end - 1];
+        });
+        m_levels.push_back(std::move(extrema));
+        for (size_t width = 2; width <= blocks; width *= 2) {
+            auto& lower = m_levels[m_levels.size() - 1];
+            Array<size_t> level(blocks - width + 1);
+            pool.for_each(level.size(), [&](size_t b) {
+                level[b] = pick(lower[b], lower[b + width / 2]);
+            });
+            m_levels.push_back(std::move(level));
+        }
+    }
+
+    // over [begin, end), not empty
+    size_t get(size_t begin, size_t end) const {
+        auto last = end - 1;
+        auto first_block = begin / block, last_block = last / block;
+        if (first_block == last_block) {
+            auto e = m_values[begin];
+            for (auto i = begin + 1; i <= last; ++i) e = pick(e, m_values[i]);
+            return e;
+        }
+        auto e = pick(m_suffixes[begin], m_prefixes[last]);
+        auto between = last_block - first_block - 1;
+        if (between == 0) return e;
+        size_t k = 63 - __builtin_clzll(between);
+        auto& level = m_levels[k];
+        return pick(e, pick(level[first_block + 1],
+                            level[last_block - (size_t(1) << k)]));
+    }
+};
+
+/**
+ * The results of both engines: blocks numbered in the order of their first
+ * edge, self loops in no block, and the bridges and cut vertices in
+ * increasing order.
+ */
+class Blocks {
+   protected:
+    EdgeIndex m_index;
+
+   public:
+    Array<size_t> m_components;
+    size_t m_components_count;
+    Vector<size_t> m_bridges;
+    Vector<size_t> m_articulation_points;
+
+   protected:
+    template <typename G>
+    explicit Blocks(const G& g)
+        : m_index(g),
+          m_components(m_index.edges_count(), none),
+          m_components_count(0) {}
+
+    // labels are below labels_count, none for the self loops
+    void finish(const Array<size_t>& labels, size_t labels_count,
+                const Array<char>& bridges, const Array<char>& cuts) {
+        Array<size_t> ids(labels_count, none);
+        for (size_t e = 0; e < labels.size(); ++e) {
+            auto label = labels[e];
+            if (label == none) continue;
+            if (ids[label] == none) ids[label] = m_components_count++;
+            m_components[e] = ids[label];
+        }
+        for (size_t e = 0; e < bridges.size(); ++e)
+            if (bridges[e]) m_bridges.push_back(e);
+        for (size_t v = 0; v < cuts.size(); ++v)
+            if (cuts[v]) m_articulation_points.push_back(v);
+    }
+
+   public:
+    size_t edges_count() const { return m_index.edges_count(); }
+    size_t edge_source(size_t e) const { return m_index.source(e); }
+    size_t edge_target(size_t e) const { return m_index.target(e); }
+    // the edge of the i-th link of v
+    size_t edge(size_t v, size_t i) const {
+        return m_index.arc_edge(m_index.arcs_begin(v) + i);
+    }
+    size_t component(size_t e) const { return m_components[e]; }
+};
+
+}  // namespace Biconnectivity_ns
+
+/**
+ * Bridges, cut vertices and biconnected components of an undirected graph
+ * in one iterative depth-first search (Hopcroft and Tarjan): the edges are
+ * stacked as they are met, and a finished vertex whose subtree reaches no
+ * higher than its parent pops the block of its parent edge.
+ */
+template <typename G>
+class Biconnectivity : public Biconnectivity_ns::Blocks {
+   private:
+    using Base = Biconnectivity_ns::Blocks;
+    static const constexpr size_t none = Biconnectivity_ns::none;
+
+    struct Frame {
+        size_t m_v;
+        size_t m_parent_edge;
+        size_t m_arc;
+    };
+
+   public:
+    explicit Biconnectivity(const G& g) : Base(g) {
+        auto& index = m_index;
+        auto count = index.vertices_count();
+        Array<size_t> pre(count, none);
+        Array<size_t> low(count);
+        Array<size_t> labels(edges_count(), none);
+        Array<char> bridges(edges_count(), 0);
+        Array<char> cuts(count, 0);
+        ArrayStack<Frame> frames;
+        ArrayStack<size_t> edges;
+        size_t order = 0;
+        size_t label = 0;
+        auto enter = [&](size_t v, size_t parent_edge) {
+            pre[v] = low[v] = order++;
+            frames.push(Frame{v, parent_edge, index.arcs_begin(v)});
+        };
+
+        for (size_t root = 0; root < count; ++root) {
+            if (pre[root] != none) continue;
+            size_t root_children = 0;
+            enter(root, none);
+            while (!frames.empty()) {
+                auto& f = frames.top();
+                auto v = f.m_v;
+                if (f.m_arc != index.arcs_end(v)) {
+                    auto p = f.m_arc++;
+                    auto w = index.arc_target(p);
+                    auto e = index.arc_edge(p);
+                    if (e == f.m_parent_edge) continue;
+                    if (pre[w] == none) {
+                        edges.push(e);
+                        enter(w, e);
+                    } else if (pre[w] < pre[v]) {
+                        edges.push(e);
+                        low[v] = std::min(low[v], pre[w]);
+                    }
+                    continue;
+                }
+                auto parent_edge = f.m_parent_edge;
+                frames.pop();
+                if (parent_edge == none) continue;
+                auto u = index.other(parent_edge, v);
+                low[u] = std::min(low[u], low[v]);
+                if (low[v] < pre[u]) continue;
+                size_t e;
+                do {
+                    e = edges.pop();
+                    labels[e] = label;
+                } while (e != parent_edge);
+                ++label;
+                bridges[parent_edge] = low[v] > pre[u];
+                if (u != root || ++root_children > 1) cuts[u] = 1;
+            }
+        }
+        finish(labels, label, bridges, cuts);
+    }
+};
+
+/**
+ * The results of Biconnectivity in parallel, by Tarjan and Vishkin, in
+ * O(log V) pool rounds whatever the shape of the graph:
+ * - a spanning forest from the edges joining the trees of a concurrent
+ *   union-find,
+ * - the preorder numbers and subtree sizes of the forest from its Euler
+ *   tours, ranked by pointer jumping,
+ * - the lowest and highest preorder numbers the non-tree edges of every
+ *   subtree reach, as range minima and maxima over the preorder,
+ * - the blocks as the components of the tree edges, joined by the non-tree
+ *   edges between unrelated vertices and by the tree edges whose child
+ *   subtree reaches out of the parent's.
+ * Every edge is named by its deeper endpoint, the child of a tree edge.
+ */
+template <typename G>
+class ParallelBiconnectivity : public Biconnectivity_ns::Blocks {
+   private:
+    using Base = Biconnectivity_ns::Blocks;
+    static const constexpr size_t none = Biconnectivity_ns::none;
+
+    // the trees of the forest, rooted at the roots of m_trees
+    Biconnectivity_ns::ConcurrentUnionFind m_trees;
+    Array<char> m_tree;
+    Array<size_t> m_roots;
+    // the tree arcs of every vertex in [m_arcs_begin[v], m_arcs_begin[v + 1])
+    Array<size_t> m_arcs_begin;
+    Array<size_t> m_arc_source;
+    Array<size_t> m_arc_target;
+    Array<size_t> m_twin;
+    // by vertex
+    Array<size_t> m_pre;
+    Array<size_t> m_size;
+    Array<size_t> m_parent;
+    Array<size_t> m_low;
+    Array<size_t> m_high;
+
+    bool is_descendant(size_t w, size_t v) const {
+        return m_pre[v] <= m_pre[w] && m_pre[w] < m_pre[v] + m_size[v];
+    }
+
+    void span(ThreadPool& pool) {
+        auto& index = m_index;
+        pool.for_each(edges_count(), [&](size_t e) {
+            auto v = index.source(e), w = index.target(e);
+            m_tree[e] = v != w && m_trees.unite(v, w);
+        });
+        pool.for_each(m_roots.size(),
+                      [&](size_t v) { m_roots[v] = m_trees.find(v); });
+    }
+
+    void index_tree_arcs(ThreadPool& pool) {
+        auto& index = m_index;
+        auto count = index.vertices_count();
+        auto is_tree_arc = [&](size_t p) {
+            return m_tree[index.arc_edge(p)] != 0;
+        };
+        pool.for_each(count, [&](size_t v) {
+            size_t degree = 0;
+            for (auto p = index.arcs_begin(v); p != index.arcs_end(v); ++p)
+                degree += is_tree_arc(p);
+            m_arcs_begin[v + 1] = degree;
+        });
+        for (size_t v = 0; v < count; ++v)
+            m_arcs_begin[v + 1] += m_arcs_begin[v];
+        auto arcs = m_arcs_begin[count];
+        m_arc_source = Array<size_t>(arcs);
+        m_arc_target = Array<size_t>(arcs);
+        m_twin = Array<size_t>(arcs);
+        // the tree arcs of every edge, from its source then its target
+        Array<size_t> ends(2 * edges_count());
+        Array<size_t> arc_edges(arcs);
+        pool.for_each(count, [&](size_t v) {
+            auto a = m_arcs_begin[v];
+            for (auto p = index.arcs_begin(v); p != index.arcs_end(v); ++p) {
+                if (!is_tree_arc(p)) continue;
+                auto e = index.arc_edge(p);
+                m_arc_source[a] = v;
+                m_arc_target[a] = index.arc_target(p);
+                arc_edges[a] = e;
+                ends[2 * e + (index.source(e) != v)] = a++;
+            }
+        });
+        pool.for_each(arcs, [&](size_t a) {
+            auto e = arc_edges[a];
+            m_twin[a] = ends[2 * e + (index.source(e) == m_arc_source[a])];
+        });
+    }
+
+    // sums[a] becomes the sum of the weights from a to the end of its list
+    static void suffix_sums(ThreadPool& pool, Array<size_t> next,
+                            Array<size_t>& sums) {
+        auto count = next.size();
+        Array<size_t> next_next(count);
+        Array<size_t> next_sums(count);
+        for (size_t span = 1; span < count; span *= 2) {
+            pool.for_each(count, [&](size_t a) {
+                auto b = next[a];
+                next_sums[a] = b == none ? sums[a] : sums[a] + sums[b];
+                next_next[a] = b == none ? none : next[b];
+            });
+            std::swap(next, next_next);
+            std::swap(sums, next_sums);
+        }
+    }
+
+    void number(ThreadPool& pool) {
+        auto count = m_pre.size();
+        auto arcs = m_arc_source.size();
+        auto degree = [this](size_t v) {
+            return m_arcs_begin[v + 1] - m_arcs_begin[v];
+        };
+        // the Euler tours, cut where they return to their roots last
+        Array<size_t> next(arcs);
+        pool.for_each(arcs, [&](size_t a) {
+            auto w = m_arc_target[a];
+            auto i = m_twin[a] - m_arcs_begin[w] + 1;
+            next[a] = i == degree(w)
+                          ? (m_roots[w] == w ? none : m_arcs_begin[w])
+                          : m_arcs_begin[w] + i;
+        });
+        Array<size_t> remaining(arcs, 1);
+        suffix_sums(pool, next, remaining);
+        // an arc is down the tree when the tour takes it before its twin
+        Array<size_t> down(arcs);
+        pool.for_each(arcs, [&](size_t a) {
+            down[a] = remaining[a] > remaining[m_twin[a]];
+        });
+        suffix_sums(pool, std::move(next), down);
+
+        pool.for_each(count, [&](size_t v) {
+            if (m_roots[v] != v) return;
+            m_size[v] = degree(v) ? remaining[m_arcs_begin[v]] / 2 + 1 : 1;
+        });
+        Array<size_t> base(count);
+        for (size_t v = 0, pre = 0; v < count; ++v)
+            if (m_roots[v] == v) {
+                base[v] = pre;
+                m_pre[v] = pre;
+                pre += m_size[v];
+            }
+        // down[a] now counts the down arcs from a on
+        pool.for_each(arcs, [&](size_t a) {
+            auto v = m_arc_target[a];
+            auto twin = m_twin[a];
+            if (remaining[a] < remaining[twin]) return;
+            auto root = m_roots[v];
+            m_parent[v] = m_arc_source[a];
+            m_pre[v] = base[root] + m_size[root] - down[a];
+            m_size[v] = down[a] - down[twin];
+        });
+    }
+
+    void reach(ThreadPool& pool) {
+        auto& index = m_index;
+        auto count = m_pre.size();
+        // by preorder number, the ends of the non-tree edges of the vertex
+        Array<size_t> lowest(count);
+        Array<size_t> highest(count);
+        pool.for_each(count, [&](size_t v) {
+            auto low = m_pre[v], high = m_pre[v];
+            for (auto p = index.arcs_begin(v); p != index.arcs_end(v); ++p) {
+                if (m_tree[index.arc_edge(p)]) continue;
+                auto pre = m_pre[index.arc_target(p)];
+                low = std::min(low, pre);
+                high = std::max(high, pre);
+            }
+            lowest[m_pre[v]] = low;
+            highest[m_pre[v]] = high;
+        });
+        Biconnectivity_ns::RangeExtremum<false> minima(pool, lowest);
+        Biconnectivity_ns::RangeExtremum<true> maxima(pool, highest);
+        pool.for_each(count, [&](size_t v) {
+            auto end = m_pre[v] + m_size[v];
+            m_low[v] = minima.get(m_pre[v], end);
+            m_high[v] = maxima.get(m_pre[v], end);
+        });
+    }
+
+   public:
+    explicit ParallelBiconnectivity(const G& g,
+                                    size_t threads = hardware_threads())
+        : Base(g),
+          m_trees(m_index.vertices_count()),
+          m_tree(edges_count(), 0),
+          m_roots(m_index.vertices_count()),
+          m_arcs_begin(m_index.vertices_count() + 1, 0),
+          m_pre(m_index.vertices_count()),
+          m_size(m_index.vertices_count()),
+          m_parent(m_index.vertices_count(), none),
+          m_low(m_index.vertices_count()),
+          m_high(m_index.vertices_count()) {
+        auto& index = m_index;
+        auto count = index.vertices_count();
+        ThreadPool pool(threads);
+        span(pool);
+        index_tree_arcs(pool);
+        number(pool);
+        reach(pool);
+
+        Biconnectivity_ns::ConcurrentUnionFind blocks(count);
+        pool.for_each(edges_count(), [&](size_t e) {
+            auto v = index.source(e), w = index.target(e);
+            if (m_tree[e] || v == w) return;
+            if (!is_descendant(v, w) && !is_descendant(w, v))
+                blocks.unite(v, w);
+        });
+        pool.for_each(count, [&](size_t w) {
+            auto v = m_parent[w];
+            if (v == none || m_parent[v] == none) return;
+            if (m_low[w] < m_pre[v] || m_high[w] >= m_pre[v] + m_size[v])
+                blocks.unite(w, v);
+        });
+
+        Array<size_t> labels(edges_count());
+        Array<char> bridges(edges_count());
+        pool.for_each(edges_count(), [&](size_t e) {
+            auto v = index.source(e), w = index.target(e);
+            auto child = m_pre[v] > m_pre[w] ? v : w;
+            labels[e] = v == w ? none : blocks.find(child);
+            bridges[e] = m_tree[e] && m_low[child] == m_pre[child] &&
+                         m_high[child] < m_pre[child] + m_size[child];
+        });
+        // a cut vertex has edges in two blocks
+        Array<char> cuts(count);
+        pool.for_each(count, [&](size_t v) {
+            auto label = none;
+            cuts[v] = 0;
+            for (auto p = index.arcs_begin(v); p != index.arcs_end(v); ++p) {
+                auto l = labels[index.arc_edge(p)];
+                if (l == none) continue;
+                if (label == none) label = l;
+                if (l != label) {
+                    cuts[v] = 1;
+                    return;
+                }
+            }
+        });
+        finish(labels, count, bridges, cuts);
+    }
+};
+
+}  // namespace Graph
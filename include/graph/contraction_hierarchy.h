@@ -0,0 +1,762 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include "array.h"
+#include "array_stack.h"
+#include "graph_common.h"
+#include "parallel.h"
+#include "small_vector.h"
+#include "vector.h"
+#include "vertex_heaps.h"
+
+namespace Graph {
+
+class ContractionHierarchyException : public std::runtime_error {
+   public:
+    explicit ContractionHierarchyException(const std::string& message)
+        : std::runtime_error("contraction hierarchy: " + message) {}
+};
+
+namespace Contraction_ns {
+
+static const constexpr size_t no_middle = -1;
+
+/**
+ * Arc of a hierarchy. A shortcut stands for the two arcs through its middle
+ * vertex, which is contracted before both ends.
+ */
+template <typename W>
+struct Arc {
+    size_t m_vertex;
+    W m_weight;
+    size_t m_middle;
+};
+
+template <typename W>
+using Arcs = SmallVector<Arc<W>, 4>;
+
+template <typename W>
+struct Shortcut {
+    size_t m_source;
+    Arc<W> m_arc;
+};
+
+// keeps the lighter of two parallel arcs
+template <typename W>
+void add_arc(Arcs<W>& arcs, const Arc<W>& arc) {
+    for (auto a = arcs.begin(); a != arcs.end(); ++a)
+        if (a->m_vertex == arc.m_vertex) {
+            if (arc.m_weight < a->m_weight) *a = arc;
+            return;
+        }
+    arcs.push_back(arc);
+}
+
+/**
+ * Bounded Dijkstra looking for witnesses, paths which make a shortcut
+ * unnecessary.
+ */
+template <typename W>
+class WitnessSearch {
+   private:
+    Array<size_t> m_ids;
+    Array<W> m_distance;
+    Array<uint32_t> m_reached;
+    uint32_t m_version;
+    QuaternaryVertexHeap<const size_t*, W> m_heap;
+
+    void reach(size_t v, W distance) {
+        bool queued = is_reached(v);
+        m_reached[v] = m_version;
+        m_distance[v] = distance;
+        if (queued)
+            m_heap.move_up(&m_ids[v]);
+        else
+            m_heap.push(&m_ids[v]);
+    }
+
+   public:
+    explicit WitnessSearch(size_t count)
+        : m_ids(count),
+          m_distance(count),
+          m_reached(count, 0),
+          m_version(0),
+          m_heap(count, m_distance) {
+        for (size_t i = 0; i < count; ++i) m_ids[i] = i;
+    }
+    WitnessSearch(const WitnessSearch&) = delete;
+    WitnessSearch& operator=(const WitnessSearch&) = delete;
+
+    bool is_reached(size_t v) const { return m_reached[v] == m_version; }
+    W distance(size_t v) const { return m_distance[v]; }
+
+    /**
+     * Searches from the source through the vertices accepted by passable,
+     * up to the limit distance and at most settle_limit settled vertices.
+     */
+    template <typename F>
+    void search(const Array<Arcs<W>>& out, size_t source, W limit,
+                size_t settle_limit, F passable) {
+        if (++m_version == 0) {
+            m_reached.fill(0);
+            m_version = 1;
+        }
+        m_heap.clear();
+        reach(source, 0);
+        for (size_t settled = 0; !m_heap.empty() && settled < settle_limit;
+             ++settled) {
+            size_t v = *m_heap.pop();
+            if (limit < m_distance[v]) break;
+            auto& arcs = out[v];
+            for (auto a = arcs.cbegin(); a != arcs.cend(); ++a) {
+                auto w = a->m_vertex;
+                auto distance = m_distance[v] + a->m_weight;
+                if (!passable(w) || limit < distance) continue;
+                if (!is_reached(w) || distance < m_distance[w])
+                    reach(w, distance);
+            }
+        }
+    }
+};
+
+/**
+ * Contracts the vertices of a graph in rounds. Every round takes the
+ * remaining vertices whose priority is below that of all their neighbors,
+ * an independent set, finds their shortcuts in parallel and removes them.
+ * The priority weighs the shortcuts a contraction adds against the arcs it
+ * removes, plus the count of neighbors already contracted, which spreads
+ * the contraction evenly over the graph.
+ */
+template <typename W>
+class Contractor {
+   public:
+    Array<size_t> m_rank;
+    // the arcs between every vertex and the vertices contracted after it:
+    // leaving the vertex in m_up, entering it in m_down
+    Array<Arcs<W>> m_up;
+    Array<Arcs<W>> m_down;
+
+   private:
+    enum State : unsigned char { REMAINING, CONTRACTING, CONTRACTED };
+    // witness searches give up after this many vertices, adding a shortcut
+    // which may be superfluous; the priorities are estimated with shorter
+    // searches
+    static const constexpr size_t settle_limit = 100;
+    static const constexpr size_t estimate_settle_limit = 30;
+
+    ThreadPool m_pool;
+    Array<Arcs<W>> m_out;
+    Array<Arcs<W>> m_in;
+    Array<unsigned char> m_state;
+    Array<unsigned char> m_selected;
+    Array<long> m_priority;
+    Array<long> m_contracted_neighbors;
+    Array<size_t> m_touched;
+    // per thread
+    Array<std::unique_ptr<WitnessSearch<W>>> m_searches;
+    Array<Vector<Shortcut<W>>> m_shortcuts;
+
+    // calls f(u, arc) for the shortcuts replacing v; witnesses only pass
+    // through remaining vertices, so the shortcuts of a whole set being
+    // contracted do not rely on each other
+    template <typename F>
+    void find_shortcuts(size_t v, WitnessSearch<W>& search, size_t limit,
+                        F f) const {
+        auto& in = m_in[v];
+        auto& out = m_out[v];
+        auto passable = [&](size_t w) {
+            return w != v && m_state[w] == REMAINING;
+        };
+        for (auto a = in.cbegin(); a != in.cend(); ++a) {
+            auto u = a->m_vertex;
+            W longest = 0;
+            bool found = false;
+            for (auto b = out.cbegin(); b != out.cend(); ++b)
+                if (b->m_vertex != u) {
+                    longest = std::max(longest, a->m_weight + b->m_weight);
+                    found = true;
+                }
+            if (!found) continue;
+            search.search(m_out, u, longest, limit, passable);
+            for (auto b = out.cbegin(); b != out.cend(); ++b) {
+                auto w = b->m_vertex;
+                auto weight = a->m_weight + b->m_weight;
+                if (w == u ||
+                    (search.is_reached(w) && !(weight < search.distance(w))))
+                    continue;
+                f(u, Arc<W>{w, weight, v});
+            }
+        }
+    }
+
+    void update_priorities(const Vector<size_t>& vertices) {
+        m_pool.blocks(vertices.size(), [&](size_t t, size_t b, size_t e) {
+            for (auto i = b; i < e; ++i) {
+                auto v = vertices[i];
+                long shortcuts = 0;
+                find_shortcuts(v, *m_searches[t], estimate_settle_limit,
+                               [&](size_t, const Arc<W>&) { ++shortcuts; });
+                m_priority[v] = 2 * shortcuts -
+                                long(m_in[v].size() + m_out[v].size()) +
+                                m_contracted_neighbors[v];
+            }
+        });
+    }
+
+    bool precedes(size_t v, size_t w) const {
+        return m_priority[v] < m_priority[w] ||
+               (m_priority[v] == m_priority[w] && v < w);
+    }
+    bool is_local_minimum(size_t v) const {
+        for (auto* arcs : {&m_out[v], &m_in[v]})
+            for (auto a = arcs->cbegin(); a != arcs->cend(); ++a)
+                if (precedes(a->m_vertex, v)) return false;
+        return true;
+    }
+
+    void remove(size_t v, size_t rank) {
+        m_rank[v] = rank;
+        m_state[v] = CONTRACTED;
+        m_up[v] = std::move(m_out[v]);
+        m_down[v] = std::move(m_in[v]);
+        auto is_v = [v](const Arc<W>& a) { return a.m_vertex == v; };
+        for (auto a = m_up[v].begin(); a != m_up[v].end(); ++a) {
+            m_in[a->m_vertex].remove_if(is_v);
+            ++m_contracted_neighbors[a->m_vertex];
+        }
+        for (auto a = m_down[v].begin(); a != m_down[v].end(); ++a) {
+            m_out[a->m_vertex].remove_if(is_v);
+            ++m_contracted_neighbors[a->m_vertex];
+        }
+    }
+
+    void contract(Vector<size_t> remaining) {
+        Vector<size_t> selected;
+        Vector<size_t> rest;
+        Vector<size_t> neighbors;
+        for (size_t rank = 0, round = 0; !remaining.empty(); ++round) {
+            m_pool.for_each(remaining.size(), [&](size_t i) {
+                m_selected[remaining[i]] = is_local_minimum(remaining[i]);
+            });
+            selected.clear();
+            rest.clear();
+            for (auto v : remaining)
+                if (m_selected[v]) {
+                    m_state[v] = CONTRACTING;
+                    selected.push_back(v);
+                } else {
+                    rest.push_back(v);
+                }
+
+            for (auto& shortcuts : m_shortcuts) shortcuts.clear();
+            m_pool.blocks(selected.size(), [&](size_t t, size_t b, size_t e) {
+                auto add = [&](size_t u, const Arc<W>& arc) {
+                    m_shortcuts[t].push_back(Shortcut<W>{u, arc});
+                };
+                for (auto i = b; i < e; ++i)
+                    find_shortcuts(selected[i], *m_searches[t], settle_limit,
+                                   add);
+            });
+            for (auto v : selected) remove(v, rank++);
+            for (auto& shortcuts : m_shortcuts)
+                for (auto& s : shortcuts) {
+                    add_arc(m_out[s.m_source], s.m_arc);
+                    add_arc(m_in[s.m_arc.m_vertex],
+                            {s.m_source, s.m_arc.m_weight, s.m_arc.m_middle});
+                }
+
+            neighbors.clear();
+            for (auto v : selected)
+                for (auto* arcs : {&m_up[v], &m_down[v]})
+                    for (auto a = arcs->begin(); a != arcs->end(); ++a)
+                        if (m_touched[a->m_vertex] != round) {
+                            m_touched[a->m_vertex] = round;
+                            neighbors.push_back(a->m_vertex);
+                        }
+            update_priorities(neighbors);
+            std::swap(remaining, rest);
+        }
+    }
+
+   public:
+    template <typename G>
+    Contractor(const G& g, size_t threads)
+        : m_rank(g.vertices_count()),
+          m_up(g.vertices_count()),
+          m_down(g.vertices_count()),
+          m_pool(threads),
+          m_out(g.vertices_count()),
+          m_in(g.vertices_count()),
+          m_state(g.vertices_count(), REMAINING),
+          m_selected(g.vertices_count(), 0),
+          m_priority(g.vertices_count()),
+          m_contracted_neighbors(g.vertices_count(), 0),
+          m_touched(g.vertices_count(), size_t(-1)),
+          m_searches(m_pool.threads()),
+          m_shortcuts(m_pool.threads()) {
+        auto count = g.vertices_count();
+        for (auto v = g.cbegin(); v != g.cend(); ++v)
+            for (auto e = v->cedges_begin(); e != v->cedges_end(); ++e) {
+                size_t w = e->target();
+                if (w == *v) continue;
+                auto weight = e->edge().weight();
+                add_arc(m_out[*v], {w, weight, no_middle});
+                add_arc(m_in[w], {*v, weight, no_middle});
+            }
+        for (auto& search : m_searches)
+            search.reset(new WitnessSearch<W>(count));
+        Vector<size_t> remaining;
+        for (size_t v = 0; v < count; ++v) remaining.push_back(v);
+        update_priorities(remaining);
+        contract(std::move(remaining));
+    }
+};
+
+struct Header {
+    static const constexpr char magic_value[8] = {'G', 'R', 'A', 'P',
+                                                  'H', 'C', 'H', '_'};
+    static const constexpr uint32_t current_version = 2;
+
+    char m_magic[8];
+    uint32_t m_version;
+    uint32_t m_weight_size;
+    uint64_t m_vertices_count;
+    uint64_t m_up_count;
+    uint64_t m_down_count;
+};
+
+template <typename T>
+void write_array(std::ostream& out, const Array<T>& a) {
+    out.write(reinterpret_cast<const char*>(a.cbegin()), a.size() * sizeof(T));
+}
+
+template <typename T>
+Array<T> read_array(std::istream& in, size_t count) {
+    Array<T> a(count);
+    in.read(reinterpret_cast<char*>(a.begin()), count * sizeof(T));
+    if (!in) throw ContractionHierarchyException("truncated input");
+    return a;
+}
+
+/**
+ * Arcs are written field by field, the vertex and the middle as 64-bit
+ * words then the weight, so no padding of Arc reaches the file.
+ */
+template <typename W>
+static const constexpr size_t arc_record_size =
+    2 * sizeof(uint64_t) + sizeof(W);
+
+template <typename W>
+void write_arcs(std::ostream& out, const Array<Arc<W>>& arcs) {
+    Array<char> records(arcs.size() * arc_record_size<W>);
+    auto p = records.begin();
+    for (auto a = arcs.cbegin(); a != arcs.cend(); ++a) {
+        uint64_t fields[] = {a->m_vertex, a->m_middle};
+        std::memcpy(p, fields, sizeof(fields));
+        std::memcpy(p + sizeof(fields), &a->m_weight, sizeof(W));
+        p += arc_record_size<W>;
+    }
+    out.write(records.cbegin(), records.size());
+}
+
+template <typename W>
+Array<Arc<W>> read_arcs(std::istream& in, size_t count) {
+    auto records = read_array<char>(in, count * arc_record_size<W>);
+    Array<Arc<W>> arcs(count);
+    auto p = records.cbegin();
+    for (auto& a : arcs) {
+        uint64_t fields[2];
+        std::memcpy(fields, p, sizeof(fields));
+        a.m_vertex = fields[0];
+        a.m_middle = fields[1];
+        std::memcpy(&a.m_weight, p + sizeof(fields), sizeof(W));
+        p += arc_record_size<W>;
+    }
+    return arcs;
+}
+
+// the arc in [b, e) to or from v, or nullptr
+template <typename W>
+const Arc<W>* find_arc(const Arc<W>* b, const Arc<W>* e, size_t v) {
+    for (; b != e; ++b)
+        if (b->m_vertex == v) return b;
+    return nullptr;
+}
+
+}  // namespace Contraction_ns
+
+/**
+ * Contraction hierarchy of a weighted digraph, for repeated shortest path
+ * queries with ChQuery. Every vertex has a rank, its position in the
+ * contraction order, and the hierarchy keeps only the arcs leading to
+ * higher ranks: those leaving every vertex (up) and those entering it
+ * (down), original edges and shortcuts alike. Loops are dropped and of
+ * parallel edges only the lightest is kept.
+ */
+template <typename W>
+class ContractionHierarchy {
+   public:
+    using Arc = Contraction_ns::Arc<W>;
+
+   private:
+    Array<size_t> m_rank;
+    Array<size_t> m_up_offsets;
+    Array<Arc> m_up;
+    Array<size_t> m_down_offsets;
+    Array<Arc> m_down;
+
+    static void flatten(Array<Contraction_ns::Arcs<W>>& lists,
+                        Array<size_t>& offsets, Array<Arc>& arcs) {
+        offsets = Array<size_t>(lists.size() + 1);
+        offsets[0] = 0;
+        for (size_t v = 0; v < lists.size(); ++v)
+            offsets[v + 1] = offsets[v] + lists[v].size();
+        arcs = Array<Arc>(offsets[lists.size()]);
+        for (size_t v = 0; v < lists.size(); ++v)
+            std::copy(lists[v].begin(), lists[v].end(),
+                      arcs.begin() + offsets[v]);
+    }
+
+   public:
+    ContractionHierarchy() : m_up_offsets(1, 0), m_down_offsets(1, 0) {}
+
+    /**
+     * Contracts g, which needs non-negative weights, finding the shortcuts
+     * of independent vertices on the given number of threads.
+     */
+    template <typename G>
+    explicit ContractionHierarchy(const G& g,
+                                  size_t threads = hardware_threads()) {
+        Contraction_ns::Contractor<W> contractor(g, threads);
+        m_rank = std::move(contractor.m_rank);
+        flatten(contractor.m_up, m_up_offsets, m_up);
+        flatten(contractor.m_down, m_down_offsets, m_down);
+    }
+
+    size_t vertices_count() const { return m_rank.size(); }
+    size_t arcs_count() const { return m_up.size() + m_down.size(); }
+    size_t rank(size_t v) const { return m_rank[v]; }
+
+    const Arc* up_begin(size_t v) const {
+        return m_up.cbegin() + m_up_offsets[v];
+    }
+    const Arc* up_end(size_t v) const {
+        return m_up.cbegin() + m_up_offsets[v + 1];
+    }
+    const Arc* down_begin(size_t v) const {
+        return m_down.cbegin() + m_down_offsets[v];
+    }
+    const Arc* down_end(size_t v) const {
+        return m_down.cbegin() + m_down_offsets[v + 1];
+    }
+
+    /**
+     * Writes the hierarchy behind a header checked by load(): the ranks and
+     * offsets as in memory, the arcs field by field.
+     */
+    void save(std::ostream& out) const {
+        static_assert(std::is_trivially_copyable_v<W>,
+                      "saved weights must be trivially copyable");
+        using Contraction_ns::Header;
+        Header h;
+        std::memcpy(h.m_magic, Header::magic_value, sizeof(h.m_magic));
+        h.m_version = Header::current_version;
+        h.m_weight_size = sizeof(W);
+        h.m_vertices_count = vertices_count();
+        h.m_up_count = m_up.size();
+        h.m_down_count = m_down.size();
+        out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+        Contraction_ns::write_array(out, m_rank);
+        Contraction_ns::write_array(out, m_up_offsets);
+        Contraction_ns::write_arcs(out, m_up);
+        Contraction_ns::write_array(out, m_down_offsets);
+        Contraction_ns::write_arcs(out, m_down);
+        if (!out) throw ContractionHierarchyException("write failed");
+    }
+
+    /**
+     * Reads a hierarchy written by save(). Throws
+     * ContractionHierarchyException unless the ranks are a permutation,
+     * every arc leads to a higher rank and every shortcut unpacks through
+     * a middle vertex ranked below both its ends.
+     */
+    static ContractionHierarchy load(std::istream& in) {
+        using namespace Contraction_ns;
+        Header h;
+        in.read(reinterpret_cast<char*>(&h), sizeof(h));
+        if (!in || std::memcmp(h.m_magic, Header::magic_value,
+                               sizeof(h.m_magic)) != 0)
+            throw ContractionHierarchyException("not a hierarchy");
+        if (h.m_version != Header::current_version)
+            throw ContractionHierarchyException(
+                "unsupported version " + std::to_string(h.m_version));
+        if (h.m_weight_size != sizeof(W))
+            throw ContractionHierarchyException("weight size mismatch");
+        size_t n = h.m_vertices_count;
+        ContractionHierarchy ch;
+        ch.m_rank = read_array<size_t>(in, n);
+        ch.m_up_offsets = read_array<size_t>(in, n + 1);
+        ch.m_up = read_arcs<W>(in, h.m_up_count);
+        ch.m_down_offsets = read_array<size_t>(in, n + 1);
+        ch.m_down = read_arcs<W>(in, h.m_down_count);
+        for (auto* offsets : {&ch.m_up_offsets, &ch.m_down_offsets})
+            for (size_t v = 0; v < n; ++v)
+                if ((*offsets)[v + 1] < (*offsets)[v])
+                    throw ContractionHierarchyException("corrupt offsets");
+        if (ch.m_up_offsets[n] != h.m_up_count ||
+            ch.m_down_offsets[n] != h.m_down_count)
+            throw ContractionHierarchyException("corrupt offsets");
+        Array<char> ranked(n, false);
+        for (auto r : ch.m_rank) {
+            if (r >= n || ranked[r])
+                throw ContractionHierarchyException("corrupt ranks");
+            ranked[r] = true;
+        }
+        for (auto* arcs : {&ch.m_up, &ch.m_down})
+            for (auto& a : *arcs)
+                if (a.m_vertex >= n ||
+                    (a.m_middle != no_middle && a.m_middle >= n))
+                    throw ContractionHierarchyException("corrupt arc");
+        // a shortcut v -> w unpacks through the arcs v -> c and c -> w of
+        // its middle vertex c, ranked below both ends: every arc leads to a
+        // higher rank, so unpacking ends
+        auto& rank = ch.m_rank;
+        auto unpacks = [&ch, &rank](size_t v, size_t w, size_t c) {
+            return c == no_middle ||
+                   (rank[c] < rank[v] && rank[c] < rank[w] &&
+                    find_arc(ch.down_begin(c), ch.down_end(c), v) &&
+                    find_arc(ch.up_begin(c), ch.up_end(c), w));
+        };
+        for (size_t v = 0; v < n; ++v) {
+            for (auto a = ch.up_begin(v); a != ch.up_end(v); ++a) {
+                if (rank[a->m_vertex] <= rank[v])
+                    throw ContractionHierarchyException("corrupt arc");
+                if (!unpacks(v, a->m_vertex, a->m_middle))
+                    throw ContractionHierarchyException("corrupt shortcut");
+            }
+            for (auto a = ch.down_begin(v); a != ch.down_end(v); ++a) {
+                if (rank[a->m_vertex] <= rank[v])
+                    throw ContractionHierarchyException("corrupt arc");
+                if (!unpacks(a->m_vertex, v, a->m_middle))
+                    throw ContractionHierarchyException("corrupt shortcut");
+            }
+        }
+        return ch;
+    }
+};
+
+template <typename G>
+ContractionHierarchy(const G&)
+    -> ContractionHierarchy<typename G::edge_type::value_type>;
+template <typename G>
+ContractionHierarchy(const G&, size_t)
+    -> ContractionHierarchy<typename G::edge_type::value_type>;
+
+/**
+ * Shortest path queries over a contraction hierarchy: Dijkstra upward from
+ * the source and, over the reversed arcs, upward from the target. A side
+ * stops once its queue holds nothing shorter than the best path through a
+ * vertex reached from both. As in PointToPoint the scratch arrays are
+ * versioned and a query is not shared between threads.
+ */
+template <typename W>
+class ChQuery {
+   private:
+    using Arc = Contraction_ns::Arc<W>;
+    static const constexpr size_t none = -1;
+
+    struct Search {
+        Array<W> m_distance;
+        // the vertex before on the way up, and the arc between them
+        Array<size_t> m_parent;
+        Array<const Arc*> m_arc;
+        Array<uint32_t> m_reached;
+        Array<uint32_t> m_settled;
+        QuaternaryVertexHeap<const size_t*, W> m_heap;
+        bool m_done;
+
+        explicit Search(size_t count)
+            : m_distance(count),
+              m_parent(count),
+              m_arc(count),
+              m_reached(count, 0),
+              m_settled(count, 0),
+              m_heap(count, m_distance),
+              m_done(false) {}
+        Search(const Search&) = delete;
+        Search& operator=(const Search&) = delete;
+    };
+
+    struct Step {
+        size_t m_from;
+        size_t m_to;
+        size_t m_middle;
+    };
+
+    const ContractionHierarchy<W>& m_ch;
+    Array<size_t> m_ids;
+    Search m_forward;
+    Search m_backward;
+    uint32_t m_version;
+
+    size_t m_source;
+    size_t m_target;
+    size_t m_meeting;
+    W m_distance;
+    size_t m_settled_count;
+
+    bool is_reached(const Search& s, size_t v) const {
+        return s.m_reached[v] == m_version;
+    }
+    bool is_settled(const Search& s, size_t v) const {
+        return s.m_settled[v] == m_version;
+    }
+    bool is_active(const Search& s) const {
+        return !s.m_done && !s.m_heap.empty();
+    }
+
+    void reach(Search& s, size_t v, W distance) {
+        bool queued = is_reached(s, v);
+        s.m_reached[v] = m_version;
+        s.m_distance[v] = distance;
+        if (queued)
+            s.m_heap.move_up(&m_ids[v]);
+        else
+            s.m_heap.push(&m_ids[v]);
+    }
+    void meet(size_t v) {
+        auto distance = m_forward.m_distance[v] + m_backward.m_distance[v];
+        if (m_meeting == none || distance < m_distance) {
+            m_meeting = v;
+            m_distance = distance;
+        }
+    }
+
+    void expand(Search& s, const Search& other, const Arc* (
+                    ContractionHierarchy<W>::*begin)(size_t) const,
+                const Arc* (ContractionHierarchy<W>::*end)(size_t) const) {
+        size_t v = *s.m_heap.pop();
+        s.m_settled[v] = m_version;
+        ++m_settled_count;
+        if (m_meeting != none && !(s.m_distance[v] < m_distance)) {
+            s.m_done = true;
+            return;
+        }
+        for (auto a = (m_ch.*begin)(v); a != (m_ch.*end)(v); ++a) {
+            auto w = a->m_vertex;
+            auto distance = s.m_distance[v] + a->m_weight;
+            if (is_settled(s, w) ||
+                (is_reached(s, w) && !(distance < s.m_distance[w])))
+                continue;
+            reach(s, w, distance);
+            s.m_parent[w] = v;
+            s.m_arc[w] = a;
+            if (is_reached(other, w)) meet(w);
+        }
+    }
+
+   public:
+    explicit ChQuery(const ContractionHierarchy<W>& ch)
+        : m_ch(ch),
+          m_ids(ch.vertices_count()),
+          m_forward(ch.vertices_count()),
+          m_backward(ch.vertices_count()),
+          m_version(0),
+          m_source(none),
+          m_target(none),
+          m_meeting(none),
+          m_distance(0),
+          m_settled_count(0) {
+        for (size_t i = 0; i < m_ids.size(); ++i) m_ids[i] = i;
+    }
+
+    /**
+     * Returns whether the target is reachable from the source.
+     */
+    bool search(size_t source, size_t target) {
+        if (++m_version == 0) {
+            for (auto* s : {&m_forward, &m_backward}) {
+                s->m_reached.fill(0);
+                s->m_settled.fill(0);
+            }
+            m_version = 1;
+        }
+        for (auto* s : {&m_forward, &m_backward}) {
+            s->m_heap.clear();
+            s->m_done = false;
+        }
+        m_source = source;
+        m_target = target;
+        m_meeting = none;
+        m_settled_count = 0;
+        if (source == target) {
+            m_meeting = source;
+            m_distance = 0;
+            return true;
+        }
+        reach(m_forward, source, 0);
+        reach(m_backward, target, 0);
+        using CH = ContractionHierarchy<W>;
+        while (is_active(m_forward) || is_active(m_backward)) {
+            if (is_active(m_forward) &&
+                (!is_active(m_backward) ||
+                 m_forward.m_heap.size() <= m_backward.m_heap.size()))
+                expand(m_forward, m_backward, &CH::up_begin, &CH::up_end);
+            else
+                expand(m_backward, m_forward, &CH::down_begin, &CH::down_end);
+        }
+        return m_meeting != none;
+    }
+
+    W distance() const { return m_distance; }
+    size_t settled_count() const { return m_settled_count; }
+
+    /**
+     * The vertices of the last path found, from the source to the target,
+     * with the shortcuts unpacked; empty when a shortcut does not unpack.
+     */
+    Vector<size_t> path() const {
+        Vector<size_t> path;
+        if (m_meeting == none) return path;
+        // the steps of the path, the first on top
+        ArrayStack<Step> steps;
+        Vector<Step> backward;
+        for (auto v = m_meeting; v != m_target; v = m_backward.m_parent[v])
+            backward.push_back(Step{v, m_backward.m_parent[v],
+                                    m_backward.m_arc[v]->m_middle});
+        for (auto i = backward.size(); i-- > 0;) steps.push(backward[i]);
+        for (auto v = m_meeting; v != m_source; v = m_forward.m_parent[v])
+            steps.push(Step{m_forward.m_parent[v], v,
+                            m_forward.m_arc[v]->m_middle});
+
+        path.push_back(m_source);
+        while (!steps.empty()) {
+            auto step = steps.pop();
+            auto c = step.m_middle;
+            if (c == Contraction_ns::no_middle) {
+                path.push_back(step.m_to);
+                continue;
+            }
+            // the arcs of the middle vertex to both ends, checked by load()
+            auto first = Contraction_ns::find_arc(
+                m_ch.down_begin(c), m_ch.down_end(c), step.m_from);
+            auto second = Contraction_ns::find_arc(m_ch.up_begin(c),
+                                                   m_ch.up_end(c), step.m_to);
+            if (!first || !second) return Vector<size_t>();
+            steps.push(Step{c, step.m_to, second->m_middle});
+            steps.push(Step{step.m_from, c, first->m_middle});
+        }
+        return path;
+    }
+};
+
+}  // namespace Graph
@@ -0,0 +1,484 @@
+#pragma once
+
+#include <algorithm>
+#include <iostream>
+
+#include "adjacency_lists.h"
+#include "array.h"
+#include "graph_common.h"
+
+namespace Graph {
+
+namespace Csr_ns {
+
+template <typename E>
+struct EdgeListItem {
+    size_t m_source;
+    size_t m_target;
+    E m_edge;
+};
+
+template <typename E, typename ET = typename E::value_type>
+struct EdgeFreezer {
+    template <typename EE>
+    static E freeze(const EE& e) {
+        return E(e.edge().weight());
+    }
+};
+
+template <typename E>
+struct EdgeFreezer<E, bool> {
+    template <typename EE>
+    static E freeze(const EE&) {
+        return E(true);
+    }
+};
+
+/**
+ * Turns per-bucket counts into bucket begin offsets in place.
+ */
+template <typename A>
+void accumulate_counts(A& counts) {
+    size_t sum = 0;
+    for (auto& c : counts) {
+        auto count = c;
+        c = sum;
+        sum += count;
+    }
+}
+
+/**
+ * Array which either owns its elements or is a read-only view of memory
+ * owned elsewhere, e.g. a mapped graph file. Copying a view makes an owning
+ * copy, and so do the non-const accessors, which a MappedCsr never offers.
+ */
+template <typename T>
+class CsrArray {
+   private:
+    Array<T> m_owned;
+    const T* m_ptr;
+    size_t m_size;
+
+    T* data() {
+        if (m_ptr != m_owned.cbegin()) *this = CsrArray(*this);
+        return m_owned.begin();
+    }
+
+   public:
+    CsrArray() : m_ptr(nullptr), m_size(0) {}
+    explicit CsrArray(size_t size)
+        : m_owned(size), m_ptr(m_owned.cbegin()), m_size(size) {}
+    CsrArray(size_t size, const T& t)
+        : m_owned(size, t), m_ptr(m_owned.cbegin()), m_size(size) {}
+    CsrArray(const T* ptr, size_t size) : m_ptr(ptr), m_size(size) {}
+
+    CsrArray(const CsrArray& o) : CsrArray(o.m_size) {
+        std::copy_n(o.m_ptr, m_size, m_owned.begin());
+    }
+    CsrArray& operator=(const CsrArray& o) {
+        auto copy = o;
+        std::swap(*this, copy);
+        return *this;
+    }
+    CsrArray(CsrArray&& o) : CsrArray() { *this = std::move(o); }
+    CsrArray& operator=(CsrArray&& o) {
+        std::swap(m_owned, o.m_owned);
+        std::swap(m_ptr, o.m_ptr);
+        std::swap(m_size, o.m_size);
+        return *this;
+    }
+
+    size_t size() const { return m_size; }
+    T& operator[](size_t index) { return data()[index]; }
+    const T& operator[](size_t index) const { return m_ptr[index]; }
+    void fill(const T& t) { std::fill_n(data(), m_size, t); }
+
+    T* begin() { return data(); }
+    T* end() { return data() + m_size; }
+    const T* cbegin() const { return m_ptr; }
+    const T* cend() const { return m_ptr + m_size; }
+};
+
+template <GraphType TT_graph_type, typename VV>
+class CsrBase;
+
+template <GraphType T_graph_type, typename VT, typename E, typename D>
+class CsrVertexBase : public VertexBase<VT> {
+   private:
+    template <bool T_is_const>
+    class Iterator;
+    template <bool T_is_const>
+    class Edges_iterator;
+    template <GraphType TT_graph_type, typename VV>
+    friend class CsrBase;
+
+    inline D* derived() { return static_cast<D*>(this); }
+    inline const D* derived() const { return static_cast<const D*>(this); }
+
+   protected:
+    using csr_type = CsrBase<T_graph_type, D>;
+    csr_type* m_csr;
+
+    CsrVertexBase() : m_csr(nullptr) {}
+
+    const csr_type* csr() const { return m_csr; }
+    size_t first() const { return csr()->m_offsets[index()]; }
+    size_t last() const { return csr()->m_offsets[index() + 1]; }
+
+   public:
+    using edge_type = E;
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+    using edges_iterator = Edges_iterator<false>;
+    using const_edges_iterator = Edges_iterator<true>;
+
+    inline size_t index() const {
+        return derived() - m_csr->m_vertices.cbegin();
+    }
+    inline operator size_t() const { return index(); }
+    size_t degree() const { return last() - first(); }
+
+    iterator begin() { return {derived(), first()}; }
+    iterator end() { return {derived(), last()}; }
+    const_iterator cbegin() const { return {derived(), first()}; }
+    const_iterator cend() const { return {derived(), last()}; }
+
+    edges_iterator edges_begin() { return {derived(), first()}; }
+    edges_iterator edges_end() { return {derived(), last()}; }
+    const_edges_iterator cedges_begin() const { return {derived(), first()}; }
+    const_edges_iterator cedges_end() const { return {derived(), last()}; }
+
+    bool has_edge(const CsrVertexBase& v) const {
+        return m_csr->find_edge(index(), v.index()) != last();
+    }
+    const E* get_edge(size_t v) const {
+        auto p = m_csr->find_edge(index(), v);
+        return p != last() ? &csr()->m_edges[p] : nullptr;
+    }
+    E* get_edge(size_t v) {
+        auto p = m_csr->find_edge(index(), v);
+        return p != last() ? &m_csr->m_edges[p] : nullptr;
+    }
+};
+
+template <GraphType T_graph_type, typename VT, typename E>
+class Vertex
+    : public CsrVertexBase<T_graph_type, VT, E, Vertex<T_graph_type, VT, E>> {
+   private:
+    template <GraphType TT_graph_type, typename VV>
+    friend class CsrBase;
+    friend class Array<Vertex>;
+
+    Vertex() = default;
+    Vertex(const Vertex&) = default;
+    Vertex& operator=(const Vertex&) = default;
+    Vertex(Vertex&&) = default;
+    Vertex& operator=(Vertex&&) = default;
+
+   public:
+    using edge_type = E;
+};
+
+/**
+ * Compressed sparse row storage: the edges of vertex v occupy positions
+ * [m_offsets[v], m_offsets[v + 1]) of m_targets and m_edges, in the order
+ * they were added to the source graph.
+ */
+template <GraphType T_graph_type, typename V>
+class CsrBase {
+   public:
+    using vertex_type = V;
+    using edge_type = typename V::edge_type;
+
+   protected:
+    Array<vertex_type> m_vertices;
+    CsrArray<size_t> m_offsets;
+    CsrArray<size_t> m_targets;
+    CsrArray<edge_type> m_edges;
+
+    template <GraphType TT_graph_type, typename VV, typename EE, typename D>
+    friend class CsrVertexBase;
+
+    void update_vertices_this_link() {
+        for (auto& v : m_vertices) v.m_csr = this;
+    }
+    size_t find_edge(size_t v, size_t w) const {
+        auto p = m_offsets[v];
+        for (; p != m_offsets[v + 1] && m_targets[p] != w; ++p)
+            ;
+        return p;
+    }
+    void allocate(size_t vertices_count, size_t edges_count) {
+        m_vertices = Array<vertex_type>(vertices_count);
+        m_offsets = CsrArray<size_t>(vertices_count + 1);
+        m_targets = CsrArray<size_t>(edges_count);
+        m_edges = CsrArray<edge_type>(edges_count);
+        update_vertices_this_link();
+    }
+    template <typename G>
+    void copy_values(const G& g) {
+        for (auto v = g.cbegin(); v != g.cend(); ++v)
+            m_vertices[*v].set_value(v->value());
+    }
+
+   public:
+    CsrBase() : m_offsets(1, 0) {}
+
+    CsrBase(const CsrBase& o)
+        : m_vertices(o.m_vertices),
+          m_offsets(o.m_offsets),
+          m_targets(o.m_targets),
+          m_edges(o.m_edges) {
+        update_vertices_this_link();
+    }
+    CsrBase& operator=(const CsrBase& o) {
+        auto copy = o;
+        std::swap(*this, copy);
+        return *this;
+    }
+    CsrBase(CsrBase&& o)
+        : m_vertices(std::move(o.m_vertices)),
+          m_offsets(std::move(o.m_offsets)),
+          m_targets(std::move(o.m_targets)),
+          m_edges(std::move(o.m_edges)) {
+        update_vertices_this_link();
+    }
+    CsrBase& operator=(CsrBase&& o) {
+        std::swap(m_vertices, o.m_vertices);
+        std::swap(m_offsets, o.m_offsets);
+        std::swap(m_targets, o.m_targets);
+        std::swap(m_edges, o.m_edges);
+        update_vertices_this_link();
+        o.update_vertices_this_link();
+        return *this;
+    }
+
+    size_t vertices_count() const { return m_vertices.size(); }
+    size_t edges_count() const { return m_targets.size(); }
+
+    const vertex_type& operator[](size_t index) const {
+        return m_vertices[index];
+    }
+    vertex_type& operator[](size_t index) { return m_vertices[index]; }
+
+    bool has_edge(const vertex_type& v, const vertex_type& w) const {
+        return v.has_edge(w);
+    }
+    edge_type* get_edge(size_t v, size_t w) {
+        return m_vertices[v].get_edge(w);
+    }
+    const edge_type* get_edge(const vertex_type& v,
+                              const vertex_type& w) const {
+        return v.get_edge(w);
+    }
+    edge_type* get_edge(vertex_type& v, const vertex_type& w) {
+        return v.get_edge(w);
+    }
+
+    auto cbegin() const { return m_vertices.cbegin(); }
+    auto cend() const { return m_vertices.cend(); }
+    auto begin() { return m_vertices.begin(); }
+    auto end() { return m_vertices.end(); }
+
+    auto crbegin() const { return m_vertices.crbegin(); }
+    auto crend() const { return m_vertices.crend(); }
+};
+
+template <GraphType T_graph_type, typename V>
+class Csr : public CsrBase<T_graph_type, V> {
+   private:
+    using Base = CsrBase<T_graph_type, V>;
+
+   public:
+    using vertex_type = typename Base::vertex_type;
+    using edge_type = typename Base::edge_type;
+    using value_type = typename vertex_type::value_type;
+    using edge_list_item_type = EdgeListItem<edge_type>;
+
+    Csr() = default;
+    // owns a copy of the storage of a Csr or of a mapped graph
+    explicit Csr(const Base& base) : Base(base) {}
+
+    /**
+     * Freezes any graph exposing the vertex and edge iterators surface,
+     * keeping the vertex indices and the order of every adjacency list.
+     */
+    template <typename G>
+    explicit Csr(const G& g) {
+        size_t edges_count = 0;
+        for (auto v = g.cbegin(); v != g.cend(); ++v)
+            for (auto e = v->cedges_begin(); e != v->cedges_end(); ++e)
+                ++edges_count;
+        Base::allocate(g.vertices_count(), edges_count);
+        Base::copy_values(g);
+        size_t p = 0;
+        for (auto v = g.cbegin(); v != g.cend(); ++v) {
+            Base::m_offsets[*v] = p;
+            for (auto e = v->cedges_begin(); e != v->cedges_end(); ++e, ++p) {
+                Base::m_targets[p] = e->target();
+                Base::m_edges[p] = EdgeFreezer<edge_type>::freeze(*e);
+            }
+        }
+        Base::m_offsets[g.vertices_count()] = p;
+    }
+
+    /**
+     * Builds the graph straight from an edge list with a counting sort: one
+     * pass counts the degrees, the second one fills the rows. Undirected
+     * edges are stored in both directions.
+     */
+    template <typename It>
+    Csr(const Array<value_type>& values, const It& edges_b, const It& edges_e) {
+        constexpr bool undirected = T_graph_type == GraphType::GRAPH;
+        size_t edges_count = 0;
+        for (auto e = edges_b; e != edges_e; ++e)
+            edges_count += undirected ? 2 : 1;
+        Base::allocate(values.size(), edges_count);
+        for (size_t v = 0; v < values.size(); ++v)
+            Base::m_vertices[v].set_value(values[v]);
+
+        Base::m_offsets.fill(0);
+        for (auto e = edges_b; e != edges_e; ++e) {
+            ++Base::m_offsets[e->m_source];
+            if (undirected) ++Base::m_offsets[e->m_target];
+        }
+        accumulate_counts(Base::m_offsets);
+        Array<size_t> cursors(values.size());
+        for (size_t v = 0; v < values.size(); ++v)
+            cursors[v] = Base::m_offsets[v];
+        auto put = [this, &cursors](size_t v, size_t w, const edge_type& e) {
+            auto p = cursors[v]++;
+            Base::m_targets[p] = w;
+            Base::m_edges[p] = e;
+        };
+        for (auto e = edges_b; e != edges_e; ++e) {
+            put(e->m_source, e->m_target, e->m_edge);
+            if (undirected) put(e->m_target, e->m_source, e->m_edge);
+        }
+    }
+
+    /**
+     * Reversed copy built with one counting sort pass over the rows, so the
+     * in-edges of every vertex are ordered by their sources, the same way
+     * Inverter orders them.
+     */
+    Csr inverted() const {
+        if (T_graph_type == GraphType::GRAPH) return *this;
+        Csr r;
+        auto count = Base::vertices_count();
+        r.allocate(count, Base::edges_count());
+        for (size_t v = 0; v < count; ++v)
+            r.m_vertices[v].set_value(Base::m_vertices[v].value());
+        r.m_offsets.fill(0);
+        for (auto w = Base::m_targets.cbegin(); w != Base::m_targets.cend();
+             ++w)
+            ++r.m_offsets[*w];
+        accumulate_counts(r.m_offsets);
+        Array<size_t> cursors(count);
+        for (size_t v = 0; v < count; ++v) cursors[v] = r.m_offsets[v];
+        for (size_t v = 0; v < count; ++v)
+            for (auto p = Base::m_offsets[v]; p != Base::m_offsets[v + 1];
+                 ++p) {
+                auto q = cursors[Base::m_targets[p]]++;
+                r.m_targets[q] = v;
+                r.m_edges[q] = Base::m_edges[p];
+            }
+        return r;
+    }
+};
+
+template <GraphType T_graph_type, typename V>
+Csr<T_graph_type, V> invert(const Csr<T_graph_type, V>& g) {
+    return g.inverted();
+}
+
+template <GraphType T_graph_type, typename VT, typename E, typename D>
+template <bool T_is_const>
+class CsrVertexBase<T_graph_type, VT, E, D>::Iterator {
+   protected:
+    using value_type = std::conditional_t<T_is_const, const D, D>;
+    value_type* m_vertex;
+    size_t m_position;
+
+   private:
+    friend CsrVertexBase;
+
+   public:
+    Iterator(value_type* vertex, size_t position)
+        : m_vertex(vertex), m_position(position) {}
+    const Iterator& operator++() {
+        ++m_position;
+        return *this;
+    }
+    bool operator==(const Iterator& o) const {
+        return m_position == o.m_position;
+    }
+    bool operator!=(const Iterator& o) const { return !operator==(o); }
+    value_type* operator->() const { return &operator*(); }
+    value_type& operator*() const {
+        auto csr = m_vertex->m_csr;
+        return csr->m_vertices[m_vertex->csr()->m_targets[m_position]];
+    }
+};
+
+template <GraphType T_graph_type, typename VT, typename E, typename D>
+template <bool T_is_const>
+class CsrVertexBase<T_graph_type, VT, E, D>::Edges_iterator
+    : public Iterator<T_is_const> {
+   private:
+    using Base = Iterator<T_is_const>;
+
+   public:
+    using entry_type = EdgesIteratorEntry<D, E, T_is_const>;
+
+   private:
+    using vertex_base_type = typename Base::value_type;
+
+    entry_type m_entry;
+
+    void update_entry() {
+        auto csr = Base::m_vertex->m_csr;
+        auto const_csr = Base::m_vertex->csr();
+        if (Base::m_position != csr->m_targets.size()) {
+            m_entry.m_target =
+                &csr->m_vertices[const_csr->m_targets[Base::m_position]];
+            if constexpr (T_is_const)
+                m_entry.m_edge = &const_csr->m_edges[Base::m_position];
+            else
+                m_entry.m_edge = &csr->m_edges[Base::m_position];
+        }
+    }
+
+   public:
+    Edges_iterator(vertex_base_type* vertex, size_t position)
+        : Base(vertex, position), m_entry(vertex) {
+        update_entry();
+    }
+    const entry_type& operator*() const { return m_entry; }
+    const entry_type* operator->() const { return &m_entry; }
+    Edges_iterator& operator++() {
+        Base::operator++();
+        update_entry();
+        return *this;
+    }
+};
+
+template <GraphType T_graph_type, typename V>
+void print_representation(const Csr<T_graph_type, V>& g,
+                          std::ostream& stream) {
+    for (auto v = g.cbegin(); v != g.cend(); ++v) {
+        stream << *v << ":";
+        for (auto w = v->cbegin(); w != v->cend(); ++w)
+            stream << " " << w->index();
+        stream << std::endl;
+    }
+}
+
+}  // namespace Csr_ns
+
+template <GraphType T_graph_type, typename V, typename TE = bool,
+          typename E = Adjacency_lists_ns::Edge<TE>>
+using Csr = Csr_ns::Csr<T_graph_type, Csr_ns::Vertex<T_graph_type, V, E>>;
+
+}  // namespace Graph
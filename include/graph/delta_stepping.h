@@ -0,0 +1,270 @@
+#pragma once
+
+#include <algorithm>
+#include <memory>
+
+#include "array.h"
+#include "graph_common.h"
+#include "parallel.h"
+#include "vector.h"
+
+namespace Graph {
+
+/**
+ * Delta-stepping single source shortest paths (Meyer and Sanders). search(s)
+ * gives the results of Spt: m_distance, max_weight for the unreached
+ * vertices, and m_spt, the edge entering every reached vertex but the
+ * source.
+ *
+ * Tentative distances are kept in buckets of width delta. The vertices of
+ * the lowest bucket relax their light edges (weight <= delta) until the
+ * bucket stays empty, then their heavy edges once. Every vertex is owned by
+ * one thread: relaxations are sent as requests to the owner of the target,
+ * so the distances and buckets are written without atomics.
+ *
+ * The edge index and the threads are set up once and kept across searches;
+ * the pool may be the caller's.
+ */
+template <typename G>
+class DeltaSteppingEngine {
+   public:
+    using vertex_t = typename G::vertex_type;
+    using edge_t = typename G::vertex_type::const_edges_iterator::entry_type;
+    using weight_t = typename G::edge_type::value_type;
+
+    Array<weight_t> m_distance;
+    Array<edge_t> m_spt;
+
+   private:
+    static const constexpr size_t none = -1;
+
+    struct Request {
+        size_t m_target;
+        weight_t m_distance;
+        size_t m_edge;
+    };
+
+    weight_t m_delta;
+    std::unique_ptr<ThreadPool> m_own_pool;
+    ThreadPool& m_pool;
+    // edges by source: the light ones in [m_offsets[v], m_splits[v])
+    Array<size_t> m_offsets;
+    Array<size_t> m_splits;
+    Array<size_t> m_targets;
+    Array<weight_t> m_weights;
+    Array<edge_t> m_edges;
+    // tentative distances span less than this many buckets
+    size_t m_span;
+
+    Array<size_t> m_bucket;
+    // marks the vertices of m_settled, so each relaxes its heavy edges once
+    Array<char> m_is_settled;
+    // per owner: cyclic buckets, frontier and settled vertices
+    Array<Array<Vector<size_t>>> m_buckets;
+    Array<Vector<size_t>> m_frontiers;
+    Array<Vector<size_t>> m_settled;
+    // per sender and owner
+    Array<Array<Vector<Request>>> m_requests;
+
+    size_t threads() const { return m_pool.threads(); }
+    size_t owner(size_t v) const { return v % threads(); }
+    size_t bucket_index(weight_t distance) const {
+        return size_t(distance / m_delta);
+    }
+
+    void index_edges(const G& g) {
+        size_t count = g.vertices_count();
+        m_offsets = Array<size_t>(count + 1);
+        m_splits = Array<size_t>(count);
+        size_t p = 0;
+        for (auto v = g.cbegin(); v != g.cend(); ++v) {
+            m_offsets[*v] = p;
+            for (auto e = v->cedges_begin(); e != v->cedges_end(); ++e) ++p;
+        }
+        m_offsets[count] = p;
+        m_targets = Array<size_t>(p);
+        m_weights = Array<weight_t>(p);
+        m_edges = Array<edge_t>(p);
+        for (auto v = g.cbegin(); v != g.cend(); ++v) {
+            size_t light = m_offsets[*v];
+            size_t heavy = m_offsets[size_t(*v) + 1];
+            for (auto e = v->cedges_begin(); e != v->cedges_end(); ++e) {
+                auto weight = e->edge().weight();
+                auto i = weight <= m_delta ? light++ : --heavy;
+                m_targets[i] = e->target();
+                m_weights[i] = weight;
+                m_edges[i] = *e;
+            }
+            m_splits[*v] = light;
+        }
+    }
+
+    void setup(const G& g) {
+        index_edges(g);
+        weight_t heaviest = 0;
+        for (auto w : m_weights) heaviest = std::max(heaviest, w);
+        m_span = bucket_index(heaviest) + 2;
+        m_bucket = Array<size_t>(g.vertices_count(), none);
+        m_is_settled = Array<char>(g.vertices_count(), false);
+        m_buckets = Array<Array<Vector<size_t>>>(threads());
+        m_frontiers = Array<Vector<size_t>>(threads());
+        m_settled = Array<Vector<size_t>>(threads());
+        m_requests = Array<Array<Vector<Request>>>(threads());
+        for (size_t t = 0; t < threads(); ++t) {
+            m_buckets[t] = Array<Vector<size_t>>(m_span);
+            m_requests[t] = Array<Vector<Request>>(threads());
+        }
+    }
+
+    template <typename F>
+    void relax(F edges) {
+        m_pool.blocks(threads(), [&](size_t sender, size_t, size_t) {
+            auto& requests = m_requests[sender];
+            for (auto& r : requests) r.clear();
+            edges(sender, [&](size_t v, size_t b, size_t e) {
+                for (auto i = b; i < e; ++i) {
+                    auto w = m_targets[i];
+                    requests[owner(w)].push_back(
+                        Request{w, m_distance[v] + m_weights[i], i});
+                }
+            });
+        });
+        m_pool.blocks(threads(), [&](size_t t, size_t, size_t) {
+            auto& buckets = m_buckets[t];
+            for (size_t sender = 0; sender < threads(); ++sender)
+                for (auto& r : m_requests[sender][t]) {
+                    if (!(r.m_distance < m_distance[r.m_target])) continue;
+                    m_distance[r.m_target] = r.m_distance;
+                    m_spt[r.m_target] = m_edges[r.m_edge];
+                    auto b = bucket_index(r.m_distance);
+                    if (m_bucket[r.m_target] == b) continue;
+                    m_bucket[r.m_target] = b;
+                    buckets[b % buckets.size()].push_back(r.m_target);
+                }
+        });
+    }
+
+    // moves the vertices still in the bucket to the frontiers
+    bool take_bucket(size_t b) {
+        Array<char> found(threads(), false);
+        m_pool.blocks(threads(), [&](size_t t, size_t, size_t) {
+            auto& slot = m_buckets[t][b % m_buckets[t].size()];
+            auto& frontier = m_frontiers[t];
+            frontier.clear();
+            for (auto v : slot)
+                if (m_bucket[v] == b) {
+                    m_bucket[v] = none;
+                    frontier.push_back(v);
+                    if (!m_is_settled[v]) {
+                        m_is_settled[v] = true;
+                        m_settled[t].push_back(v);
+                    }
+                }
+            slot.clear();
+            found[t] = !frontier.empty();
+        });
+        for (size_t t = 0; t < threads(); ++t)
+            if (found[t]) return true;
+        return false;
+    }
+
+    bool is_bucket_empty(size_t b) const {
+        for (size_t t = 0; t < threads(); ++t)
+            if (!m_buckets[t][b % m_buckets[t].size()].empty()) return false;
+        return true;
+    }
+
+    static weight_t default_delta(const G& g) {
+        weight_t max_weight = 0;
+        size_t edges_count = 0;
+        for (auto v = g.cbegin(); v != g.cend(); ++v)
+            for (auto e = v->cedges_begin(); e != v->cedges_end(); ++e) {
+                max_weight = std::max(max_weight, e->edge().weight());
+                ++edges_count;
+            }
+        auto degree = std::max<size_t>(
+            1, edges_count / std::max<size_t>(1, g.vertices_count()));
+        weight_t delta = max_weight / weight_t(degree);
+        return delta > 0 ? delta : weight_t(1);
+    }
+
+   public:
+    /**
+     * A delta of 0 picks the heaviest edge weight divided by the average
+     * degree.
+     */
+    DeltaSteppingEngine(const G& g, ThreadPool& pool, weight_t delta = 0)
+        : m_delta(delta > 0 ? delta : default_delta(g)), m_pool(pool) {
+        setup(g);
+    }
+    explicit DeltaSteppingEngine(const G& g,
+                                 size_t threads = hardware_threads(),
+                                 weight_t delta = 0)
+        : m_delta(delta > 0 ? delta : default_delta(g)),
+          m_own_pool(std::make_unique<ThreadPool>(threads)),
+          m_pool(*m_own_pool) {
+        setup(g);
+    }
+    DeltaSteppingEngine(const DeltaSteppingEngine&) = delete;
+    DeltaSteppingEngine& operator=(const DeltaSteppingEngine&) = delete;
+
+    void search(const vertex_t& vertex, weight_t max_weight) {
+        m_distance = Array<weight_t>(m_bucket.size(), max_weight);
+        m_spt = Array<edge_t>(m_bucket.size());
+        for (auto& e : m_spt) e.m_target = nullptr;
+        m_bucket.fill(none);
+
+        size_t s = vertex;
+        m_distance[s] = 0;
+        m_bucket[s] = 0;
+        m_buckets[owner(s)][0].push_back(s);
+        for (size_t b = 0, empty = 0; empty < m_span; ++b) {
+            if (is_bucket_empty(b)) {
+                ++empty;
+                continue;
+            }
+            empty = 0;
+            while (take_bucket(b))
+                relax([&](size_t t, auto relax_edges) {
+                    for (auto v : m_frontiers[t])
+                        relax_edges(v, m_offsets[v], m_splits[v]);
+                });
+            relax([&](size_t t, auto relax_edges) {
+                for (auto v : m_settled[t]) {
+                    relax_edges(v, m_splits[v], m_offsets[v + 1]);
+                    m_is_settled[v] = false;
+                }
+                m_settled[t].clear();
+            });
+        }
+    }
+};
+
+/**
+ * The delta-stepping shortest paths tree from one vertex, as an Spt. Built
+ * from an engine, it takes the results of a search on it.
+ */
+template <typename G>
+struct DeltaStepping {
+    using engine_type = DeltaSteppingEngine<G>;
+    using vertex_t = typename engine_type::vertex_t;
+    using edge_t = typename engine_type::edge_t;
+    using weight_t = typename engine_type::weight_t;
+
+    Array<weight_t> m_distance;
+    Array<edge_t> m_spt;
+
+    DeltaStepping(engine_type& engine, const vertex_t& vertex,
+                  weight_t max_weight) {
+        engine.search(vertex, max_weight);
+        m_distance = std::move(engine.m_distance);
+        m_spt = std::move(engine.m_spt);
+    }
+    DeltaStepping(const G& g, const vertex_t& vertex, weight_t max_weight,
+                  size_t threads = hardware_threads(), weight_t delta = 0) {
+        engine_type engine(g, threads, delta);
+        *this = DeltaStepping(engine, vertex, max_weight);
+    }
+};
+
+}  // namespace Graph
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "array.h"
+#include "array_stack.h"
 
 namespace Graph {
 
@@ -41,6 +42,12 @@ class Counters<bool> : public Array<bool> {
     void set_next(size_t index) { Base::operator[](index) = true; }
 };
 
+/**
+ * Depth-first search calling the visit_vertex, visit_edge and
+ * search_post_process hooks of D in recursive order. The path is kept on an
+ * explicit stack of (vertex, edge iterator) frames, so the depth is not
+ * limited by the call stack.
+ */
 template <typename G, typename T_pre, typename D>
 class DfsBase {
    protected:
@@ -50,6 +57,26 @@ class DfsBase {
     Counters<T_pre> m_pre;
     D* m_d;
 
+   private:
+    using edges_iterator = typename vertex_type::const_edges_iterator;
+    struct Frame {
+        const vertex_type* m_vertex;
+        edges_iterator m_edge;
+        Frame(const vertex_type* vertex, const edges_iterator& edge)
+            : m_vertex(vertex), m_edge(edge) {}
+    };
+    ArrayStack<Frame> m_frames;
+
+    void enter(const vertex_type& v) {
+        m_d->visit_vertex(v);
+        m_pre.set_next(v);
+        m_frames.emplace(&v, v.cedges_begin());
+    }
+    void finish_edge() {
+        m_d->visit_edge(*m_frames.top().m_edge);
+        ++m_frames.top().m_edge;
+    }
+
    public:
     DfsBase(const G& g)
         : m_g(g), m_pre(g.vertices_count()), m_d(static_cast<D*>(this)) {}
@@ -58,13 +85,21 @@ class DfsBase {
             if (m_pre.is_unset(*v)) m_d->search_vertex(*v);
     }
     void search_vertex(const vertex_type& v) {
-        m_d->visit_vertex(v);
-        m_pre.set_next(v);
-        for (auto e = v.cedges_begin(); e != v.cedges_end(); ++e) {
-            if (m_pre.is_unset(e->target())) search_vertex(e->target());
-            m_d->visit_edge(*e);
+        // frames below the base belong to an enclosing search
+        size_t base = m_frames.size();
+        enter(v);
+        while (m_frames.size() > base) {
+            auto& frame = m_frames.top();
+            if (frame.m_edge == frame.m_vertex->cedges_end()) {
+                auto& w = *frame.m_vertex;
+                m_frames.pop();
+                m_d->search_post_process(w);
+                if (m_frames.size() > base) finish_edge();
+            } else if (m_pre.is_unset(frame.m_edge->target()))
+                enter(frame.m_edge->target());
+            else
+                finish_edge();
         }
-        m_d->search_post_process(v);
     }
 };
 
@@ -0,0 +1,285 @@
+#pragma once
+
+#include <charconv>
+#include <cstring>
+#include <istream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include "csr.h"
+#include "hash_map.h"
+#include "parallel.h"
+#include "vector.h"
+
+namespace Graph {
+
+class EdgeListException : public std::runtime_error {
+   public:
+    explicit EdgeListException(const std::string& message)
+        : std::runtime_error("edge list: " + message) {}
+};
+
+namespace Edge_list_ns {
+
+template <typename T, typename = void>
+struct TokenParser;
+
+template <typename T>
+struct TokenParser<T, std::enable_if_t<std::is_arithmetic_v<T>>> {
+    static bool parse(const char* b, const char* e, T& t) {
+        auto r = std::from_chars(b, e, t);
+        return r.ec == std::errc() && r.ptr == e;
+    }
+};
+
+template <>
+struct TokenParser<std::string> {
+    static bool parse(const char* b, const char* e, std::string& t) {
+        t.assign(b, e);
+        return true;
+    }
+};
+
+template <typename E, typename ET = typename E::value_type>
+struct EdgeParser {
+    static const constexpr bool weighted = true;
+    static bool parse(const char* b, const char* e, E& edge) {
+        ET weight;
+        if (!TokenParser<ET>::parse(b, e, weight)) return false;
+        edge = E(weight);
+        return true;
+    }
+};
+
+template <typename E>
+struct EdgeParser<E, bool> {
+    static const constexpr bool weighted = false;
+    static bool parse(const char*, const char*, E& edge) {
+        edge = E(true);
+        return true;
+    }
+};
+
+template <typename VT, typename E>
+struct ParsedEdge {
+    VT m_source;
+    VT m_target;
+    E m_edge;
+};
+
+inline bool is_blank(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+/**
+ * Parses the lines "source target [weight]" of [b, e) into edges, skipping
+ * empty lines and '#' or '%' comments. Returns the first malformed line or
+ * nullptr.
+ */
+template <typename VT, typename E>
+const char* parse_lines(const char* b, const char* e,
+                        Vector<ParsedEdge<VT, E>>& edges) {
+    using edge_parser = EdgeParser<E>;
+    const char* tokens[3][2] = {};
+    ParsedEdge<VT, E> edge;
+    for (const char* line = b; line != e;) {
+        const char* line_end = line;
+        for (; line_end != e && *line_end != '\n'; ++line_end)
+            ;
+        size_t count = 0;
+        for (const char* p = line; p != line_end && count < 3;) {
+            for (; p != line_end && is_blank(*p); ++p)
+                ;
+            if (p == line_end) break;
+            tokens[count][0] = p;
+            for (; p != line_end && !is_blank(*p); ++p)
+                ;
+            tokens[count++][1] = p;
+        }
+        bool comment = count && (*tokens[0][0] == '#' || *tokens[0][0] == '%');
+        if (count && !comment) {
+            if (count < (edge_parser::weighted ? 3 : 2) ||
+                !TokenParser<VT>::parse(tokens[0][0], tokens[0][1],
+                                        edge.m_source) ||
+                !TokenParser<VT>::parse(tokens[1][0], tokens[1][1],
+                                        edge.m_target) ||
+                !edge_parser::parse(tokens[2][0], tokens[2][1], edge.m_edge))
+                return line;
+            edges.push_back(edge);
+        }
+        line = line_end == e ? e : line_end + 1;
+    }
+    return nullptr;
+}
+
+}  // namespace Edge_list_ns
+
+/**
+ * Edge list read in large chunks, with the vertex labels interned into dense
+ * ids in the order of their first appearance. Text chunks are split at line
+ * boundaries and parsed on several threads; interning stays sequential, so
+ * the ids do not depend on the number of threads.
+ */
+template <typename VT, typename E = Adjacency_lists_ns::Edge<bool>>
+class EdgeList {
+   public:
+    using value_type = VT;
+    using edge_type = E;
+    using item_type = Csr_ns::EdgeListItem<E>;
+
+   private:
+    using parsed_edge_type = Edge_list_ns::ParsedEdge<VT, E>;
+    static const constexpr size_t default_chunk_size = 1 << 24;
+
+    Vector<VT> m_values;
+    Vector<item_type> m_edges;
+    HashMap<VT, size_t> m_ids;
+    size_t m_threads;
+    size_t m_chunk_size;
+
+    void parse_text(const char* b, const char* e) {
+        Array<const char*> bounds(m_threads + 1);
+        bounds[0] = b;
+        bounds[m_threads] = e;
+        for (size_t i = 1; i < m_threads; ++i) {
+            auto p = std::max(bounds[i - 1], b + (e - b) * i / m_threads);
+            for (; p != e && p != b && p[-1] != '\n'; ++p)
+                ;
+            bounds[i] = p;
+        }
+        Array<Vector<parsed_edge_type>> parsed(m_threads);
+        parallel_blocks(m_threads, m_threads, [&](size_t i, size_t, size_t) {
+            auto error = Edge_list_ns::parse_lines(bounds[i], bounds[i + 1],
+                                                   parsed[i]);
+            if (error) {
+                auto end = error;
+                for (; end != bounds[i + 1] && *end != '\n'; ++end)
+                    ;
+                throw EdgeListException("malformed line '" +
+                                        std::string(error, end) + "'");
+            }
+        });
+        for (auto& edges : parsed)
+            for (auto& edge : edges)
+                add_edge(edge.m_source, edge.m_target, edge.m_edge);
+    }
+
+   public:
+    explicit EdgeList(size_t threads = 1,
+                      size_t chunk_size = default_chunk_size)
+        : m_threads(std::max<size_t>(1, threads)),
+          m_chunk_size(std::max<size_t>(1, chunk_size)) {}
+
+    size_t vertices_count() const { return m_values.size(); }
+    size_t edges_count() const { return m_edges.size(); }
+    const Vector<VT>& values() const { return m_values; }
+    auto cbegin() const { return m_edges.cbegin(); }
+    auto cend() const { return m_edges.cend(); }
+
+    size_t intern(const VT& label) {
+        auto r = m_ids.insert(label, m_values.size());
+        if (r.second) m_values.push_back(label);
+        return *r.first;
+    }
+    void add_edge(const VT& source, const VT& target, const E& edge = E()) {
+        auto s = intern(source);
+        m_edges.push_back(item_type{s, intern(target), edge});
+    }
+
+    /**
+     * Reads lines "source target [weight]"; the weight is required for
+     * weighted edges and extra columns are ignored.
+     */
+    void read_text(std::istream& stream) {
+        std::string buffer;
+        while (stream) {
+            auto carried = buffer.size();
+            buffer.resize(carried + m_chunk_size);
+            stream.read(&buffer[carried], m_chunk_size);
+            buffer.resize(carried + stream.gcount());
+            size_t end = buffer.size();
+            if (stream) {
+                auto last_line = buffer.rfind('\n');
+                end = last_line == std::string::npos ? 0 : last_line + 1;
+            }
+            parse_text(buffer.data(), buffer.data() + end);
+            buffer.erase(0, end);
+        }
+    }
+
+    /**
+     * Reads packed records of the raw source and target labels, followed by
+     * the raw weight for weighted edges.
+     */
+    void read_binary(std::istream& stream) {
+        static_assert(std::is_trivially_copyable_v<VT>,
+                      "binary labels must be trivially copyable");
+        using weight_type = typename E::value_type;
+        constexpr bool weighted = Edge_list_ns::EdgeParser<E>::weighted;
+        constexpr size_t record_size =
+            2 * sizeof(VT) + (weighted ? sizeof(weight_type) : 0);
+        size_t records = std::max<size_t>(1, m_chunk_size / record_size);
+        Array<char> buffer(records * record_size);
+        while (stream) {
+            stream.read(buffer.begin(), buffer.size());
+            size_t size = stream.gcount();
+            if (size % record_size)
+                throw EdgeListException("truncated binary record");
+            for (auto p = buffer.cbegin(); p != buffer.cbegin() + size;
+                 p += record_size) {
+                VT source, target;
+                std::memcpy(&source, p, sizeof(VT));
+                std::memcpy(&target, p + sizeof(VT), sizeof(VT));
+                E edge(true);
+                if constexpr (weighted) {
+                    weight_type weight;
+                    std::memcpy(&weight, p + 2 * sizeof(VT), sizeof(weight));
+                    edge = E(weight);
+                }
+                add_edge(source, target, edge);
+            }
+        }
+    }
+
+    /**
+     * Two-pass CSR build: degrees are counted first, then the rows are
+     * filled in place.
+     */
+    template <GraphType T_graph_type>
+    Csr_ns::Csr<T_graph_type, Csr_ns::Vertex<T_graph_type, VT, E>> to_csr()
+        const {
+        Array<VT> values(m_values.size());
+        for (size_t v = 0; v < m_values.size(); ++v) values[v] = m_values[v];
+        return {values, m_edges.cbegin(), m_edges.cend()};
+    }
+
+    /**
+     * Appends the vertices and edges to adjacency lists in bulk-load mode,
+     * with the links of every vertex reserved from the degrees counted
+     * first, as to_csr() does.
+     */
+    template <typename G>
+    void fill(G& g) const {
+        auto first = g.vertices_count();
+        for (auto v = m_values.cbegin(); v != m_values.cend(); ++v)
+            g.create_vertex(*v);
+        Array<size_t> degrees(m_values.size(), 0);
+        for (auto e = m_edges.cbegin(); e != m_edges.cend(); ++e) {
+            ++degrees[e->m_source];
+            if (is_undirected_v<G>) ++degrees[e->m_target];
+        }
+        for (size_t v = 0; v < degrees.size(); ++v)
+            g.reserve_links(g[first + v], degrees[v]);
+        g.begin_bulk_load();
+        for (auto e = m_edges.cbegin(); e != m_edges.cend(); ++e) {
+            auto& s = g[first + e->m_source];
+            auto& t = g[first + e->m_target];
+            if constexpr (Edge_list_ns::EdgeParser<E>::weighted)
+                g.add_edge(s, t, e->m_edge);
+            else
+                g.add_edge(s, t);
+        }
+        g.commit_bulk_load();
+    }
+};
+
+}  // namespace Graph
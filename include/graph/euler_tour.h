@@ -0,0 +1,154 @@
+#pragma once
+
+#include <algorithm>
+#include <optional>
+#include <type_traits>
+
+#include "array.h"
+#include "array_stack.h"
+#include "biconnectivity.h"
+#include "graph_common.h"
+#include "vector.h"
+
+namespace Graph {
+
+namespace Euler_tour_ns {
+
+static const constexpr size_t none = -1;
+
+// the arcs of a digraph, walked in place: every arc is an edge of its own,
+// used once the cursor of its source has passed it
+template <typename G>
+class DigraphArcs {
+   private:
+    using cursor_type = typename G::vertex_type::const_iterator;
+
+    const G& m_g;
+    Array<std::optional<cursor_type>> m_next;
+
+   public:
+    explicit DigraphArcs(const G& g) : m_g(g), m_next(g.vertices_count()) {}
+
+    bool balanced() const {
+        auto count = m_g.vertices_count();
+        Array<size_t> degrees(count, 0);
+        for (auto v = m_g.cbegin(); v != m_g.cend(); ++v)
+            for (auto w = v->cbegin(); w != v->cend(); ++w) {
+                ++degrees[*v];
+                --degrees[*w];
+            }
+        for (size_t v = 0; v < count; ++v)
+            if (degrees[v] != 0) return false;
+        return true;
+    }
+    void reset() {
+        for (size_t v = 0; v < m_next.size(); ++v)
+            m_next[v].emplace(m_g[v].cbegin());
+    }
+    // the target of the next unused arc of v, or none
+    size_t next(size_t v) {
+        auto& p = *m_next[v];
+        if (!(p != m_g[v].cend())) return none;
+        size_t w = *p;
+        ++p;
+        return w;
+    }
+};
+
+// the arcs of an undirected graph, the two of every edge paired by an edge
+// index, with a flag per used edge
+class GraphArcs {
+   private:
+    Biconnectivity_ns::EdgeIndex m_index;
+    Array<bool> m_used;
+    Array<size_t> m_next;
+
+   public:
+    template <typename G>
+    explicit GraphArcs(const G& g)
+        : m_index(g),
+          m_used(m_index.edges_count(), false),
+          m_next(m_index.vertices_count()) {}
+
+    bool balanced() const {
+        for (size_t v = 0; v < m_index.vertices_count(); ++v)
+            if ((m_index.arcs_end(v) - m_index.arcs_begin(v)) % 2 != 0)
+                return false;
+        return true;
+    }
+    void reset() {
+        m_used.fill(false);
+        for (size_t v = 0; v < m_next.size(); ++v)
+            m_next[v] = m_index.arcs_begin(v);
+    }
+    // the target of the next unused arc of v, or none
+    size_t next(size_t v) {
+        auto& p = m_next[v];
+        for (auto end = m_index.arcs_end(v); p != end; ++p)
+            if (!m_used[m_index.arc_edge(p)]) {
+                m_used[m_index.arc_edge(p)] = true;
+                return m_index.arc_target(p++);
+            }
+        return none;
+    }
+};
+
+}  // namespace Euler_tour_ns
+
+/**
+ * Hierholzer's Euler tour, leaving the graph untouched: every vertex keeps
+ * a cursor on its arcs and the vertices left with unused edges wait on a
+ * stack. The edges are taken in the adjacency order, the two arcs of an
+ * undirected edge paired in the order of their sources, so the tour is the
+ * one removing the first edge of every vertex. O(V + E).
+ *
+ * A digraph is walked in place, with a cursor into the links of every
+ * vertex. An undirected graph first has its arcs copied into an edge index
+ * pairing them, three words per arc (its target and edge, and the two
+ * endpoints of every edge) and two per vertex, plus a flag per edge.
+ *
+ * The tour from s, as vertex indices, covers the edges reached from s. It
+ * is empty when a vertex has an odd degree, or different in and out
+ * degrees in a digraph.
+ */
+template <typename G>
+class EulerTour {
+   private:
+    using arcs_type =
+        std::conditional_t<is_undirected_v<G>, Euler_tour_ns::GraphArcs,
+                           Euler_tour_ns::DigraphArcs<G>>;
+
+    arcs_type m_arcs;
+    bool m_balanced;
+    ArrayStack<size_t> m_stack;
+
+    // walks from v along unused edges until stuck, returns the last vertex
+    size_t walk(size_t v) {
+        for (auto w = m_arcs.next(v); w != Euler_tour_ns::none;
+             w = m_arcs.next(v)) {
+            m_stack.push(v);
+            v = w;
+        }
+        return v;
+    }
+
+   public:
+    explicit EulerTour(const G& g) : m_arcs(g), m_balanced(m_arcs.balanced()) {}
+
+    Vector<size_t> tour(size_t s) {
+        Vector<size_t> path;
+        if (!m_balanced) return path;
+        m_arcs.reset();
+        m_stack.clear();
+        path.push_back(s);
+        for (auto v = s; walk(v) == v && !m_stack.empty();) {
+            v = m_stack.pop();
+            path.push_back(v);
+        }
+        // the vertices come out against the arcs
+        if (!is_undirected_v<G>) std::reverse(path.begin(), path.end());
+        return path;
+    }
+};
+
+}  // namespace Graph
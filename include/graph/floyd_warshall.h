@@ -0,0 +1,330 @@
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+#include "array.h"
+#include "graph_common.h"
+#include "parallel.h"
+#include "two_dimensional_array.h"
+
+namespace Graph {
+
+namespace Floyd_warshall_ns {
+
+/**
+ * Min-plus row kernels: c[j] = min(c[j], a + b[j]) for j < n, copying
+ * b_last[j] to c_last[j] wherever c[j] drops. The vector kernels compare
+ * whole lanes and fix the indices of the lanes which changed only, which
+ * later in the algorithm are few.
+ */
+template <typename T>
+using MinPlusRow = void (*)(T* c, uint32_t* c_last, const T* b,
+                            const uint32_t* b_last, T a, size_t n);
+
+template <typename T>
+void min_plus_scalar(T* c, uint32_t* c_last, const T* b,
+                     const uint32_t* b_last, T a, size_t n) {
+    for (size_t j = 0; j < n; ++j) {
+        T d = a + b[j];
+        if (d < c[j]) {
+            c[j] = d;
+            c_last[j] = b_last[j];
+        }
+    }
+}
+
+#if defined(__GNUC__) && defined(__x86_64__)
+
+inline void copy_lanes(uint32_t* c_last, const uint32_t* b_last,
+                       unsigned mask) {
+    for (; mask; mask &= mask - 1) {
+        auto lane = __builtin_ctz(mask);
+        c_last[lane] = b_last[lane];
+    }
+}
+
+// SSE2 is part of x86-64, so these need no dispatch
+inline void min_plus_sse2(double* c, uint32_t* c_last, const double* b,
+                          const uint32_t* b_last, double a, size_t n) {
+    size_t j = 0;
+    auto va = _mm_set1_pd(a);
+    for (; j + 2 <= n; j += 2) {
+        auto d = _mm_add_pd(va, _mm_loadu_pd(b + j));
+        auto x = _mm_loadu_pd(c + j);
+        unsigned mask = _mm_movemask_pd(_mm_cmplt_pd(d, x));
+        if (!mask) continue;
+        _mm_storeu_pd(c + j, _mm_min_pd(d, x));
+        copy_lanes(c_last + j, b_last + j, mask);
+    }
+    min_plus_scalar(c + j, c_last + j, b + j, b_last + j, a, n - j);
+}
+
+inline void min_plus_sse2(float* c, uint32_t* c_last, const float* b,
+                          const uint32_t* b_last, float a, size_t n) {
+    size_t j = 0;
+    auto va = _mm_set1_ps(a);
+    for (; j + 4 <= n; j += 4) {
+        auto d = _mm_add_ps(va, _mm_loadu_ps(b + j));
+        auto x = _mm_loadu_ps(c + j);
+        unsigned mask = _mm_movemask_ps(_mm_cmplt_ps(d, x));
+        if (!mask) continue;
+        _mm_storeu_ps(c + j, _mm_min_ps(d, x));
+        copy_lanes(c_last + j, b_last + j, mask);
+    }
+    min_plus_scalar(c + j, c_last + j, b + j, b_last + j, a, n - j);
+}
+
+template <typename T>
+void min_plus_sse2_int32(T* c, uint32_t* c_last, const T* b,
+                         const uint32_t* b_last, T a, size_t n) {
+    size_t j = 0;
+    auto va = _mm_set1_epi32(a);
+    for (; j + 4 <= n; j += 4) {
+        auto d = _mm_add_epi32(
+            va, _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + j)));
+        auto p = reinterpret_cast<__m128i*>(c + j);
+        auto x = _mm_loadu_si128(p);
+        auto less = _mm_cmpgt_epi32(x, d);
+        unsigned mask = _mm_movemask_ps(_mm_castsi128_ps(less));
+        if (!mask) continue;
+        _mm_storeu_si128(p, _mm_or_si128(_mm_and_si128(less, d),
+                                         _mm_andnot_si128(less, x)));
+        copy_lanes(c_last + j, b_last + j, mask);
+    }
+    min_plus_scalar(c + j, c_last + j, b + j, b_last + j, a, n - j);
+}
+
+__attribute__((target("avx2"))) inline void min_plus_avx2(
+    double* c, uint32_t* c_last, const double* b, const uint32_t* b_last,
+    double a, size_t n) {
+    size_t j = 0;
+    auto va = _mm256_set1_pd(a);
+    for (; j + 4 <= n; j += 4) {
+        auto d = _mm256_add_pd(va, _mm256_loadu_pd(b + j));
+        auto x = _mm256_loadu_pd(c + j);
+        unsigned mask =
+            _mm256_movemask_pd(_mm256_cmp_pd(d, x, _CMP_LT_OQ));
+        if (!mask) continue;
+        _mm256_storeu_pd(c + j, _mm256_min_pd(d, x));
+        copy_lanes(c_last + j, b_last + j, mask);
+    }
+    min_plus_scalar(c + j, c_last + j, b + j, b_last + j, a, n - j);
+}
+
+__attribute__((target("avx2"))) inline void min_plus_avx2(
+    float* c, uint32_t* c_last, const float* b, const uint32_t* b_last,
+    float a, size_t n) {
+    size_t j = 0;
+    auto va = _mm256_set1_ps(a);
+    for (; j + 8 <= n; j += 8) {
+        auto d = _mm256_add_ps(va, _mm256_loadu_ps(b + j));
+        auto x = _mm256_loadu_ps(c + j);
+        unsigned mask =
+            _mm256_movemask_ps(_mm256_cmp_ps(d, x, _CMP_LT_OQ));
+        if (!mask) continue;
+        _mm256_storeu_ps(c + j, _mm256_min_ps(d, x));
+        copy_lanes(c_last + j, b_last + j, mask);
+    }
+    min_plus_scalar(c + j, c_last + j, b + j, b_last + j, a, n - j);
+}
+
+template <typename T>
+__attribute__((target("avx2"))) void min_plus_avx2_int32(
+    T* c, uint32_t* c_last, const T* b, const uint32_t* b_last, T a,
+    size_t n) {
+    size_t j = 0;
+    auto va = _mm256_set1_epi32(a);
+    for (; j + 8 <= n; j += 8) {
+        auto d = _mm256_add_epi32(
+            va, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + j)));
+        auto p = reinterpret_cast<__m256i*>(c + j);
+        auto x = _mm256_loadu_si256(p);
+        unsigned mask = _mm256_movemask_ps(
+            _mm256_castsi256_ps(_mm256_cmpgt_epi32(x, d)));
+        if (!mask) continue;
+        _mm256_storeu_si256(p, _mm256_min_epi32(d, x));
+        copy_lanes(c_last + j, b_last + j, mask);
+    }
+    min_plus_scalar(c + j, c_last + j, b + j, b_last + j, a, n - j);
+}
+
+template <typename T>
+__attribute__((target("avx2"))) void min_plus_avx2_int64(
+    T* c, uint32_t* c_last, const T* b, const uint32_t* b_last, T a,
+    size_t n) {
+    size_t j = 0;
+    auto va = _mm256_set1_epi64x(a);
+    for (; j + 4 <= n; j += 4) {
+        auto d = _mm256_add_epi64(
+            va, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + j)));
+        auto p = reinterpret_cast<__m256i*>(c + j);
+        auto x = _mm256_loadu_si256(p);
+        auto less = _mm256_cmpgt_epi64(x, d);
+        unsigned mask = _mm256_movemask_pd(_mm256_castsi256_pd(less));
+        if (!mask) continue;
+        _mm256_storeu_si256(p, _mm256_blendv_epi8(x, d, less));
+        copy_lanes(c_last + j, b_last + j, mask);
+    }
+    min_plus_scalar(c + j, c_last + j, b + j, b_last + j, a, n - j);
+}
+
+#endif
+
+template <typename T>
+constexpr bool is_int_v(size_t size) {
+    return std::is_integral_v<T> && std::is_signed_v<T> && sizeof(T) == size;
+}
+
+/**
+ * The fastest kernel for T which the processor runs: AVX2 when it has it,
+ * otherwise SSE2, for double, float and 32 and 64 bit signed integers.
+ */
+template <typename T>
+MinPlusRow<T> select_min_plus() {
+#if defined(__GNUC__) && defined(__x86_64__)
+    if (__builtin_cpu_supports("avx2")) {
+        if constexpr (std::is_same_v<T, double> || std::is_same_v<T, float>)
+            return min_plus_avx2;
+        else if constexpr (is_int_v<T>(4))
+            return min_plus_avx2_int32<T>;
+        else if constexpr (is_int_v<T>(8))
+            return min_plus_avx2_int64<T>;
+    }
+    if constexpr (std::is_same_v<T, double> || std::is_same_v<T, float>)
+        return min_plus_sse2;
+    else if constexpr (is_int_v<T>(4))
+        return min_plus_sse2_int32<T>;
+#endif
+    return min_plus_scalar<T>;
+}
+
+}  // namespace Floyd_warshall_ns
+
+/**
+ * All pairs shortest paths by Floyd-Warshall, for dense graphs, with the
+ * interface of FullSpts. The distances live in one matrix padded to whole
+ * tiles. For every diagonal tile k the algorithm closes tile (k, k), then
+ * the tiles of row and column k, then all the others, the tiles of each
+ * phase in parallel. Inner loops run a min-plus row kernel, vectorized
+ * for the usual weight types.
+ *
+ * As for Spt the weights must not be negative and max_weight marks the
+ * unreachable pairs, so pairs farther apart count as unreachable; twice
+ * max_weight must not overflow w_t.
+ */
+template <typename G>
+class FloydWarshall {
+   public:
+    using vertex_t = typename G::vertex_type;
+    using w_t = typename G::edge_type::value_type;
+    using edge_t = typename G::vertex_type::const_edges_iterator::entry_type;
+
+    static const constexpr size_t tile = 64;
+
+   private:
+    const G& m_g;
+    w_t m_max_weight;
+    // edges by index, the first standing for none
+    Array<edge_t> m_edges;
+    Two_dimensional_array<w_t> m_distances;
+    // the index of the last edge of every path
+    Two_dimensional_array<uint32_t> m_last;
+    Floyd_warshall_ns::MinPlusRow<w_t> m_min_plus;
+
+    static size_t padded(size_t count) {
+        return (count + tile - 1) / tile * tile;
+    }
+
+    // relaxes tile (i, j) through the vertices of tile k, in their order,
+    // so that it may be tile (i, k) or (k, j) itself
+    void relax(size_t i, size_t j, size_t k) {
+        for (auto kk = k * tile; kk < (k + 1) * tile; ++kk) {
+            const w_t* b = &m_distances.get(kk, j * tile);
+            const uint32_t* b_last = &m_last.get(kk, j * tile);
+            for (auto ii = i * tile; ii < (i + 1) * tile; ++ii) {
+                w_t a = m_distances.get(ii, kk);
+                if (!(a < m_max_weight)) continue;
+                m_min_plus(&m_distances.get(ii, j * tile),
+                           &m_last.get(ii, j * tile), b, b_last, a, tile);
+            }
+        }
+    }
+
+   public:
+    FloydWarshall(const G& g, w_t max_weight,
+                  size_t threads = hardware_threads())
+        : m_g(g),
+          m_max_weight(max_weight),
+          m_distances(padded(g.vertices_count()),
+                      padded(g.vertices_count())),
+          m_last(padded(g.vertices_count()), padded(g.vertices_count())),
+          m_min_plus(Floyd_warshall_ns::select_min_plus<w_t>()) {
+        size_t edges_count = 1;
+        for (auto v = g.cbegin(); v != g.cend(); ++v)
+            for (auto e = v->cedges_begin(); e != v->cedges_end(); ++e)
+                ++edges_count;
+        m_edges = Array<edge_t>(edges_count);
+        m_edges[0].m_target = nullptr;
+        m_distances.fill(max_weight);
+        m_last.fill(0);
+        for (size_t v = 0; v < g.vertices_count(); ++v)
+            m_distances.get(v, v) = 0;
+        uint32_t i = 0;
+        for (auto v = g.cbegin(); v != g.cend(); ++v)
+            for (auto e = v->cedges_begin(); e != v->cedges_end(); ++e) {
+                m_edges[++i] = *e;
+                auto& d = m_distances.get(*v, e->target());
+                if (e->edge().weight() < d) {
+                    d = e->edge().weight();
+                    m_last.get(*v, e->target()) = i;
+                }
+            }
+
+        ThreadPool pool(threads);
+        size_t tiles = padded(g.vertices_count()) / tile;
+        for (size_t k = 0; k < tiles; ++k) {
+            relax(k, k, k);
+            pool.for_each(2 * (tiles - 1), [&](size_t t) {
+                auto other = t / 2 < k ? t / 2 : t / 2 + 1;
+                if (t % 2)
+                    relax(k, other, k);
+                else
+                    relax(other, k, k);
+            });
+            pool.for_each((tiles - 1) * (tiles - 1), [&](size_t t) {
+                auto i = t / (tiles - 1);
+                auto j = t % (tiles - 1);
+                relax(i < k ? i : i + 1, j < k ? j : j + 1, k);
+            });
+        }
+    }
+
+    w_t distance(size_t v, size_t w) const {
+        return m_distances.get(v, w);
+    }
+    // the last edge of the path from w to v
+    const edge_t& path(size_t v, size_t w) const { return path_r(w, v); }
+    // the last edge of the path from v to w
+    const edge_t& path_r(size_t v, size_t w) const {
+        return m_edges[m_last.get(v, w)];
+    }
+    std::pair<const vertex_t*, const vertex_t*> diameter() const {
+        size_t v_max = 0;
+        size_t w_max = 0;
+        for (auto v = m_g.cbegin(); v != m_g.cend(); ++v)
+            for (auto w = m_g.cbegin(); w != m_g.cend(); ++w)
+                if (path(*v, *w).m_target &&
+                    distance(*v, *w) > distance(v_max, w_max)) {
+                    v_max = *v;
+                    w_max = *w;
+                }
+        return {&m_g[v_max], &m_g[w_max]};
+    }
+};
+
+}  // namespace Graph
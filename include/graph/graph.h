@@ -1,14 +1,23 @@
 #pragma once
 
+#include <cstdint>
 #include <iostream>
 #include <map>
 
 #include "adjacency_lists.h"
 #include "array.h"
+#include "array_stack.h"
+#include "bellman_ford.h"
+#include "bfs.h"
 #include "dfs.h"
+#include "euler_tour.h"
+#include "graph_views.h"
+#include "hash_map.h"
+#include "parallel.h"
 #include "stack.h"
 #include "string_utils.h"
 #include "two_dimensional_array.h"
+#include "vertex_heaps.h"
 
 namespace Graph {
 
@@ -17,7 +26,7 @@ class Constructor {
    private:
     using vertex_type = typename G::vertex_type;
     G& m_graph;
-    std::map<T, typename G::vertex_type&> m_vertices;
+    HashMap<T, size_t> m_vertices;
 
    public:
     Constructor(G& graph) : m_graph(graph) {}
@@ -28,19 +37,15 @@ class Constructor {
         return *this;
     }
     vertex_type& get_or_create_vertex(const T& l) {
-        auto it = m_vertices.find(l);
-        if (it == m_vertices.end()) {
-            auto& v = m_graph.create_vertex(l);
-            m_vertices.insert({l, v});
-            return v;
-        }
-        return it->second;
+        auto r = m_vertices.insert(l, m_graph.vertices_count());
+        if (r.second) m_graph.create_vertex(l);
+        return m_graph[*r.first];
     }
     vertex_type& get_vertex(const T& label) {
-        auto it = m_vertices.find(label);
-        if (it == m_vertices.end())
+        auto index = m_vertices.find(label);
+        if (!index)
             throw std::runtime_error("vertex "_str + label + " not found");
-        return it->second;
+        return m_graph[*index];
     };
 };
 
@@ -53,25 +58,22 @@ class Builder {
     using value_type = typename vertex_type::value_type;
 
     G m_g;
-    std::map<value_type, vertex_type* const> m_map;
-
-    vertex_type* const get_or_create_vertex(const value_type& value) {
-        auto vertex = m_map.find(value);
-        if (vertex == m_map.end()) {
-            auto p = &m_g.create_vertex(value);
-            m_map.insert({value, p});
-            return p;
-        }
-        return vertex->second;
+    HashMap<value_type, size_t> m_map;
+
+    size_t get_or_create_vertex(const value_type& value) {
+        auto r = m_map.insert(value, m_g.vertices_count());
+        if (r.second) m_g.create_vertex(value);
+        return *r.first;
     }
     template <typename... Args>
-    void add_edge(vertex_type* const v, const value_type& w, Args&&... args) {
-        m_g.add_edge(*v, *get_or_create_vertex(w), std::forward<Args>(args)...);
+    void add_edge(size_t v, const value_type& w, Args&&... args) {
+        auto t = get_or_create_vertex(w);
+        m_g.add_edge(m_g[v], m_g[t], std::forward<Args>(args)...);
     }
     template <typename E, typename... Es>
     void add_edges(Vertex& vertex, E&& edge, Es&&... edges) {
-        m_g.add_edge(*vertex.m_vertex,
-                     *get_or_create_vertex(std::forward<E>(edge)));
+        auto t = get_or_create_vertex(std::forward<E>(edge));
+        m_g.add_edge(m_g[vertex.m_index], m_g[t]);
         add_edges(vertex, std::forward<Es>(edges)...);
     }
     void add_edges(Vertex&) {}
@@ -93,12 +95,12 @@ class Builder<G>::Vertex {
     builder_type& m_builder;
 
    public:
-    vertex_type* const m_vertex;
-    Vertex(builder_type& b, vertex_type* const v) : m_builder(b), m_vertex(v) {}
+    const size_t m_index;
+    Vertex(builder_type& b, size_t index) : m_builder(b), m_index(index) {}
 
     template <typename... Args>
     Vertex& add_edge(const value_type& v, Args&&... args) {
-        m_builder.add_edge(m_vertex, v, std::forward<Args>(args)...);
+        m_builder.add_edge(m_index, v, std::forward<Args>(args)...);
         return *this;
     }
     template <typename... E>
@@ -151,20 +153,30 @@ auto count_vertex_edges(const V& v) {
 
 template <typename G, typename V = typename G::vertex_type>
 bool has_simple_path(const G& graph, const V& v1, const V& v2) {
-    Array<bool> visited(graph.vertices_count());
-    for (auto& b : visited) b = false;
-    static struct {
-        bool has_simple_path(const G& graph, const V& v1, const V& v2,
-                             Array<bool>& visited) {
-            if (v1 == v2) return true;
-            visited[v1] = true;
-            for (auto v = v1.cbegin(); v != v1.cend(); ++v)
-                if (!visited[*v])
-                    if (has_simple_path(graph, *v, v2, visited)) return true;
-            return false;
+    if (v1 == v2) return true;
+    Array<bool> visited(graph.vertices_count(), false);
+    struct Frame {
+        const V* m_v;
+        typename V::const_iterator m_it;
+        Frame(const V& v) : m_v(&v), m_it(v.cbegin()) {}
+    };
+    ArrayStack<Frame> stack;
+    visited[v1] = true;
+    stack.emplace(v1);
+    while (!stack.empty()) {
+        auto& frame = stack.top();
+        if (frame.m_it == frame.m_v->cend()) {
+            stack.pop();
+            continue;
         }
-    } helper;
-    return helper.has_simple_path(graph, v1, v2, visited);
+        auto& w = *frame.m_it;
+        ++frame.m_it;
+        if (visited[w]) continue;
+        if (w == v2) return true;
+        visited[w] = true;
+        stack.emplace(w);
+    }
+    return false;
 }
 
 template <typename G, typename V = typename G::vertex_type>
@@ -204,42 +216,8 @@ Array<const V*> compose_hamilton_path(const G& graph, const V& s, const V& t) {
 
 template <typename G, typename V = typename G::vertex_type>
 auto compose_euler_tour(const G& g, const V& s) {
-    using Path = ForwardList<const V*>;
-    Path path;
-    for (auto w = g.cbegin(); w != g.cend(); ++w)
-        if (count_vertex_edges(*w) % 2 != 0) return path;
-
-    struct Helper {
-        const G& m_original_g;
-        G& m_g;
-        Stack<V*> m_stack;
-        Path& m_path;
-        Helper(const G& original_graph, G& g, Path& path)
-            : m_original_g(original_graph), m_g(g), m_path(path) {}
-        V* tour(V* v) {
-            while (true) {
-                auto it = v->begin();
-                if (it == v->end()) break;
-                m_stack.push(v);
-                auto& w = *it;
-                m_g.remove_edge(*v, w);
-                v = &w;
-            }
-            return v;
-        }
-        void compose(V* v) {
-            push_original_v(v);
-            while (tour(v) == v && !m_stack.empty()) {
-                v = m_stack.pop();
-                push_original_v(v);
-            }
-        }
-        void push_original_v(const V* v) {
-            m_path.push_back(&m_original_g[*v]);
-        }
-    };
-    auto g_copy = g;
-    Helper(g, g_copy, path).compose(&g_copy[s]);
+    ForwardList<const V*> path;
+    for (auto v : EulerTour<G>(g).tour(s)) path.push_back(&g[v]);
     return path;
 }
 
@@ -258,21 +236,48 @@ ForwardList<std::pair<const V*, const V*>> find_bridges(const G& graph) {
               m_order(-1) {
             for (auto& o : m_orders) o = -1;
         }
+        struct Frame {
+            const V* m_parent;
+            const V* m_w;
+            typename V::const_iterator m_t;
+            bool m_descended;
+            Frame(const V& parent, const V& w)
+                : m_parent(&parent), m_w(&w), m_t(w.cbegin()),
+                  m_descended(false) {}
+        };
+        ArrayStack<Frame> m_frames;
+
         void search() {
             for (auto v = m_g.cbegin(); v != m_g.cend(); ++v)
                 if (m_orders[*v] == -1) search(*v, *v);
         }
-        void search(const V& v, const V& w) {
+        void enter(const V& v, const V& w) {
             m_orders[w] = ++m_order;
             m_mins[w] = m_orders[w];
-            for (auto t = w.cbegin(); t != w.cend(); ++t)
-                if (m_orders[*t] == -1) {
-                    search(w, *t);
-                    if (m_mins[w] > m_mins[*t]) m_mins[w] = m_mins[*t];
-                    if (m_mins[*t] == m_orders[*t])
-                        m_bridges.emplace_back(&w, &*t);
-                } else if (v != *t)
-                    m_mins[w] = m_mins[*t];
+            m_frames.emplace(v, w);
+        }
+        void search(const V& v, const V& w) {
+            enter(v, w);
+            while (!m_frames.empty()) {
+                auto& f = m_frames.top();
+                auto& w = *f.m_w;
+                if (f.m_descended) {
+                    auto& t = *f.m_t;
+                    if (m_mins[w] > m_mins[t]) m_mins[w] = m_mins[t];
+                    if (m_mins[t] == m_orders[t])
+                        m_bridges.emplace_back(&w, &t);
+                    f.m_descended = false;
+                    ++f.m_t;
+                } else if (f.m_t == w.cend())
+                    m_frames.pop();
+                else if (m_orders[*f.m_t] == -1) {
+                    f.m_descended = true;
+                    enter(w, *f.m_t);
+                } else {
+                    if (*f.m_parent != *f.m_t) m_mins[w] = m_mins[*f.m_t];
+                    ++f.m_t;
+                }
+            }
         }
     };
     Searcher s(graph);
@@ -280,45 +285,175 @@ ForwardList<std::pair<const V*, const V*>> find_bridges(const G& graph) {
     return std::move(s.m_bridges);
 }
 
+/**
+ * Shortest path trees of all the vertices, one row of parent indices per
+ * root. The indices take 16 bits when the vertices count allows it and 32
+ * bits otherwise.
+ */
 template <typename V>
 class ShortestPathsMatrix {
    public:
-    using parents_type = Two_dimensional_array<const V*>;
+    static const constexpr size_t unreached = -1;
+    class PathIterator;
+    class Path;
 
    private:
-    parents_type m_parents;
+    Array<const V*> m_vertices;
+    Two_dimensional_array<uint16_t> m_narrow_parents;
+    Two_dimensional_array<uint32_t> m_wide_parents;
+
+    template <typename I>
+    static Two_dimensional_array<I> allocate(size_t count, bool used) {
+        return used ? Two_dimensional_array<I>(count, count)
+                    : Two_dimensional_array<I>(0, 0);
+    }
 
    public:
-    ShortestPathsMatrix(parents_type&& parents) : m_parents(parents) {}
-    auto find_path(const V& v, const V& w) {
-        ForwardList<const V*> path;
-        auto row = m_parents[w];
-        for (auto t = &v; t != &w; t = row[*t]) path.push_back(t);
-        path.push_back(&w);
-        return path;
+    template <typename G>
+    explicit ShortestPathsMatrix(const G& g)
+        : m_vertices(g.vertices_count()),
+          m_narrow_parents(
+              allocate<uint16_t>(g.vertices_count(), is_narrow(g))),
+          m_wide_parents(
+              allocate<uint32_t>(g.vertices_count(), !is_narrow(g))) {
+        for (auto v = g.cbegin(); v != g.cend(); ++v) m_vertices[*v] = &*v;
     }
+
+    template <typename G>
+    static bool is_narrow(const G& g) {
+        return g.vertices_count() < uint16_t(-1);
+    }
+    bool is_narrow() const { return m_vertices.size() < uint16_t(-1); }
+    Two_dimensional_array<uint16_t>& narrow_parents() {
+        return m_narrow_parents;
+    }
+    Two_dimensional_array<uint32_t>& wide_parents() { return m_wide_parents; }
+
+    /**
+     * Parent of v in the shortest path tree of root; the root is its own
+     * parent.
+     */
+    size_t parent(size_t root, size_t v) const {
+        if (is_narrow()) {
+            auto p = m_narrow_parents.get(root, v);
+            return p == uint16_t(-1) ? unreached : p;
+        }
+        auto p = m_wide_parents.get(root, v);
+        return p == uint32_t(-1) ? unreached : p;
+    }
+
+    /**
+     * Walks the tree of w up from v without copying the path; the path is
+     * empty when v does not reach w.
+     */
+    Path find_path(const V& v, const V& w) const { return {*this, v, w}; }
 };
 
-template <typename G, typename V = typename G::vertex_type>
-ShortestPathsMatrix<V> find_shortest_paths(const G& g) {
-    typename ShortestPathsMatrix<V>::parents_type all_parents(
-        g.vertices_count(), g.vertices_count());
-    all_parents.fill(nullptr);
-    for (auto v = g.cbegin(); v != g.cend(); ++v) {
-        auto parents = all_parents[*v];
-        ForwardList<std::pair<const V&, const V&>> queue;
-        queue.emplace_back(*v, *v);
-        while (!queue.empty()) {
-            auto e = queue.pop_front();
-            auto& parent = parents[e.second];
-            if (!parent) {
-                parent = &e.first;
-                for (auto t = e.second.cbegin(); t != e.second.cend(); ++t)
-                    if (!parents[*t]) queue.emplace_back(e.second, *t);
+template <typename V>
+class ShortestPathsMatrix<V>::PathIterator {
+   private:
+    const ShortestPathsMatrix* m_matrix;
+    size_t m_root;
+    size_t m_vertex;
+
+   public:
+    PathIterator(const ShortestPathsMatrix& matrix, size_t root, size_t vertex)
+        : m_matrix(&matrix), m_root(root), m_vertex(vertex) {}
+    const V* operator*() const { return m_matrix->m_vertices[m_vertex]; }
+    PathIterator& operator++() {
+        m_vertex =
+            m_vertex == m_root ? unreached : m_matrix->parent(m_root, m_vertex);
+        return *this;
+    }
+    bool operator==(const PathIterator& o) const {
+        return m_vertex == o.m_vertex;
+    }
+    bool operator!=(const PathIterator& o) const { return !operator==(o); }
+};
+
+template <typename V>
+class ShortestPathsMatrix<V>::Path {
+   private:
+    const ShortestPathsMatrix& m_matrix;
+    size_t m_root;
+    size_t m_first;
+
+   public:
+    Path(const ShortestPathsMatrix& matrix, const V& v, const V& w)
+        : m_matrix(matrix),
+          m_root(w),
+          m_first(matrix.parent(w, v) == unreached ? unreached : size_t(v)) {}
+    PathIterator cbegin() const { return {m_matrix, m_root, m_first}; }
+    PathIterator cend() const { return {m_matrix, m_root, unreached}; }
+    bool empty() const { return m_first == unreached; }
+};
+
+/**
+ * Bit-parallel BFS (Then et al.) from the sources [first, first + 64):
+ * bit i of a vertex word stands for the search from first + i, so one scan
+ * of an adjacency row advances all the searches which reach the vertex.
+ * The words are reused across the batches of one thread.
+ */
+template <typename I>
+void multi_source_bfs(const Bfs_ns::AdjacencyIndex& index, size_t first,
+                      Two_dimensional_array<I>& parents, Array<uint64_t>& seen,
+                      Array<uint64_t>& visit, Array<uint64_t>& next) {
+    auto count = index.vertices_count();
+    auto batch = std::min<size_t>(64, count - first);
+    seen.fill(0);
+    visit.fill(0);
+    next.fill(0);
+    for (size_t i = 0; i < batch; ++i) {
+        auto row = parents[first + i];
+        for (auto& p : row) p = I(-1);
+        row[first + i] = first + i;
+        seen[first + i] |= uint64_t(1) << i;
+        visit[first + i] |= uint64_t(1) << i;
+    }
+    for (bool active = true; active;) {
+        active = false;
+        for (size_t v = 0; v < count; ++v) {
+            if (!visit[v]) continue;
+            for (auto w = index.cbegin(v); w != index.cend(v); ++w) {
+                auto reached = visit[v] & ~seen[*w];
+                if (!reached) continue;
+                seen[*w] |= reached;
+                next[*w] |= reached;
+                for (; reached; reached &= reached - 1)
+                    parents.get(first + __builtin_ctzll(reached), *w) = v;
+                active = true;
             }
         }
+        std::swap(visit, next);
+        next.fill(0);
     }
-    return {std::move(all_parents)};
+}
+
+/**
+ * All-pairs shortest paths of an unweighted graph, as the BFS trees of all
+ * the vertices. Batches of 64 roots share one bit-parallel search and the
+ * batches are spread over threads.
+ */
+template <typename G, typename V = typename G::vertex_type>
+ShortestPathsMatrix<V> find_shortest_paths(
+    const G& g, size_t threads = hardware_threads()) {
+    ShortestPathsMatrix<V> matrix(g);
+    auto index = Bfs_ns::AdjacencyIndex::out_edges(g);
+    auto count = g.vertices_count();
+    auto search = [&](auto& parents) {
+        parallel_blocks(
+            (count + 63) / 64, threads, [&](size_t, size_t b, size_t e) {
+                Array<uint64_t> seen(count), visit(count), next(count);
+                for (size_t batch = b; batch < e; ++batch)
+                    multi_source_bfs(index, batch * 64, parents, seen, visit,
+                                     next);
+            });
+    };
+    if (matrix.is_narrow())
+        search(matrix.narrow_parents());
+    else
+        search(matrix.wide_parents());
+    return matrix;
 }
 
 template <typename G>
@@ -339,17 +474,20 @@ G dfs_transitive_closure(const G& g) {
         G& m_g;
         Array<bool> m_a;
         Helper(G& g) : m_g(g), m_a(g.vertices_count()) {}
+        // the edges are added once the search is over: adding them to a
+        // vertex being iterated would invalidate its iterators
         void search() {
             for (auto& v : m_g) {
                 m_a.fill(false);
-                search(v, v, v);
+                search(v);
+                for (auto& w : m_g)
+                    if (m_a[w] && !m_g.has_edge(v, w)) m_g.add_edge(v, w);
             }
         }
-        void search(V& vv, V& v, V& w) {
+        void search(V& w) {
             if (!m_a[w]) {
                 m_a[w] = true;
-                if (!m_g.has_edge(vv, w)) m_g.add_edge(vv, w);
-                for (auto& t : w) search(vv, w, t);
+                for (auto& t : w) search(t);
             }
         }
     };
@@ -478,8 +616,8 @@ G invert(const G& g) {
 
 template <typename G>
 Array<size_t> topological_sort_rearrange(const G& g) {
-    auto inverted = invert(g);
-    PostDfs<G, size_t, size_t> d(inverted);
+    ReversedView inverted(g);
+    PostDfs<ReversedView<G>, size_t, size_t> d(inverted);
     d.search();
     return d.m_post.to_array();
 }
@@ -498,7 +636,7 @@ struct TopologicalSorter
 
 template <typename G>
 Array<size_t> topological_sort_relabel(const G& g) {
-    auto inverted = invert(g);
+    ReversedView inverted(g);
     TopologicalSorter s(inverted);
     s.search();
     return std::move(s.m_post_i);
@@ -646,6 +784,14 @@ Array<size_t> strong_components_tarjan(const G& g) {
         Array<size_t> m_ids;
         size_t m_group_id;
         Stack<const V* const> m_stack;
+        struct Frame {
+            const V* m_v;
+            typename V::const_iterator m_w;
+            size_t m_min;
+            Frame(const V& v, size_t min)
+                : m_v(&v), m_w(v.cbegin()), m_min(min) {}
+        };
+        ArrayStack<Frame> m_frames;
         Searcher(const G& g)
             : m_g(g),
               m_pre(g.vertices_count()),
@@ -656,24 +802,42 @@ Array<size_t> strong_components_tarjan(const G& g) {
             for (auto v = m_g.crbegin(); v != m_g.crend(); ++v)
                 if (m_pre.is_unset(*v)) search(*v);
         }
-        void search(const V& v) {
+        void enter(const V& v) {
             m_pre.set_next(v);
-            size_t min = m_min[v] = m_pre[v];
+            m_min[v] = m_pre[v];
             m_stack.push(&v);
-            for (auto w = v.cbegin(); w != v.cend(); ++w) {
-                if (m_pre.is_unset(*w)) search(*w);
-                if (m_min[*w] < min) min = m_min[*w];
-            }
-            if (min < m_min[v])
-                m_min[v] = min;
-            else {
-                const V* w;
-                do {
-                    w = m_stack.pop();
-                    m_ids[*w] = m_group_id;
-                    m_min[*w] = m_g.vertices_count();
-                } while (v != *w);
-                ++m_group_id;
+            m_frames.emplace(v, m_min[v]);
+        }
+        // a tree edge is revisited once its target is finished, which
+        // folds the target's min into the frame like a non-tree edge
+        void search(const V& root) {
+            enter(root);
+            while (!m_frames.empty()) {
+                auto& f = m_frames.top();
+                if (f.m_w != f.m_v->cend()) {
+                    auto& w = *f.m_w;
+                    if (m_pre.is_unset(w))
+                        enter(w);
+                    else {
+                        if (m_min[w] < f.m_min) f.m_min = m_min[w];
+                        ++f.m_w;
+                    }
+                    continue;
+                }
+                auto& v = *f.m_v;
+                size_t min = f.m_min;
+                m_frames.pop();
+                if (min < m_min[v])
+                    m_min[v] = min;
+                else {
+                    const V* w;
+                    do {
+                        w = m_stack.pop();
+                        m_ids[*w] = m_group_id;
+                        m_min[*w] = m_g.vertices_count();
+                    } while (v != *w);
+                    ++m_group_id;
+                }
             }
         }
     };
@@ -695,7 +859,7 @@ auto compose_path_tree(const G& g, const E& edges_b, const E& edges_e) {
     return mst;
 }
 
-template <typename G>
+template <template <typename, typename> class H = VertexHeap, typename G>
 auto pq_mst(const G& g) {
     using vertex_t = typename G::vertex_type;
     using w_t = typename G::edge_type::value_type;
@@ -711,14 +875,15 @@ auto pq_mst(const G& g) {
             for (auto& e : m_mst) e.m_target = nullptr;
         }
         void search(const vertex_t& v) {
-            VertexHeap<const vertex_t*, w_t> heap(m_g.vertices_count(),
-                                                  m_weights);
+            H<const vertex_t*, w_t> heap(m_g.vertices_count(), m_weights);
             heap.push(&v);
             while (!heap.empty()) {
                 const vertex_t& w = *heap.pop();
                 m_mst[w] = m_fr[w];
                 for (auto e = w.cedges_begin(); e != w.cedges_end(); ++e) {
                     const vertex_t& t = e->target();
+                    // the root has no fringe edge, but is in the tree
+                    if (&t == &v) continue;
                     w_t weight = e->edge().weight();
                     if (!m_fr[t].m_target) {
                         m_weights[t] = weight;
@@ -726,7 +891,7 @@ auto pq_mst(const G& g) {
                         m_fr[t] = *e;
                     } else if (!m_mst[t].m_target && weight < m_weights[t]) {
                         m_weights[t] = weight;
-                        heap.move_up(&w);
+                        heap.move_up(&t);
                         m_fr[t] = *e;
                     }
                 }
@@ -743,7 +908,7 @@ auto pq_mst(const G& g) {
     return compose_path_tree(g, s.m_mst.cbegin(), s.m_mst.cend());
 }
 
-template <typename G>
+template <typename G, template <typename, typename> class H = VertexHeap>
 struct Spt {
     using vertex_t = typename G::vertex_type;
     using edge_t = typename G::vertex_type::const_edges_iterator::entry_type;
@@ -755,28 +920,40 @@ struct Spt {
         : m_distance(g.vertices_count(), max_weight),
           m_spt(g.vertices_count()) {
         for (auto& e : m_spt) e.m_target = nullptr;
-        VertexHeap<const vertex_t*, weight_t> heap(g.vertices_count(),
-                                                   m_distance);
-        for (const vertex_t* v = g.cbegin(); v != g.cend(); ++v) heap.push(v);
+        // only the reached vertices enter the heap
+        H<const vertex_t*, weight_t> heap(g.vertices_count(), m_distance);
         m_distance[vertex] = 0;
-        heap.move_up(&vertex);
+        heap.push(&vertex);
         while (!heap.empty()) {
             const vertex_t* v = heap.pop();
-            if (v != &vertex && !m_spt[*v].m_target) return;
             for (auto e = v->cedges_begin(); e != v->cedges_end(); ++e) {
                 const vertex_t* w = e->m_target;
                 weight_t distance = m_distance[*v] + e->edge().weight();
                 if (m_distance[*w] > distance) {
+                    bool queued = m_spt[*w].m_target;
                     m_distance[*w] = distance;
-                    heap.move_up(w);
                     m_spt[*w] = *e;
+                    if (queued)
+                        heap.move_up(w);
+                    else
+                        heap.push(w);
                 }
             }
         }
     }
 };
 
-template <typename G>
+// true for the searches built from a reusable engine_type
+template <typename S, typename = void>
+constexpr bool has_engine_v = false;
+template <typename S>
+constexpr bool has_engine_v<S, std::void_t<typename S::engine_type>> = true;
+
+/**
+ * The shortest paths trees from every vertex, searched with S. An S with an
+ * engine_type is built from one engine, set up once for all the searches.
+ */
+template <typename G, typename S = Spt<G>>
 struct FullSpts {
     using vertex_t = typename G::vertex_type;
     using w_t = typename G::edge_type::value_type;
@@ -784,15 +961,33 @@ struct FullSpts {
     const G& m_g;
     Array<Array<w_t>> m_distances;
     Array<Array<edge_t>> m_spts;
+
+   private:
+    template <typename F>
+    void search(F spt) {
+        size_t i = 0;
+        for (auto v = m_g.cbegin(); v != m_g.cend(); ++v, ++i) {
+            S s = spt(*v);
+            m_distances[i] = std::move(s.m_distance);
+            m_spts[i] = std::move(s.m_spt);
+        }
+    }
+
+   public:
     FullSpts(const G& g, w_t max_weight)
         : m_g(g), m_distances(g.vertices_count()), m_spts(g.vertices_count()) {
-        size_t i = 0;
-        for (auto v = g.cbegin(); v != g.cend(); ++v, ++i) {
-            Spt spt(g, *v, max_weight);
-            m_distances[i] = std::move(spt.m_distance);
-            m_spts[i] = std::move(spt.m_spt);
+        if constexpr (has_engine_v<S>) {
+            typename S::engine_type engine(g);
+            search([&](const vertex_t& v) { return S(engine, v, max_weight); });
+        } else {
+            search([&](const vertex_t& v) { return S(g, v, max_weight); });
         }
     }
+    template <typename T = S, typename = typename T::engine_type>
+    FullSpts(const G& g, typename T::engine_type& engine, w_t max_weight)
+        : m_g(g), m_distances(g.vertices_count()), m_spts(g.vertices_count()) {
+        search([&](const vertex_t& v) { return S(engine, v, max_weight); });
+    }
     w_t distance(size_t v, size_t w) { return m_distances[v][w]; }
     const edge_t& path(size_t v, size_t w) { return m_spts[w][v]; }
     const edge_t& path_r(size_t v, size_t w) { return m_spts[v][w]; }
@@ -892,72 +1087,13 @@ struct DagFullSpts {
 template <typename G>
 ArrayCycle find_negative_cycle(const G& g, const typename G::vertex_type& s,
                                typename G::edge_type::value_type sentinel) {
-    using vertex_type = typename G::vertex_type;
     using w_t = typename G::edge_type::value_type;
     using edge_t = typename G::vertex_type::const_edges_iterator::entry_type;
 
-    Array<w_t> weights(g.vertices_count(), sentinel);
-    Array<edge_t> spt(g.vertices_count());
-    for (auto& s : spt) s.m_target = nullptr;
-
-    weights[s] = 0;
-
-    ForwardList<const vertex_type*> queue;
-    queue.push_back(&s);
-    queue.push_back(nullptr);
-
-    size_t n = 0;
-
-    bool completed = false;
-    while (!completed && !queue.empty()) {
-        const vertex_type* v;
-        while (!completed && (v = queue.pop_front()) == nullptr) {
-            completed = n++ > g.vertices_count();
-            if (!completed) queue.push_back(nullptr);
-        }
-        if (!completed)
-            for (auto e = v->cedges_begin(); e != v->cedges_end(); ++e) {
-                auto& w = e->target();
-                auto weight = weights[*v] + e->edge().weight();
-                if (weights[w] > weight) {
-                    weights[w] = weight;
-                    queue.push_back(&w);
-                    spt[w] = *e;
-                }
-            }
-    }
-
-    using cycle_g_type = AdjacencyLists<GraphType::DIGRAPH, int>;
-    cycle_g_type gg;
-    for (auto v = g.cbegin(); v != g.cend(); ++v) gg.create_vertex(*v);
-
-    for (auto& s : spt)
-        if (s.m_target) gg.add_edge(gg[s.source()], gg[s.target()]);
-
-    struct Searcher
-        : public PostDfsBase<cycle_g_type, size_t, size_t, Searcher> {
-        using Base = PostDfsBase<cycle_g_type, size_t, size_t, Searcher>;
-        bool m_found;
-        Array<size_t> m_cycle;
-        Searcher(const cycle_g_type& g, w_t sentinel)
-            : Base(g), m_found(false), m_cycle(g.vertices_count(), sentinel) {}
-        void search_vertex(const typename Base::vertex_type& v) {
-            if (!m_found) Base::search_vertex(v);
-        }
-        void visit_edge(const typename Base::edge_type& e) {
-            auto& v = e.source();
-            auto& w = e.target();
-            if (!m_found && Base::m_pre[w] < Base::m_pre[v] &&
-                Base::m_post.is_unset(w))
-                m_found = true;
-            if (m_found) m_cycle[v] = w;
-        }
-    };
-    Searcher searcher(gg, sentinel);
-    searcher.search();
-    if (searcher.m_found)
-        return {std::move(searcher.m_cycle), static_cast<size_t>(sentinel)};
-    return {{}, static_cast<size_t>(sentinel)};
+    BellmanFord<w_t, edge_t> bellman_ford(g.vertices_count(), sentinel);
+    bellman_ford.add_source(s);
+    bellman_ford.search(edge_arcs(g));
+    return bellman_ford.negative_cycle();
 }
 
 }  // namespace Graph
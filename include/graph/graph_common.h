@@ -1,5 +1,8 @@
 #pragma once
 
+#include <type_traits>
+#include <utility>
+
 #include "array.h"
 #include "heap.h"
 
@@ -7,6 +10,27 @@ namespace Graph {
 
 enum class GraphType { GRAPH, DIGRAPH };
 
+/**
+ * Graph type of the graph classes whose first template parameter is the
+ * GraphType, found through their bases too. Only used in decltype.
+ */
+template <template <GraphType, typename...> class G, GraphType T_graph_type,
+          typename... Args>
+std::integral_constant<GraphType, T_graph_type> graph_type_of(
+    const G<T_graph_type, Args...>&);
+
+/**
+ * True for the undirected graphs, which store every edge in both
+ * directions; graphs of unknown type are taken as directed.
+ */
+template <typename G, typename = void>
+constexpr bool is_undirected_v = false;
+template <typename G>
+constexpr bool is_undirected_v<
+    G, std::void_t<decltype(graph_type_of(std::declval<const G&>()))>> =
+    decltype(graph_type_of(std::declval<const G&>()))::value ==
+    GraphType::GRAPH;
+
 template <typename T>
 class VertexBase {
    protected:
@@ -34,7 +58,7 @@ class EdgesIteratorEntry {
 
     vertex_type* m_source;
     vertex_type* m_target;  // todo delete
-    edge_type* m_edge;
+    edge_type* m_edge = nullptr;
 
     EdgesIteratorEntry() = default;
     EdgesIteratorEntry(vertex_type* source) : m_source(source) {}
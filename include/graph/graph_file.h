@@ -0,0 +1,363 @@
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include "csr.h"
+#include "network_flow.h"
+
+namespace Graph {
+
+class GraphFileException : public std::runtime_error {
+   public:
+    explicit GraphFileException(const std::string& message)
+        : std::runtime_error("graph file: " + message) {}
+};
+
+/**
+ * What opening a graph file checks: everything, or for trusted files, e.g.
+ * ones just written by write_graph_file, only the header and the section
+ * bounds.
+ */
+enum class FileCheck { FULL, HEADER };
+
+namespace Graph_file_ns {
+
+static_assert(sizeof(size_t) == sizeof(uint64_t),
+              "offsets and targets are mapped as 64-bit integers");
+
+/**
+ * File layout: the header, then the CSR offsets (vertices_count + 1), the
+ * targets and the edges (edges_count each) and the vertex values. Every
+ * section starts at a multiple of section_alignment and holds the in-memory
+ * representation of its elements, so opening a file is a single mmap.
+ */
+struct Header {
+    static const constexpr char magic_value[8] = {'G', 'R', 'A', 'P',
+                                                  'H', 'C', 'S', 'R'};
+    static const constexpr uint32_t current_version = 1;
+
+    char m_magic[8];
+    uint32_t m_version;
+    uint32_t m_graph_type;
+    uint64_t m_vertices_count;
+    uint64_t m_edges_count;
+    uint64_t m_value_size;
+    uint64_t m_edge_size;
+    uint64_t m_offsets_position;
+    uint64_t m_targets_position;
+    uint64_t m_edges_position;
+    uint64_t m_values_position;
+    uint64_t m_file_size;
+};
+
+static const constexpr size_t section_alignment = 64;
+
+inline uint64_t align_section(uint64_t position) {
+    return (position + section_alignment - 1) / section_alignment *
+           section_alignment;
+}
+
+/**
+ * Read-only mapping of a whole file: pages are loaded on first touch.
+ */
+class MappedFile {
+   private:
+    void* m_data;
+    size_t m_size;
+
+   public:
+    MappedFile() : m_data(nullptr), m_size(0) {}
+    explicit MappedFile(const std::string& path) : MappedFile() {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw GraphFileException("cannot open " + path);
+        struct stat st;
+        if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+            m_size = st.st_size;
+            m_data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+        ::close(fd);
+        if (m_data == nullptr || m_data == MAP_FAILED) {
+            m_data = nullptr;
+            throw GraphFileException("cannot map " + path);
+        }
+    }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& o) : MappedFile() { *this = std::move(o); }
+    MappedFile& operator=(MappedFile&& o) {
+        std::swap(m_data, o.m_data);
+        std::swap(m_size, o.m_size);
+        return *this;
+    }
+    ~MappedFile() {
+        if (m_data) ::munmap(m_data, m_size);
+    }
+
+    size_t size() const { return m_size; }
+    template <typename T>
+    const T* at(uint64_t position) const {
+        return reinterpret_cast<const T*>(static_cast<const char*>(m_data) +
+                                          position);
+    }
+};
+
+// a section of count elements of size bytes, aligned and inside the file
+inline void check_section(const MappedFile& file, uint64_t position,
+                          uint64_t count, uint64_t size,
+                          const std::string& path) {
+    if (position % section_alignment != 0 || position > file.size() ||
+        count > (file.size() - position) / size)
+        throw GraphFileException("corrupt section in " + path);
+}
+
+class Writer {
+   private:
+    std::ofstream m_stream;
+    uint64_t m_position;
+
+   public:
+    explicit Writer(const std::string& path)
+        : m_stream(path, std::ios::binary | std::ios::trunc), m_position(0) {
+        if (!m_stream) throw GraphFileException("cannot create " + path);
+    }
+    template <typename T>
+    void write(const T& t) {
+        m_stream.write(reinterpret_cast<const char*>(&t), sizeof(T));
+        m_position += sizeof(T);
+    }
+    void pad_to(uint64_t position) {
+        for (; m_position < position; ++m_position) m_stream.put(0);
+    }
+    void close() {
+        m_stream.close();
+        if (!m_stream) throw GraphFileException("write failed");
+    }
+};
+
+/**
+ * Writes g, passing every edge through freeze(v, edge entry, E& out), which
+ * returns false for the edges which are not stored.
+ */
+template <typename E, GraphType T_graph_type, typename G, typename F>
+void write_file(const G& g, const std::string& path, F freeze) {
+    using value_type = typename G::vertex_type::value_type;
+    static_assert(std::is_trivially_copyable_v<value_type> &&
+                      std::is_trivially_copyable_v<E>,
+                  "mapped values and edges must be trivially copyable");
+    auto count = g.vertices_count();
+    Array<size_t> offsets(count + 1);
+    size_t p = 0;
+    E edge;
+    for (auto v = g.cbegin(); v != g.cend(); ++v) {
+        offsets[*v] = p;
+        for (auto e = v->cedges_begin(); e != v->cedges_end(); ++e)
+            if (freeze(*v, *e, edge)) ++p;
+    }
+    offsets[count] = p;
+
+    Header h;
+    std::memcpy(h.m_magic, Header::magic_value, sizeof(h.m_magic));
+    h.m_version = Header::current_version;
+    h.m_graph_type = static_cast<uint32_t>(T_graph_type);
+    h.m_vertices_count = count;
+    h.m_edges_count = p;
+    h.m_value_size = sizeof(value_type);
+    h.m_edge_size = sizeof(E);
+    h.m_offsets_position = align_section(sizeof(Header));
+    h.m_targets_position =
+        align_section(h.m_offsets_position + (count + 1) * sizeof(size_t));
+    h.m_edges_position =
+        align_section(h.m_targets_position + p * sizeof(size_t));
+    h.m_values_position = align_section(h.m_edges_position + p * sizeof(E));
+    h.m_file_size = h.m_values_position + count * sizeof(value_type);
+
+    Writer w(path);
+    w.write(h);
+    w.pad_to(h.m_offsets_position);
+    for (auto o = offsets.cbegin(); o != offsets.cend(); ++o) w.write(*o);
+    w.pad_to(h.m_targets_position);
+    for (auto v = g.cbegin(); v != g.cend(); ++v)
+        for (auto e = v->cedges_begin(); e != v->cedges_end(); ++e)
+            if (freeze(*v, *e, edge)) w.write(size_t(e->target()));
+    w.pad_to(h.m_edges_position);
+    for (auto v = g.cbegin(); v != g.cend(); ++v)
+        for (auto e = v->cedges_begin(); e != v->cedges_end(); ++e)
+            if (freeze(*v, *e, edge)) w.write(edge);
+    w.pad_to(h.m_values_position);
+    for (auto v = g.cbegin(); v != g.cend(); ++v) w.write(v->value());
+    w.close();
+}
+
+/**
+ * Read-only CSR graph over a mapped file. Offsets, targets and edges are
+ * used in place; only the vertex objects are created and given their
+ * values. The header and the sections are always checked to lie in the
+ * file. By default the offsets are also checked to be sorted and the
+ * targets to be vertices, an O(V + E) scan; FileCheck::HEADER skips it and
+ * opens in O(V), leaving a corrupt edge section undefined behaviour. Every
+ * failed check throws GraphFileException.
+ *
+ * The mapping is read-only, and so is the graph: it only offers const
+ * vertices and edges, read in place. detach() gives an owning Csr copy,
+ * which can be changed.
+ */
+template <GraphType T_graph_type, typename V>
+class MappedCsr : protected Csr_ns::CsrBase<T_graph_type, V> {
+   private:
+    using Base = Csr_ns::CsrBase<T_graph_type, V>;
+    MappedFile m_file;
+
+   public:
+    using vertex_type = typename Base::vertex_type;
+    using edge_type = typename Base::edge_type;
+    using value_type = typename vertex_type::value_type;
+    using csr_type = Csr_ns::Csr<T_graph_type, V>;
+
+    explicit MappedCsr(const std::string& path,
+                       FileCheck check = FileCheck::FULL)
+        : m_file(path) {
+        if (m_file.size() < sizeof(Header))
+            throw GraphFileException("truncated header in " + path);
+        auto& h = *m_file.at<const Header>(0);
+        if (std::memcmp(h.m_magic, Header::magic_value, sizeof(h.m_magic)))
+            throw GraphFileException("bad magic in " + path);
+        if (h.m_version != Header::current_version)
+            throw GraphFileException("unsupported version in " + path);
+        if (h.m_graph_type != static_cast<uint32_t>(T_graph_type) ||
+            h.m_value_size != sizeof(value_type) ||
+            h.m_edge_size != sizeof(edge_type))
+            throw GraphFileException("graph type mismatch in " + path);
+        if (m_file.size() < h.m_file_size)
+            throw GraphFileException("truncated " + path);
+
+        size_t count = h.m_vertices_count;
+        size_t edges_count = h.m_edges_count;
+        if (count >= m_file.size() / sizeof(size_t))
+            throw GraphFileException("corrupt vertices count in " + path);
+        check_section(m_file, h.m_offsets_position, count + 1, sizeof(size_t),
+                      path);
+        check_section(m_file, h.m_targets_position, edges_count,
+                      sizeof(size_t), path);
+        check_section(m_file, h.m_edges_position, edges_count,
+                      sizeof(edge_type), path);
+        check_section(m_file, h.m_values_position, count, sizeof(value_type),
+                      path);
+
+        auto offsets = m_file.at<size_t>(h.m_offsets_position);
+        auto targets = m_file.at<size_t>(h.m_targets_position);
+        if (offsets[0] != 0 || offsets[count] != edges_count)
+            throw GraphFileException("corrupt offsets in " + path);
+        if (check == FileCheck::FULL) {
+            for (size_t v = 0; v < count; ++v)
+                if (offsets[v + 1] < offsets[v])
+                    throw GraphFileException("corrupt offsets in " + path);
+            for (size_t e = 0; e < edges_count; ++e)
+                if (targets[e] >= count)
+                    throw GraphFileException("corrupt target in " + path);
+        }
+
+        Base::m_offsets = Csr_ns::CsrArray<size_t>(offsets, count + 1);
+        Base::m_targets = Csr_ns::CsrArray<size_t>(targets, edges_count);
+        Base::m_edges = Csr_ns::CsrArray<edge_type>(
+            m_file.at<edge_type>(h.m_edges_position), edges_count);
+        Base::m_vertices = Array<vertex_type>(count);
+        Base::update_vertices_this_link();
+        auto values = m_file.at<value_type>(h.m_values_position);
+        for (size_t v = 0; v < count; ++v)
+            Base::m_vertices[v].set_value(values[v]);
+    }
+    MappedCsr(MappedCsr&&) = default;
+    MappedCsr& operator=(MappedCsr&&) = default;
+
+    using Base::edges_count;
+    using Base::has_edge;
+    using Base::vertices_count;
+
+    const vertex_type& operator[](size_t index) const {
+        return Base::operator[](index);
+    }
+    const edge_type* get_edge(const vertex_type& v,
+                              const vertex_type& w) const {
+        return v.get_edge(w);
+    }
+
+    auto cbegin() const { return Base::cbegin(); }
+    auto cend() const { return Base::cend(); }
+    auto crbegin() const { return Base::crbegin(); }
+    auto crend() const { return Base::crend(); }
+
+    csr_type detach() const {
+        return csr_type(static_cast<const Base&>(*this));
+    }
+    // the storage, const as well
+    const Base& csr() const { return *this; }
+};
+
+}  // namespace Graph_file_ns
+
+template <GraphType T_graph_type, typename V, typename TE = bool,
+          typename E = Adjacency_lists_ns::Edge<TE>>
+using MappedGraph =
+    Graph_file_ns::MappedCsr<T_graph_type, Csr_ns::Vertex<T_graph_type, V, E>>;
+
+/**
+ * Saves the adjacency lists in the order they are stored, so a mapped graph
+ * traverses exactly like the source one.
+ */
+template <GraphType T_graph_type, typename V>
+void write_graph_file(
+    const Adjacency_lists_ns::AdjacencyLists<T_graph_type, V>& g,
+    const std::string& path) {
+    using E = typename V::edge_type;
+    Graph_file_ns::write_file<E, T_graph_type>(
+        g, path, [](const V&, const auto& e, E& edge) {
+            edge = Csr_ns::EdgeFreezer<E>::freeze(e);
+            return true;
+        });
+}
+
+template <GraphType T_graph_type, typename V>
+void write_graph_file(const Csr_ns::CsrBase<T_graph_type, V>& g,
+                      const std::string& path) {
+    using E = typename V::edge_type;
+    Graph_file_ns::write_file<E, T_graph_type>(
+        g, path, [](const V&, const auto& e, E& edge) {
+            edge = e.edge();
+            return true;
+        });
+}
+
+template <GraphType T_graph_type, typename V>
+void write_graph_file(const Graph_file_ns::MappedCsr<T_graph_type, V>& g,
+                      const std::string& path) {
+    write_graph_file(g.csr(), path);
+}
+
+/**
+ * A flow network is saved as the digraph of its links with their capacities
+ * and current flows; open it as MappedGraph<DIGRAPH, V, C, FlowEdge<C>>.
+ */
+template <typename V, typename C>
+void write_graph_file(const NetworkFlow<V, C>& g, const std::string& path) {
+    using E = Adjacency_lists_ns::FlowEdge<C>;
+    using vertex_type = typename NetworkFlow<V, C>::vertex_type;
+    Graph_file_ns::write_file<E, GraphType::DIGRAPH>(
+        g, path, [](const vertex_type& v, const auto& e, E& edge) {
+            auto link = e.edge().link();
+            if (!link->is_from(v)) return false;
+            edge = E(link->cap(), link->flow());
+            return true;
+        });
+}
+
+}  // namespace Graph
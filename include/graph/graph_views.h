@@ -0,0 +1,316 @@
+#pragma once
+
+#include <iostream>
+#include <mutex>
+#include <type_traits>
+
+#include "array.h"
+#include "graph_common.h"
+
+namespace Graph {
+
+namespace Views_ns {
+
+template <typename G>
+using base_entry_t =
+    typename G::vertex_type::const_edges_iterator::entry_type;
+template <typename G>
+using link_t = std::remove_const_t<typename base_entry_t<G>::edge_type>;
+
+template <typename G, typename D>
+class ViewBase;
+
+/**
+ * A vertex of the view P, standing for a vertex of the underlying graph with
+ * the arcs P lets through. P walks the arcs of its vertex v with a cursor:
+ * first(v) and last(v) bound them, next(v, c) moves to the next arc shown,
+ * target(c) is the view index of the head and link(c) the underlying edge.
+ */
+template <typename P>
+class ViewVertex {
+   public:
+    using base_vertex_type = typename P::base_vertex_type;
+    using value_type = typename base_vertex_type::value_type;
+    using edge_type = typename P::edge_type;
+
+   private:
+    template <bool T_is_const>
+    class Iterator;
+    template <bool T_is_const>
+    class Edges_iterator;
+    friend P;
+    friend ViewBase<typename P::graph_type, P>;
+
+    const P* m_view;
+    const base_vertex_type* m_base;
+    size_t m_index;
+
+    void set(const P* view, const base_vertex_type* base, size_t index) {
+        m_view = view;
+        m_base = base;
+        m_index = index;
+    }
+
+   public:
+    using const_iterator = Iterator<true>;
+    using const_edges_iterator = Edges_iterator<true>;
+
+    ViewVertex() : m_view(nullptr), m_base(nullptr), m_index(0) {}
+
+    size_t index() const { return m_index; }
+    operator size_t() const { return m_index; }
+    const base_vertex_type& base() const { return *m_base; }
+    const value_type& value() const { return m_base->value(); }
+    bool operator==(const ViewVertex& o) const { return this == &o; }
+    bool operator!=(const ViewVertex& o) const { return !operator==(o); }
+    friend std::ostream& operator<<(std::ostream& stream, const ViewVertex& v) {
+        return stream << *v.m_base;
+    }
+
+    const_iterator cbegin() const { return {this, m_view->first(m_index)}; }
+    const_iterator cend() const { return {this, m_view->last(m_index)}; }
+    const_edges_iterator cedges_begin() const {
+        return {this, m_view->first(m_index)};
+    }
+    const_edges_iterator cedges_end() const {
+        return {this, m_view->last(m_index)};
+    }
+};
+
+template <typename P>
+template <bool T_is_const>
+class ViewVertex<P>::Iterator {
+   protected:
+    using cursor_type = typename P::cursor_type;
+    const ViewVertex* m_vertex;
+    cursor_type m_cursor;
+
+   public:
+    Iterator(const ViewVertex* vertex, const cursor_type& cursor)
+        : m_vertex(vertex), m_cursor(cursor) {}
+    Iterator& operator++() {
+        m_vertex->m_view->next(m_vertex->m_index, m_cursor);
+        return *this;
+    }
+    bool operator==(const Iterator& o) const { return m_cursor == o.m_cursor; }
+    bool operator!=(const Iterator& o) const { return !operator==(o); }
+    const ViewVertex& operator*() const {
+        auto view = m_vertex->m_view;
+        return (*view)[view->target(m_cursor)];
+    }
+    const ViewVertex* operator->() const { return &operator*(); }
+};
+
+template <typename P>
+template <bool T_is_const>
+class ViewVertex<P>::Edges_iterator : public Iterator<T_is_const> {
+   private:
+    using Base = Iterator<T_is_const>;
+
+   public:
+    using entry_type =
+        EdgesIteratorEntry<ViewVertex, link_t<typename P::graph_type>, true>;
+
+   private:
+    entry_type m_entry;
+
+    void update_entry() {
+        auto view = Base::m_vertex->m_view;
+        if (Base::m_cursor == view->last(Base::m_vertex->m_index)) return;
+        m_entry.m_target = &(*view)[view->target(Base::m_cursor)];
+        m_entry.m_edge = view->link(Base::m_cursor);
+    }
+
+   public:
+    Edges_iterator(const ViewVertex* vertex,
+                   const typename Base::cursor_type& cursor)
+        : Base(vertex, cursor), m_entry(vertex) {
+        update_entry();
+    }
+    const entry_type& operator*() const { return m_entry; }
+    const entry_type* operator->() const { return &m_entry; }
+    Edges_iterator& operator++() {
+        Base::operator++();
+        update_entry();
+        return *this;
+    }
+};
+
+/**
+ * The vertices of a view over G, one ViewVertex per vertex shown. Views
+ * only refer to the graph, which must outlive them and stay unchanged, and
+ * are not copied, as their vertices point to them.
+ */
+template <typename G, typename D>
+class ViewBase {
+   public:
+    using graph_type = G;
+    using vertex_type = ViewVertex<D>;
+    using edge_type = typename G::edge_type;
+    using base_vertex_type = typename G::vertex_type;
+
+   protected:
+    const G& m_g;
+    Array<vertex_type> m_vertices;
+
+    // shows the vertices of g listed, in that order
+    template <typename F>
+    ViewBase(const G& g, size_t count, F base_index)
+        : m_g(g), m_vertices(count) {
+        for (size_t i = 0; i < count; ++i)
+            m_vertices[i].set(static_cast<const D*>(this), &g[base_index(i)],
+                              i);
+    }
+    explicit ViewBase(const G& g)
+        : ViewBase(g, g.vertices_count(), [](size_t i) { return i; }) {}
+
+   public:
+    ViewBase(const ViewBase&) = delete;
+    ViewBase& operator=(const ViewBase&) = delete;
+
+    const G& base() const { return m_g; }
+    size_t vertices_count() const { return m_vertices.size(); }
+    const vertex_type& operator[](size_t index) const {
+        return m_vertices[index];
+    }
+    auto cbegin() const { return m_vertices.cbegin(); }
+    auto cend() const { return m_vertices.cend(); }
+    auto crbegin() const { return m_vertices.crbegin(); }
+    auto crend() const { return m_vertices.crend(); }
+};
+
+}  // namespace Views_ns
+
+/**
+ * G with every edge reversed, for the searches of invert(g) without the
+ * copy. The edges entering every vertex are indexed on the first walk, in
+ * the order of their sources as invert() adds them, and kept: the view
+ * costs O(V) until walked, O(V + E) after.
+ */
+template <typename G>
+class ReversedView : public Views_ns::ViewBase<G, ReversedView<G>> {
+   private:
+    using Base = Views_ns::ViewBase<G, ReversedView<G>>;
+    using link_type = Views_ns::link_t<G>;
+    friend typename Base::vertex_type;
+
+    struct InArc {
+        size_t m_source;
+        const link_type* m_link;
+    };
+    mutable std::once_flag m_indexed;
+    mutable Array<size_t> m_offsets;
+    mutable Array<InArc> m_arcs;
+
+    void index() const {
+        std::call_once(m_indexed, [this] {
+            auto& g = Base::m_g;
+            auto count = g.vertices_count();
+            m_offsets = Array<size_t>(count + 1, 0);
+            for (auto v = g.cbegin(); v != g.cend(); ++v)
+                for (auto w = v->cbegin(); w != v->cend(); ++w)
+                    ++m_offsets[size_t(*w) + 1];
+            for (size_t v = 0; v < count; ++v) m_offsets[v + 1] += m_offsets[v];
+            m_arcs = Array<InArc>(m_offsets[count]);
+            Array<size_t> next(count);
+            for (size_t v = 0; v < count; ++v) next[v] = m_offsets[v];
+            for (auto v = g.cbegin(); v != g.cend(); ++v)
+                for (auto e = v->cedges_begin(); e != v->cedges_end(); ++e)
+                    m_arcs[next[e->target()]++] = {size_t(*v), e->m_edge};
+        });
+    }
+
+    using cursor_type = size_t;
+    cursor_type first(size_t v) const {
+        index();
+        return m_offsets[v];
+    }
+    cursor_type last(size_t v) const {
+        index();
+        return m_offsets[v + 1];
+    }
+    void next(size_t, cursor_type& c) const { ++c; }
+    size_t target(cursor_type c) const { return m_arcs[c].m_source; }
+    const link_type* link(cursor_type c) const { return m_arcs[c].m_link; }
+
+   public:
+    explicit ReversedView(const G& g) : Base(g) {}
+};
+
+/**
+ * G without the edges failing the predicate F, called with the entries of
+ * the underlying edge iterators. Nothing is stored but the vertices: the
+ * edges are tested on every walk.
+ */
+template <typename G, typename F>
+class FilteredView : public Views_ns::ViewBase<G, FilteredView<G, F>> {
+   private:
+    using Base = Views_ns::ViewBase<G, FilteredView<G, F>>;
+    friend typename Base::vertex_type;
+
+    F m_f;
+
+    using cursor_type = typename G::vertex_type::const_edges_iterator;
+    void skip(size_t v, cursor_type& c) const {
+        for (auto end = Base::m_g[v].cedges_end(); c != end && !m_f(*c); ++c) {
+        }
+    }
+    cursor_type first(size_t v) const {
+        auto c = Base::m_g[v].cedges_begin();
+        skip(v, c);
+        return c;
+    }
+    cursor_type last(size_t v) const { return Base::m_g[v].cedges_end(); }
+    void next(size_t v, cursor_type& c) const { skip(v, ++c); }
+    size_t target(const cursor_type& c) const { return c->target(); }
+    auto link(const cursor_type& c) const { return c->m_edge; }
+
+   public:
+    FilteredView(const G& g, F f) : Base(g), m_f(f) {}
+};
+
+/**
+ * The subgraph of G induced by the vertices listed, numbered in the order
+ * of the list. Every walk skips the edges leaving the subset.
+ */
+template <typename G>
+class SubsetView : public Views_ns::ViewBase<G, SubsetView<G>> {
+   private:
+    using Base = Views_ns::ViewBase<G, SubsetView<G>>;
+    friend typename Base::vertex_type;
+    static const constexpr size_t none = -1;
+
+    // the view index of every vertex of G, none outside
+    Array<size_t> m_index;
+
+    using cursor_type = typename G::vertex_type::const_edges_iterator;
+    const typename G::vertex_type& base_vertex(size_t v) const {
+        return Base::m_vertices[v].base();
+    }
+    void skip(size_t v, cursor_type& c) const {
+        for (auto end = base_vertex(v).cedges_end();
+             c != end && m_index[c->target()] == none; ++c) {
+        }
+    }
+    cursor_type first(size_t v) const {
+        auto c = base_vertex(v).cedges_begin();
+        skip(v, c);
+        return c;
+    }
+    cursor_type last(size_t v) const { return base_vertex(v).cedges_end(); }
+    void next(size_t v, cursor_type& c) const { skip(v, ++c); }
+    size_t target(const cursor_type& c) const {
+        return m_index[c->target()];
+    }
+    auto link(const cursor_type& c) const { return c->m_edge; }
+
+   public:
+    SubsetView(const G& g, const Array<size_t>& vertices)
+        : Base(g, vertices.size(),
+               [&vertices](size_t i) { return vertices[i]; }),
+          m_index(g.vertices_count(), none) {
+        for (size_t i = 0; i < vertices.size(); ++i) m_index[vertices[i]] = i;
+    }
+};
+
+}  // namespace Graph
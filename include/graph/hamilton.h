@@ -0,0 +1,453 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "array.h"
+#include "bfs.h"
+#include "graph_common.h"
+#include "parallel.h"
+#include "vector.h"
+
+namespace Graph {
+
+namespace Hamilton_ns {
+
+static const constexpr size_t held_karp_max_vertices = 28;
+// hamilton_path runs Held-Karp up to here, where its table takes 2 MB
+static const constexpr size_t held_karp_dispatch_vertices = 20;
+
+class TooManyVerticesException : public std::invalid_argument {
+   public:
+    TooManyVerticesException()
+        : std::invalid_argument("Held-Karp takes at most " +
+                                std::to_string(held_karp_max_vertices) +
+                                " vertices") {}
+};
+
+template <typename G, typename V = typename G::vertex_type>
+Array<const V*> trivial_path(const G& g) {
+    if (g.vertices_count() < 1) return {};
+    return {&g[0]};
+}
+
+}  // namespace Hamilton_ns
+
+/**
+ * Held-Karp dynamic programming for a Hamilton path from s to t, over
+ * graphs of at most Hamilton_ns::held_karp_max_vertices vertices. Row m of
+ * the table is the set of the vertices ending a path from s through exactly
+ * the vertices of m, as a bit mask: w ends one when the mask of the
+ * predecessors of w meets the row of m without w. The table takes
+ * 2^(V - 1) words, as s is in every path. Larger graphs throw
+ * Hamilton_ns::TooManyVerticesException.
+ */
+template <typename G, typename V = typename G::vertex_type>
+Array<const V*> held_karp_hamilton_path(const G& g, const V& s, const V& t) {
+    using mask_t = uint32_t;
+    auto n = g.vertices_count();
+    if (n > Hamilton_ns::held_karp_max_vertices)
+        throw Hamilton_ns::TooManyVerticesException();
+    if (n < 2) return Hamilton_ns::trivial_path(g);
+    if (s == t) return {};
+    size_t source = s;
+    // the bits of the vertices but s
+    auto bit = [source](size_t v) { return v < source ? v : v - 1; };
+    auto vertex = [source](size_t b) { return b < source ? b : b + 1; };
+
+    auto m = n - 1;
+    Array<mask_t> predecessors(m, 0);
+    mask_t first = 0;
+    for (auto v = g.cbegin(); v != g.cend(); ++v)
+        for (auto w = v->cbegin(); w != v->cend(); ++w) {
+            if (size_t(*w) == source) continue;
+            if (size_t(*v) == source)
+                first |= mask_t(1) << bit(*w);
+            else
+                predecessors[bit(*w)] |= mask_t(1) << bit(*v);
+        }
+
+    mask_t full = (mask_t(1) << (m - 1) << 1) - 1;
+    Array<mask_t> ends(size_t(full) + 1);
+    ends[0] = 0;
+    for (mask_t mask = 1; mask <= full && mask != 0; ++mask) {
+        if ((mask & (mask - 1)) == 0) {
+            ends[mask] = mask & first;
+            continue;
+        }
+        mask_t row = 0;
+        for (auto bits = mask; bits; bits &= bits - 1) {
+            auto w = mask_t(__builtin_ctz(bits));
+            if (predecessors[w] & ends[mask ^ mask_t(1) << w])
+                row |= mask_t(1) << w;
+        }
+        ends[mask] = row;
+    }
+
+    auto w = mask_t(bit(t));
+    if (!(ends[full] >> w & 1)) return {};
+    Array<const V*> path(n);
+    path[0] = &s;
+    auto mask = full;
+    for (auto i = n - 1; i > 0; --i) {
+        path[i] = &g[vertex(w)];
+        mask ^= mask_t(1) << w;
+        if (mask) w = mask_t(__builtin_ctz(predecessors[w] & ends[mask]));
+    }
+    return path;
+}
+
+/**
+ * Branch and bound search for a Hamilton path from s to t, for the graphs
+ * too large for held_karp_hamilton_path. A step is cut when it leaves
+ * - a vertex without an unvisited successor, or without an unvisited or
+ *   current predecessor (for undirected graphs, with fewer than two such
+ *   incident edges, so parallel edges and self loops weaken the cut),
+ * - or an unvisited vertex unreachable from the current one through
+ *   unvisited vertices.
+ * Successors with the fewest ways in are tried first (Warnsdorff).
+ *
+ * Threads search path prefixes from their own deques, and steal the oldest
+ * prefixes, the largest subtrees, from the others. A busy thread seeing an
+ * idle one gives away the untried steps of its shallowest branch. Idle
+ * threads sleep until a prefix is published or the search ends.
+ */
+template <typename G>
+class HamiltonSearch {
+   public:
+    using vertex_t = typename G::vertex_type;
+
+   private:
+    const G& m_g;
+    Bfs_ns::AdjacencyIndex m_out;
+    Bfs_ns::AdjacencyIndex m_in;
+    size_t m_source;
+    size_t m_target;
+
+    std::atomic<bool> m_found;
+    // the prefixes published and not searched through, not taken yet
+    std::atomic<size_t> m_pending;
+    std::atomic<size_t> m_queued;
+    std::atomic<size_t> m_idle;
+    std::mutex m_wake_mutex;
+    std::condition_variable m_wake;
+    std::mutex m_result_mutex;
+    Array<size_t> m_result;
+
+    struct Deque {
+        std::mutex m_mutex;
+        std::deque<Vector<size_t>> m_prefixes;
+    };
+    Array<Deque> m_deques;
+
+    const Bfs_ns::AdjacencyIndex& in() const {
+        return is_undirected_v<G> ? m_out : m_in;
+    }
+
+    class Worker {
+       private:
+        HamiltonSearch& m_search;
+        size_t m_id;
+        Array<char> m_visited;
+        // unvisited or current predecessors, unvisited successors
+        Array<size_t> m_in_count;
+        Array<size_t> m_out_count;
+        Array<size_t> m_path;
+        size_t m_length = 0;
+        // the steps by depth, untried from m_next[depth]
+        Array<Vector<size_t>> m_steps;
+        Array<size_t> m_next;
+        Array<size_t> m_marks;
+        Vector<size_t> m_queue;
+        size_t m_stamp = 0;
+
+        size_t count() const { return m_visited.size(); }
+        size_t remaining() const { return count() - m_length; }
+        size_t head() const { return m_path[m_length - 1]; }
+
+        bool viable(size_t x) const {
+            if (m_visited[x]) return true;
+            if (is_undirected_v<G>)
+                return m_in_count[x] >= (x == m_search.m_target ? 1 : 2);
+            return m_in_count[x] >= 1 &&
+                   (x == m_search.m_target || m_out_count[x] >= 1);
+        }
+
+        // whether the head reaches the unvisited vertices through unvisited
+        // vertices
+        bool connected() {
+            ++m_stamp;
+            m_queue.clear();
+            m_queue.push_back(head());
+            auto& out = m_search.m_out;
+            for (size_t i = 0; i < m_queue.size(); ++i) {
+                auto v = m_queue[i];
+                for (auto w = out.cbegin(v); w != out.cend(v); ++w)
+                    if (!m_visited[*w] && m_marks[*w] != m_stamp) {
+                        m_marks[*w] = m_stamp;
+                        m_queue.push_back(*w);
+                    }
+            }
+            return m_queue.size() - 1 == remaining();
+        }
+
+        // moves the head to w, false when the step is cut
+        bool advance(size_t w) {
+            auto v = head();
+            m_visited[w] = 1;
+            m_path[m_length++] = w;
+            auto& out = m_search.m_out;
+            auto& in = m_search.in();
+            bool viable = true;
+            for (auto y = out.cbegin(v); y != out.cend(v); ++y) {
+                --m_in_count[*y];
+                viable = viable && this->viable(*y);
+            }
+            for (auto u = in.cbegin(w); u != in.cend(w); ++u) {
+                --m_out_count[*u];
+                viable = viable && this->viable(*u);
+            }
+            return viable && (remaining() == 0 || connected());
+        }
+        void retreat() {
+            auto w = m_path[--m_length];
+            auto v = head();
+            auto& out = m_search.m_out;
+            auto& in = m_search.in();
+            for (auto y = out.cbegin(v); y != out.cend(v); ++y)
+                ++m_in_count[*y];
+            for (auto u = in.cbegin(w); u != in.cend(w); ++u) ++m_out_count[*u];
+            m_visited[w] = 0;
+        }
+
+        void list_steps() {
+            auto depth = m_length - 1;
+            auto& steps = m_steps[depth];
+            steps.clear();
+            m_next[depth] = 0;
+            auto& out = m_search.m_out;
+            auto target = m_search.m_target;
+            for (auto w = out.cbegin(head()); w != out.cend(head()); ++w)
+                if (!m_visited[*w] && (*w != target || remaining() == 1))
+                    steps.push_back(*w);
+            // the most constrained first
+            std::sort(steps.begin(), steps.end(), [this](size_t a, size_t b) {
+                return m_in_count[a] < m_in_count[b];
+            });
+        }
+
+        // false when the prefix can't be completed
+        bool reset(const Vector<size_t>& prefix) {
+            auto& out = m_search.m_out;
+            auto& in = m_search.in();
+            m_visited.fill(0);
+            for (size_t v = 0; v < count(); ++v) {
+                m_in_count[v] = in.degree(v);
+                m_out_count[v] = out.degree(v);
+            }
+            auto s = prefix[0];
+            m_visited[s] = 1;
+            m_path[0] = s;
+            m_length = 1;
+            for (auto u = in.cbegin(s); u != in.cend(s); ++u) --m_out_count[*u];
+            for (size_t i = 1; i < prefix.size(); ++i) advance(prefix[i]);
+            for (size_t v = 0; v < count(); ++v)
+                if (!viable(v)) return false;
+            return remaining() == 0 || connected();
+        }
+
+        // gives the untried steps of the shallowest branch away
+        void share(size_t base) {
+            for (auto depth = base; depth + 1 < m_length; ++depth) {
+                auto& steps = m_steps[depth];
+                if (m_next[depth] == steps.size()) continue;
+                Vector<size_t> prefix;
+                for (size_t i = 0; i <= depth; ++i) prefix.push_back(m_path[i]);
+                Vector<size_t> tried;
+                for (size_t i = 0; i < steps.size(); ++i) {
+                    if (i < m_next[depth]) {
+                        tried.push_back(steps[i]);
+                        continue;
+                    }
+                    auto task = prefix;
+                    task.push_back(steps[i]);
+                    m_search.publish(m_id, std::move(task));
+                }
+                steps = std::move(tried);
+                return;
+            }
+        }
+
+       public:
+        Worker(HamiltonSearch& search, size_t id, size_t count)
+            : m_search(search),
+              m_id(id),
+              m_visited(count),
+              m_in_count(count),
+              m_out_count(count),
+              m_path(count),
+              m_steps(count),
+              m_next(count),
+              m_marks(count, 0) {}
+
+        void run(const Vector<size_t>& prefix) {
+            if (!reset(prefix)) return;
+            auto base = m_length - 1;
+            list_steps();
+            while (!m_search.m_found.load(std::memory_order_relaxed)) {
+                if (remaining() == 0) {
+                    m_search.finish(m_path);
+                    return;
+                }
+                if (m_search.m_idle.load(std::memory_order_relaxed) > 0 &&
+                    m_search.m_queued.load(std::memory_order_relaxed) == 0)
+                    share(base);
+                auto depth = m_length - 1;
+                auto& steps = m_steps[depth];
+                if (m_next[depth] == steps.size()) {
+                    if (depth == base) return;
+                    retreat();
+                    continue;
+                }
+                if (advance(steps[m_next[depth]++]))
+                    list_steps();
+                else
+                    retreat();
+            }
+        }
+    };
+
+    void publish(size_t id, Vector<size_t>&& prefix) {
+        m_pending.fetch_add(1);
+        m_queued.fetch_add(1);
+        auto& deque = m_deques[id];
+        {
+            std::lock_guard<std::mutex> lock(deque.m_mutex);
+            deque.m_prefixes.push_back(std::move(prefix));
+        }
+        wake(false);
+    }
+
+    // the newest prefix of the own deque, else the oldest of another
+    bool take(size_t id, Vector<size_t>& prefix) {
+        auto threads = m_deques.size();
+        for (size_t i = 0; i < threads; ++i) {
+            auto& deque = m_deques[(id + i) % threads];
+            std::lock_guard<std::mutex> lock(deque.m_mutex);
+            auto& prefixes = deque.m_prefixes;
+            if (prefixes.empty()) continue;
+            if (i == 0) {
+                prefix = std::move(prefixes.back());
+                prefixes.pop_back();
+            } else {
+                prefix = std::move(prefixes.front());
+                prefixes.pop_front();
+            }
+            m_queued.fetch_sub(1);
+            return true;
+        }
+        return false;
+    }
+
+    // the state idle threads wait on has changed
+    void wake(bool all) {
+        {
+            std::lock_guard<std::mutex> lock(m_wake_mutex);
+        }
+        if (all)
+            m_wake.notify_all();
+        else
+            m_wake.notify_one();
+    }
+
+    void finish(const Array<size_t>& path) {
+        {
+            std::lock_guard<std::mutex> lock(m_result_mutex);
+            if (m_found.exchange(true)) return;
+            m_result = path;
+        }
+        wake(true);
+    }
+
+    void work(size_t id) {
+        Worker worker(*this, id, m_g.vertices_count());
+        bool idle = false;
+        Vector<size_t> prefix;
+        while (!m_found.load()) {
+            if (take(id, prefix)) {
+                if (idle) m_idle.fetch_sub(1);
+                idle = false;
+                worker.run(prefix);
+                if (m_pending.fetch_sub(1) == 1) wake(true);
+                continue;
+            }
+            if (m_pending.load() == 0) break;
+            if (!idle) m_idle.fetch_add(1);
+            idle = true;
+            std::unique_lock<std::mutex> lock(m_wake_mutex);
+            m_wake.wait(lock, [this] {
+                return m_queued.load() > 0 || m_pending.load() == 0 ||
+                       m_found.load();
+            });
+        }
+        if (idle) m_idle.fetch_sub(1);
+    }
+
+   public:
+    HamiltonSearch(const G& g, size_t threads = hardware_threads())
+        : m_g(g),
+          m_out(Bfs_ns::AdjacencyIndex::out_edges(g)),
+          m_in(is_undirected_v<G> ? Bfs_ns::AdjacencyIndex()
+                                  : Bfs_ns::AdjacencyIndex::in_edges(g)),
+          m_found(false),
+          m_pending(0),
+          m_queued(0),
+          m_idle(0),
+          m_deques(std::max<size_t>(1, threads)) {}
+
+    Array<const vertex_t*> search(const vertex_t& s, const vertex_t& t) {
+        if (m_g.vertices_count() < 2) return Hamilton_ns::trivial_path(m_g);
+        if (s == t) return {};
+        m_source = s;
+        m_target = t;
+        m_found = false;
+        Vector<size_t> prefix;
+        prefix.push_back(s);
+        publish(0, std::move(prefix));
+        ThreadPool pool(m_deques.size());
+        pool.blocks(m_deques.size(),
+                    [this](size_t id, size_t, size_t) { work(id); });
+        for (auto& deque : m_deques) deque.m_prefixes.clear();
+        m_pending = 0;
+        m_queued = 0;
+        if (!m_found) return {};
+        Array<const vertex_t*> path(m_result.size());
+        for (size_t i = 0; i < m_result.size(); ++i)
+            path[i] = &m_g[m_result[i]];
+        return path;
+    }
+};
+
+/**
+ * A Hamilton path from s to t, in the layout of compose_hamilton_path:
+ * Held-Karp for graphs of at most Hamilton_ns::held_karp_dispatch_vertices
+ * vertices, the branch and bound search otherwise. Held-Karp takes larger
+ * graphs, up to its own limit, but its table then grows to hundreds of MB
+ * whatever the graph, while the search finishes easy inputs at once.
+ */
+template <typename G, typename V = typename G::vertex_type>
+Array<const V*> hamilton_path(const G& g, const V& s, const V& t,
+                              size_t threads = hardware_threads()) {
+    if (g.vertices_count() <= Hamilton_ns::held_karp_dispatch_vertices)
+        return held_karp_hamilton_path(g, s, t);
+    return HamiltonSearch<G>(g, threads).search(s, t);
+}
+
+}  // namespace Graph
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <utility>
+
+#include "array.h"
+#include "bellman_ford.h"
+#include "csr.h"
+#include "graph.h"
+#include "parallel.h"
+#include "two_dimensional_array.h"
+
+namespace Graph {
+
+/**
+ * Johnson's all pairs shortest paths, for sparse digraphs with negative
+ * weights. BellmanFord from a virtual source joined to every vertex gives
+ * the potentials h, then Spt runs from every source over a copy with the
+ * weights w(v, w) + h(v) - h(w), which are not negative. Both phases run on
+ * the same threads.
+ *
+ * When the graph has a negative cycle the search stops after Bellman-Ford:
+ * negative_cycle() holds the cycle and there are no distances.
+ */
+template <typename G>
+class Johnson {
+   public:
+    using vertex_t = typename G::vertex_type;
+    using w_t = typename G::edge_type::value_type;
+
+   private:
+    using R = Csr<GraphType::DIGRAPH, size_t, w_t>;
+
+    Array<w_t> m_potentials;
+    Two_dimensional_array<w_t> m_distances;
+    ArrayCycle m_cycle;
+
+    bool find_potentials(const G& g, ThreadPool& pool) {
+        using edge_t =
+            typename G::vertex_type::const_edges_iterator::entry_type;
+        BellmanFord<w_t, edge_t> bellman_ford(g.vertices_count(), 0);
+        for (size_t v = 0; v < g.vertices_count(); ++v)
+            bellman_ford.add_source(v);
+        bool converged = pool.threads() > 1
+                             ? bellman_ford.search_parallel(edge_arcs(g), pool)
+                             : bellman_ford.search(edge_arcs(g));
+        if (!converged) {
+            m_cycle = bellman_ford.negative_cycle();
+            return false;
+        }
+        m_potentials = std::move(bellman_ford.m_distance);
+        return true;
+    }
+
+    R reweighted(const G& g) const {
+        Array<size_t> values(g.vertices_count());
+        size_t edges_count = 0;
+        for (auto v = g.cbegin(); v != g.cend(); ++v) {
+            values[*v] = *v;
+            for (auto e = v->cedges_begin(); e != v->cedges_end(); ++e)
+                ++edges_count;
+        }
+        Array<typename R::edge_list_item_type> edges(edges_count);
+        size_t i = 0;
+        for (auto v = g.cbegin(); v != g.cend(); ++v)
+            for (auto e = v->cedges_begin(); e != v->cedges_end(); ++e) {
+                size_t w = e->target();
+                auto weight =
+                    e->edge().weight() + m_potentials[*v] - m_potentials[w];
+                edges[i++] = {*v, w, typename R::edge_type(weight)};
+            }
+        return R(values, edges.cbegin(), edges.cend());
+    }
+
+   public:
+    /**
+     * max_weight stands for the distance of the unreachable pairs and must
+     * exceed every reweighted distance.
+     */
+    Johnson(const G& g, w_t max_weight, size_t threads = hardware_threads())
+        : m_potentials(g.vertices_count(), 0),
+          m_distances(0, 0),
+          m_cycle({}, size_t(-1)) {
+        ThreadPool pool(threads);
+        if (!find_potentials(g, pool)) return;
+        auto r = reweighted(g);
+        auto count = g.vertices_count();
+        m_distances = Two_dimensional_array<w_t>(count, count);
+        pool.for_each(count, [&](size_t s) {
+            Spt<R> spt(r, r[s], max_weight);
+            auto row = m_distances[s];
+            for (size_t t = 0; t < count; ++t)
+                row[t] = t == s || spt.m_spt[t].m_target
+                             ? spt.m_distance[t] - m_potentials[s] +
+                                   m_potentials[t]
+                             : max_weight;
+        });
+    }
+
+    bool has_negative_cycle() const { return !m_cycle.empty(); }
+    const ArrayCycle& negative_cycle() const { return m_cycle; }
+
+    w_t distance(size_t v, size_t w) const { return m_distances.get(v, w); }
+    // the distance from the virtual source, which is at most 0
+    w_t potential(size_t v) const { return m_potentials[v]; }
+};
+
+}  // namespace Graph
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <algorithm>
+
+#include "array.h"
+#include "graph.h"
+#include "parallel.h"
+#include "union_find.h"
+#include "vector.h"
+
+namespace Graph {
+
+namespace Mst_ns {
+
+template <typename G>
+using entry_t = typename G::vertex_type::const_edges_iterator::entry_type;
+
+// the edges of an undirected graph, each once, lightest first with ties
+// broken by position
+template <typename G>
+Array<entry_t<G>> sorted_edges(const G& g) {
+    size_t count = 0;
+    for (auto v = g.cbegin(); v != g.cend(); ++v)
+        for (auto e = v->cedges_begin(); e != v->cedges_end(); ++e)
+            if (size_t(*v) < size_t(e->target())) ++count;
+    Array<entry_t<G>> edges(count);
+    size_t i = 0;
+    for (auto v = g.cbegin(); v != g.cend(); ++v)
+        for (auto e = v->cedges_begin(); e != v->cedges_end(); ++e)
+            if (size_t(*v) < size_t(e->target())) edges[i++] = *e;
+    std::stable_sort(edges.begin(), edges.end(),
+                     [](const auto& a, const auto& b) {
+                         return a.edge().weight() < b.edge().weight();
+                     });
+    return edges;
+}
+
+}  // namespace Mst_ns
+
+/**
+ * Kruskal's minimum spanning forest of an undirected graph: the edges by
+ * increasing weight, joining the trees of a UnionFind.
+ */
+template <typename G>
+auto kruskal_mst(const G& g) {
+    auto edges = Mst_ns::sorted_edges(g);
+    UnionFind trees(g.vertices_count());
+    Array<Mst_ns::entry_t<G>> mst(edges.size());
+    size_t count = 0;
+    for (auto& e : edges) {
+        if (trees.count() == 1) break;
+        if (trees.unite(e.source(), e.target())) mst[count++] = e;
+    }
+    return compose_path_tree(g, mst.cbegin(), mst.cbegin() + count);
+}
+
+/**
+ * Borůvka's minimum spanning forest of an undirected graph. Every round
+ * finds the lightest edge leaving every component, in parallel over the
+ * edges, adds them all, then contracts the components: the vertices are
+ * relabeled and the edges inside a component dropped, again in parallel.
+ * The rounds are at most log2 V, as every component merges with another.
+ *
+ * Edges are ordered by weight, then by position, so that ties never close
+ * a cycle and the forest is that of kruskal_mst.
+ */
+template <typename G>
+auto boruvka_mst(const G& g, size_t threads = hardware_threads()) {
+    static const constexpr size_t none = -1;
+    using entry_t = Mst_ns::entry_t<G>;
+    auto count = g.vertices_count();
+    // the positions follow the weights
+    auto entries = Mst_ns::sorted_edges(g);
+
+    struct Edge {
+        size_t m_source;
+        size_t m_target;
+        size_t m_entry;
+    };
+    Array<Edge> edges(entries.size());
+    for (size_t i = 0; i < entries.size(); ++i)
+        edges[i] = {entries[i].source(), entries[i].target(), i};
+    size_t edges_count = edges.size();
+
+    ThreadPool pool(threads);
+    Array<size_t> component(count);
+    for (size_t v = 0; v < count; ++v) component[v] = v;
+    // per thread: the lightest edge leaving every component
+    Array<Array<size_t>> lightest(pool.threads());
+    for (auto& l : lightest) l = Array<size_t>(count, none);
+    Array<size_t> kept(pool.threads());
+    Array<Edge> remaining(edges.size());
+    UnionFind trees(count);
+    Array<size_t> root(count);
+    Array<entry_t> mst(count);
+    size_t mst_count = 0;
+
+    while (edges_count > 0) {
+        pool.blocks(edges_count, [&](size_t t, size_t b, size_t e) {
+            auto& l = lightest[t];
+            for (auto i = b; i < e; ++i)
+                for (auto c : {edges[i].m_source, edges[i].m_target})
+                    l[c] = std::min(l[c], edges[i].m_entry);
+        });
+        for (size_t t = 1; t < pool.threads(); ++t)
+            pool.for_each(count, [&](size_t c) {
+                lightest[0][c] = std::min(lightest[0][c], lightest[t][c]);
+                lightest[t][c] = none;
+            });
+        for (size_t c = 0; c < count; ++c) {
+            auto i = lightest[0][c];
+            if (i == none) continue;
+            lightest[0][c] = none;
+            auto& e = entries[i];
+            if (trees.unite(component[e.source()], component[e.target()]))
+                mst[mst_count++] = e;
+        }
+
+        for (size_t c = 0; c < count; ++c) root[c] = trees.find(c);
+        pool.for_each(count,
+                      [&](size_t v) { component[v] = root[component[v]]; });
+        pool.blocks(edges_count, [&](size_t t, size_t b, size_t e) {
+            auto k = b;
+            for (auto i = b; i < e; ++i) {
+                auto s = component[edges[i].m_source];
+                auto w = component[edges[i].m_target];
+                if (s != w) remaining[k++] = {s, w, edges[i].m_entry};
+            }
+            kept[t] = k - b;
+        });
+        size_t blocks = std::max<size_t>(
+            1, std::min(pool.threads(), edges_count));
+        size_t k = 0;
+        for (size_t t = 0; t < blocks; ++t) {
+            auto b = edges_count * t / blocks;
+            for (size_t i = b; i < b + kept[t]; ++i) edges[k++] = remaining[i];
+        }
+        edges_count = k;
+    }
+    return compose_path_tree(g, mst.cbegin(), mst.cbegin() + mst_count);
+}
+
+}  // namespace Graph
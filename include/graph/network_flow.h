@@ -4,6 +4,7 @@
 
 #include "adjacency_lists.h"
 #include "array_queue.h"
+#include "csr.h"
 #include "graph.h"
 
 namespace Graph {
@@ -80,16 +81,17 @@ std::ostream& operator<<(std::ostream& stream, const FlowLink<VV, BB>& l) {
     return stream << l.source() << "-" << l.target();
 }
 
-template <typename V>
+template <typename V, typename C, typename LB>
 class FlowEdge {
    public:
-    using link_type = FlowLink<V, typename V::link_base_type>;
+    using link_type = FlowLink<V, LB>;
 
    private:
     link_type* m_link;
 
    public:
-    using value_type = typename V::edge_value_type;
+    using value_type = C;
+    FlowEdge() : m_link(nullptr) {}
     FlowEdge(link_type* link) : m_link(link) {}
     const link_type* link() const { return m_link; }
     link_type* link() { return m_link; }
@@ -100,18 +102,18 @@ template <typename V>
 class Flow;
 
 template <typename V, typename C, typename LB = LinkEmptyBase>
-class FlowVertex : public Adjacency_lists_ns::AdjListsVertexBase<
-                       GraphType::GRAPH, V, FlowEdge<FlowVertex<V, C, LB>>,
-                       FlowVertex<V, C, LB>> {
+class FlowVertex
+    : public Adjacency_lists_ns::AdjListsVertexBase<
+          GraphType::GRAPH, V, FlowEdge<FlowVertex<V, C, LB>, C, LB>,
+          FlowVertex<V, C, LB>> {
    private:
     using this_type = FlowVertex<V, C, LB>;
     friend class Adjacency_lists_ns::AdjacencyListsBase<GraphType::GRAPH,
                                                         this_type>;
     friend class Flow<this_type>;
     friend class Vector<this_type>;
-    using Base =
-        Adjacency_lists_ns::AdjListsVertexBase<GraphType::GRAPH, V,
-                                               FlowEdge<this_type>, this_type>;
+    using Base = Adjacency_lists_ns::AdjListsVertexBase<
+        GraphType::GRAPH, V, FlowEdge<this_type, C, LB>, this_type>;
     using adj_lists_type = typename Base::adj_lists_type;
     FlowVertex(const V& value, adj_lists_type* adjacency_lists)
         : Base(value, adjacency_lists) {}
@@ -133,7 +135,7 @@ class FlowVertex : public Adjacency_lists_ns::AdjListsVertexBase<
         }
     }
     void remove_edge(const FlowVertex& v) {
-        Base::m_links.remove_first_if([&v](auto& edge) {
+        Base::remove_first_link_if([&v](auto& edge) {
             bool found = v.index() == edge.target();
             if (found && v == edge.link()->source()) delete edge.link();
             return found;
@@ -199,6 +201,134 @@ class Flow : public Adjacency_lists_ns::AdjacencyListsBase<GraphType::GRAPH, V>,
     }
 };
 
+template <typename V, typename C, typename LB = LinkEmptyBase>
+class CsrFlowVertex
+    : public Csr_ns::CsrVertexBase<GraphType::GRAPH, V,
+                                   FlowEdge<CsrFlowVertex<V, C, LB>, C, LB>,
+                                   CsrFlowVertex<V, C, LB>> {
+   private:
+    using this_type = CsrFlowVertex<V, C, LB>;
+    using Base = Csr_ns::CsrVertexBase<GraphType::GRAPH, V,
+                                       FlowEdge<this_type, C, LB>, this_type>;
+    template <GraphType TT_graph_type, typename VV>
+    friend class Csr_ns::CsrBase;
+    friend class Array<this_type>;
+
+    CsrFlowVertex() = default;
+    CsrFlowVertex(const CsrFlowVertex&) = default;
+    CsrFlowVertex& operator=(const CsrFlowVertex&) = default;
+    CsrFlowVertex(CsrFlowVertex&&) = default;
+    CsrFlowVertex& operator=(CsrFlowVertex&&) = default;
+
+   public:
+    using edge_type = typename Base::edge_type;
+    using link_base_type = LB;
+    using edge_value_type = C;
+};
+
+/**
+ * Frozen flow network: the topology lives in CSR arrays and the links in one
+ * contiguous block, while flows stay mutable, so MaxFlow runs on it as is.
+ */
+template <typename V>
+class CsrFlow : public Csr_ns::CsrBase<GraphType::GRAPH, V> {
+   private:
+    using Base = Csr_ns::CsrBase<GraphType::GRAPH, V>;
+
+   public:
+    using vertex_type = typename Base::vertex_type;
+    using edge_type = typename Base::edge_type;
+    using edge_value_type = typename vertex_type::edge_value_type;
+    using link_base_type = typename vertex_type::link_base_type;
+    using link_type = typename edge_type::link_type;
+
+   private:
+    link_type* m_links;
+    size_t m_links_count;
+
+   public:
+    /**
+     * Every link is stored once and shared by both endpoints, as in Flow.
+     * The endpoint which does not own a link finds it through the links
+     * pending on it, so freezing stays linear in the number of edges.
+     */
+    template <typename F>
+    explicit CsrFlow(const F& f) : m_links(nullptr), m_links_count(0) {
+        auto count = f.vertices_count();
+        size_t edges_count = 0;
+        Array<size_t> pending_offsets(count + 1, 0);
+        for (auto v = f.cbegin(); v != f.cend(); ++v)
+            for (auto e = v->cedges_begin(); e != v->cedges_end();
+                 ++e, ++edges_count)
+                if (e->edge().link()->is_from(*v)) {
+                    ++m_links_count;
+                    ++pending_offsets[e->target()];
+                }
+        Csr_ns::accumulate_counts(pending_offsets);
+        Base::allocate(count, edges_count);
+        Base::copy_values(f);
+
+        m_links = static_cast<link_type*>(
+            ::operator new(m_links_count * sizeof(link_type)));
+        Array<size_t> pending(m_links_count);
+        Array<size_t> cursors(count);
+        for (size_t v = 0; v < count; ++v) cursors[v] = pending_offsets[v];
+        size_t id = 0;
+        for (auto v = f.cbegin(); v != f.cend(); ++v)
+            for (auto e = v->cedges_begin(); e != v->cedges_end(); ++e) {
+                auto link = e->edge().link();
+                if (link->is_from(*v)) {
+                    size_t w = e->target();
+                    new (m_links + id) link_type(
+                        &Base::m_vertices[*v], &Base::m_vertices[w],
+                        link->cap(), link->flow(),
+                        static_cast<const link_base_type&>(*link));
+                    pending[cursors[w]++] = id++;
+                }
+            }
+
+        Array<size_t> slots(count);
+        id = 0;
+        size_t p = 0;
+        for (auto v = f.cbegin(); v != f.cend(); ++v) {
+            Base::m_offsets[*v] = p;
+            for (auto q = pending_offsets[*v]; q != pending_offsets[*v + 1];
+                 ++q)
+                slots[m_links[pending[q]].source()] = pending[q];
+            for (auto e = v->cedges_begin(); e != v->cedges_end(); ++e, ++p) {
+                size_t l = e->edge().link()->is_from(*v) ? id++
+                                                         : slots[e->target()];
+                Base::m_targets[p] = e->target();
+                Base::m_edges[p] = edge_type(m_links + l);
+            }
+        }
+        Base::m_offsets[count] = p;
+    }
+    CsrFlow(const CsrFlow&) = delete;
+    CsrFlow& operator=(const CsrFlow&) = delete;
+    CsrFlow(CsrFlow&& o)
+        : Base(std::move(o)),
+          m_links(o.m_links),
+          m_links_count(o.m_links_count) {
+        o.m_links = nullptr;
+        o.m_links_count = 0;
+    }
+    CsrFlow& operator=(CsrFlow&& o) {
+        Base::operator=(std::move(o));
+        std::swap(m_links, o.m_links);
+        std::swap(m_links_count, o.m_links_count);
+        return *this;
+    }
+    ~CsrFlow() {
+        for (size_t i = 0; i < m_links_count; ++i) m_links[i].~link_type();
+        ::operator delete(m_links);
+    }
+
+    link_type* get_link(size_t v, size_t w) {
+        return Base::get_edge(v, w)->link();
+    }
+};
+
 template <typename V, typename C>
 void print(const V& v, const FlowLink<V, LinkCostBase<C>>& link,
            std::ostream& stream) {
@@ -224,6 +354,17 @@ struct InternalPrinter
     }
 };
 
+template <typename V, typename C, typename LB>
+struct CsrInternalPrinter
+    : public Adjacency_lists_ns::InternalPrinterBase<
+          CsrFlow<CsrFlowVertex<V, C, LB>>, CsrInternalPrinter<V, C, LB>> {
+    static void print_vertex(const CsrFlowVertex<V, C, LB>& v,
+                             std::ostream& stream) {
+        for (auto e = v.cedges_begin(); e != v.cedges_end(); ++e)
+            print(v, *e->edge().link(), stream);
+    }
+};
+
 template <typename V, typename C, typename LB = Network_flow_ns::LinkEmptyBase>
 void print_representation(
     const Network_flow_ns::Flow<Network_flow_ns::FlowVertex<V, C, LB>>& g,
@@ -231,6 +372,13 @@ void print_representation(
     Network_flow_ns::InternalPrinter<V, C, LB>::print(g, stream);
 }
 
+template <typename V, typename C, typename LB = Network_flow_ns::LinkEmptyBase>
+void print_representation(
+    const Network_flow_ns::CsrFlow<Network_flow_ns::CsrFlowVertex<V, C, LB>>& g,
+    std::ostream& stream) {
+    Network_flow_ns::CsrInternalPrinter<V, C, LB>::print(g, stream);
+}
+
 template <typename G>
 auto calculate_network_flow_cost(const G& g) {
     typename G::edge_type::value_type sum = 0;
@@ -243,7 +391,7 @@ auto calculate_network_flow_cost(const G& g) {
     return sum;
 }
 
-template <typename G>
+template <typename G, template <typename, typename> class H = VertexHeap>
 struct MaxFlow {
     using vertex_t = typename G::vertex_type;
     using w_t = typename G::edge_type::value_type;
@@ -264,7 +412,7 @@ struct MaxFlow {
         while (pfs()) augment();
     }
     bool pfs() {
-        VertexHeap<vertex_t*, w_t> heap(m_g.vertices_count(), m_weights);
+        H<vertex_t*, w_t> heap(m_g.vertices_count(), m_weights);
         for (auto v = m_g.cbegin(); v != m_g.cend(); ++v) {
             m_weights[*v] = 0;
             m_links[*v] = nullptr;
@@ -394,6 +542,15 @@ template <typename V, typename C>
 using NetworkFlowWithCost = Network_flow_ns::Flow<
     Network_flow_ns::FlowVertex<V, C, Network_flow_ns::LinkCostBase<C>>>;
 
+template <typename V, typename C>
+using CsrNetworkFlow =
+    Network_flow_ns::CsrFlow<Network_flow_ns::CsrFlowVertex<V, C>>;
+
+template <typename V, typename C>
+using CsrNetworkFlowWithCost =
+    Network_flow_ns::CsrFlow<Network_flow_ns::CsrFlowVertex<
+        V, C, Network_flow_ns::LinkCostBase<C>>>;
+
 namespace Network_flow_ns {
 
 template <typename M>
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <algorithm>
+
 #include "array.h"
-#include "forward_list"
+#include "bellman_ford.h"
+
 namespace Graph {
 
 namespace Network_flow_ns {
@@ -13,54 +16,33 @@ struct MaxFlowMinCost {
     using w_t = typename vertex_type::edge_value_type;
 
     G& m_g;
-    Array<w_t> m_weights;
-    Array<link_type*> m_links;
+    BellmanFord<w_t, link_type*> m_bellman_ford;
     const w_t m_sentinel;
 
     MaxFlowMinCost(G& g, vertex_type& s, vertex_type& t, const w_t& sentinel)
         : m_g(g),
-          m_weights(g.vertices_count()),
-          m_links(g.vertices_count()),
+          m_bellman_ford(g.vertices_count(), 0),
           m_sentinel(sentinel) {
         g.add_edge(s, t, sentinel, sentinel, sentinel);
         for (vertex_type* v; (v = find_negative_cycle());) augment(v);
         g.remove_edge(s, t);
     }
+    // a vertex of a negative cycle of the residual network, from every vertex
+    // at once
     vertex_type* find_negative_cycle() {
-        for (auto& v : m_g)
-            if (find_negative_cycle(v)) return &v;
-        return nullptr;
-    }
-    bool find_negative_cycle(vertex_type& vertex) {
-        m_weights.fill(m_sentinel);
-        m_weights[vertex] = 0;
-
-        ForwardList<vertex_type*> queue;
-        queue.push_back(&vertex);
-        queue.push_back(nullptr);
-
-        size_t count = 0;
-        for (bool repeat = true; repeat && !queue.empty();) {
-            vertex_type* v;
-            while (repeat && (v = queue.pop_front()) == nullptr) {
-                repeat = ++count < m_g.vertices_count();
-                if (repeat) queue.push_back(nullptr);
+        m_bellman_ford.reset();
+        for (size_t v = 0; v < m_g.vertices_count(); ++v)
+            m_bellman_ford.add_source(v);
+        bool found = !m_bellman_ford.search([this](size_t i, auto relax) {
+            auto& v = m_g[i];
+            for (auto e = v.edges_begin(); e != v.edges_end(); ++e) {
+                auto link = e->edge().link();
+                auto& w = link->other(v);
+                if (link->cap_r_to(w) > 0)
+                    relax(size_t(w), cost_r_to(*link, w), link);
             }
-            if (repeat)
-                for (auto e = v->edges_begin(); e != v->edges_end(); ++e) {
-                    auto link = e->edge().link();
-                    auto& w = link->other(*v);
-                    if (link->cap_r_to(w) > 0) {
-                        queue.push_back(&w);
-                        auto weight = m_weights[*v] + cost_r_to(*link, w);
-                        if (m_weights[w] > weight) {
-                            m_weights[w] = weight;
-                            m_links[w] = link;
-                        }
-                    }
-                }
-        }
-        return m_weights[vertex] < 0;
+        });
+        return found ? &m_g[m_bellman_ford.cycle_vertex()] : nullptr;
     }
     void augment(vertex_type* vertex) {
         auto cap = m_sentinel;
@@ -73,7 +55,7 @@ struct MaxFlowMinCost {
     template <typename F>
     void iterate_cycle(vertex_type* vertex, F f) {
         for (auto v = vertex;;) {
-            auto link = m_links[*v];
+            auto link = m_bellman_ford.m_parent_arc[*v];
             f(link, v);
             v = &link->other(*v);
             if (v == vertex) break;
@@ -0,0 +1,254 @@
+#pragma once
+
+#include <cstdint>
+
+#include "array.h"
+#include "graph_common.h"
+#include "vertex_heaps.h"
+
+namespace Graph {
+
+/**
+ * Single pair shortest path queries by bidirectional Dijkstra or A*. The
+ * scratch arrays are allocated once and invalidated by bumping a version
+ * stamp, so a query allocates nothing and touches only the vertices it
+ * explores. An engine is not shared between threads; give each thread its
+ * own over the same graph.
+ */
+template <typename G,
+          template <typename, typename> class H = QuaternaryVertexHeap>
+class PointToPoint {
+   public:
+    using vertex_t = typename G::vertex_type;
+    using edge_t = typename G::vertex_type::const_edges_iterator::entry_type;
+    using weight_t = typename G::edge_type::value_type;
+
+   private:
+    static const constexpr size_t none = -1;
+
+    struct Search {
+        Array<weight_t> m_distance;
+        Array<weight_t> m_keys;
+        // the edge entering the vertex, or leaving it toward the target in
+        // the backward search
+        Array<edge_t> m_parent;
+        Array<uint32_t> m_reached;
+        Array<uint32_t> m_settled;
+        H<const vertex_t*, weight_t> m_heap;
+        weight_t m_last_key;
+
+        explicit Search(size_t count)
+            : m_distance(count),
+              m_keys(count),
+              m_parent(count),
+              m_reached(count, 0),
+              m_settled(count, 0),
+              m_heap(count, m_keys) {}
+        Search(const Search&) = delete;
+        Search& operator=(const Search&) = delete;
+    };
+
+    const G& m_g;
+    // edges entering every vertex, as entries of their sources
+    Array<size_t> m_in_offsets;
+    Array<edge_t> m_in_edges;
+    Search m_forward;
+    Search m_backward;
+    uint32_t m_version;
+
+    const vertex_t* m_source;
+    const vertex_t* m_target;
+    size_t m_meeting;
+    weight_t m_distance;
+    size_t m_settled_count;
+
+    bool is_reached(const Search& s, size_t v) const {
+        return s.m_reached[v] == m_version;
+    }
+    bool is_settled(const Search& s, size_t v) const {
+        return s.m_settled[v] == m_version;
+    }
+
+    void start(const vertex_t& source, const vertex_t& target) {
+        if (++m_version == 0) {
+            for (auto* s : {&m_forward, &m_backward}) {
+                s->m_reached.fill(0);
+                s->m_settled.fill(0);
+            }
+            m_version = 1;
+        }
+        for (auto* s : {&m_forward, &m_backward}) {
+            s->m_heap.clear();
+            s->m_last_key = 0;
+        }
+        m_source = &source;
+        m_target = &target;
+        m_meeting = none;
+        m_settled_count = 0;
+    }
+
+    void reach(Search& s, const vertex_t& v, weight_t distance,
+               weight_t key) {
+        bool queued = is_reached(s, v);
+        s.m_reached[v] = m_version;
+        s.m_distance[v] = distance;
+        s.m_keys[v] = key;
+        if (queued)
+            s.m_heap.move_up(&v);
+        else
+            s.m_heap.push(&v);
+    }
+    const vertex_t& settle(Search& s) {
+        const vertex_t& v = *s.m_heap.pop();
+        s.m_settled[v] = m_version;
+        s.m_last_key = s.m_keys[v];
+        ++m_settled_count;
+        return v;
+    }
+    bool improves(const Search& s, size_t v, weight_t distance) const {
+        return !is_settled(s, v) &&
+               (!is_reached(s, v) || distance < s.m_distance[v]);
+    }
+    void meet(size_t v) {
+        auto distance = m_forward.m_distance[v] + m_backward.m_distance[v];
+        if (m_meeting == none || distance < m_distance) {
+            m_meeting = v;
+            m_distance = distance;
+        }
+    }
+
+    void expand_forward() {
+        auto& v = settle(m_forward);
+        for (auto e = v.cedges_begin(); e != v.cedges_end(); ++e) {
+            auto& w = e->target();
+            auto distance = m_forward.m_distance[v] + e->edge().weight();
+            if (!improves(m_forward, w, distance)) continue;
+            reach(m_forward, w, distance, distance);
+            m_forward.m_parent[w] = *e;
+            if (is_reached(m_backward, w)) meet(w);
+        }
+    }
+    void expand_backward() {
+        auto& v = settle(m_backward);
+        size_t end = m_in_offsets[size_t(v) + 1];
+        for (auto i = m_in_offsets[v]; i != end; ++i) {
+            auto& e = m_in_edges[i];
+            auto& w = e.source();
+            auto distance = m_backward.m_distance[v] + e.edge().weight();
+            if (!improves(m_backward, w, distance)) continue;
+            reach(m_backward, w, distance, distance);
+            m_backward.m_parent[w] = e;
+            if (is_reached(m_forward, w)) meet(w);
+        }
+    }
+
+   public:
+    explicit PointToPoint(const G& g)
+        : m_g(g),
+          m_in_offsets(g.vertices_count() + 1, 0),
+          m_forward(g.vertices_count()),
+          m_backward(g.vertices_count()),
+          m_version(0),
+          m_source(nullptr),
+          m_target(nullptr),
+          m_meeting(none),
+          m_distance(0),
+          m_settled_count(0) {
+        auto count = g.vertices_count();
+        for (auto v = g.cbegin(); v != g.cend(); ++v)
+            for (auto e = v->cedges_begin(); e != v->cedges_end(); ++e)
+                ++m_in_offsets[size_t(e->target()) + 1];
+        for (size_t v = 0; v < count; ++v)
+            m_in_offsets[v + 1] += m_in_offsets[v];
+        m_in_edges = Array<edge_t>(m_in_offsets[count]);
+        Array<size_t> next(count);
+        for (size_t v = 0; v < count; ++v) next[v] = m_in_offsets[v];
+        for (auto v = g.cbegin(); v != g.cend(); ++v)
+            for (auto e = v->cedges_begin(); e != v->cedges_end(); ++e)
+                m_in_edges[next[e->target()]++] = *e;
+    }
+
+    /**
+     * Bidirectional Dijkstra, expanding the side with the smaller queue.
+     * The searches stop once the last keys of both sides add up to the
+     * best path through a vertex reached from both. Returns whether the
+     * target is reachable.
+     */
+    bool search(const vertex_t& source, const vertex_t& target) {
+        start(source, target);
+        if (source == target) {
+            m_meeting = source;
+            m_distance = 0;
+            return true;
+        }
+        reach(m_forward, source, 0, 0);
+        reach(m_backward, target, 0, 0);
+        while (!m_forward.m_heap.empty() && !m_backward.m_heap.empty()) {
+            auto keys = m_forward.m_last_key + m_backward.m_last_key;
+            if (m_meeting != none && !(keys < m_distance)) break;
+            if (m_forward.m_heap.size() <= m_backward.m_heap.size())
+                expand_forward();
+            else
+                expand_backward();
+        }
+        return m_meeting != none;
+    }
+
+    /**
+     * A* from the source, keyed by the distance plus heuristic(v), a lower
+     * bound of the distance from v to the target which must not drop by
+     * more than the weight of any edge, e.g. the straight line distance to
+     * the target. Returns whether the target is reachable.
+     */
+    template <typename F>
+    bool search(const vertex_t& source, const vertex_t& target, F heuristic) {
+        start(source, target);
+        reach(m_forward, source, 0, heuristic(source));
+        while (!m_forward.m_heap.empty()) {
+            auto& v = settle(m_forward);
+            if (v == target) {
+                m_meeting = v;
+                m_distance = m_forward.m_distance[v];
+                return true;
+            }
+            for (auto e = v.cedges_begin(); e != v.cedges_end(); ++e) {
+                auto& w = e->target();
+                auto distance = m_forward.m_distance[v] + e->edge().weight();
+                if (!improves(m_forward, w, distance)) continue;
+                reach(m_forward, w, distance, distance + heuristic(w));
+                m_forward.m_parent[w] = *e;
+            }
+        }
+        return false;
+    }
+
+    weight_t distance() const { return m_distance; }
+    size_t settled_count() const { return m_settled_count; }
+
+    /**
+     * The edges of the last path found, from the source to the target.
+     */
+    Array<edge_t> path() const {
+        if (m_meeting == none) return {};
+        size_t length = 0;
+        for (auto v = m_meeting; v != *m_source; ++length)
+            v = m_forward.m_parent[v].source();
+        size_t forward_length = length;
+        for (auto v = m_meeting; v != *m_target; ++length)
+            v = m_backward.m_parent[v].target();
+        Array<edge_t> path(length);
+        auto i = forward_length;
+        for (auto v = m_meeting; v != *m_source;) {
+            path[--i] = m_forward.m_parent[v];
+            v = path[i].source();
+        }
+        i = forward_length;
+        for (auto v = m_meeting; v != *m_target; ++i) {
+            path[i] = m_backward.m_parent[v];
+            v = path[i].target();
+        }
+        return path;
+    }
+};
+
+}  // namespace Graph
@@ -0,0 +1,266 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <utility>
+
+#include "array.h"
+#include "array_queue.h"
+#include "array_stack.h"
+#include "bfs.h"
+#include "parallel.h"
+#include "vector.h"
+
+namespace Graph {
+
+namespace Scc_ns {
+
+/**
+ * The strong components of a digraph on a thread pool (Hong et al.):
+ * - trim: vertices without live in or out edges are components of their
+ *   own, and removing them may trim their neighbours;
+ * - forward-backward: the vertices both reached from and reaching a pivot
+ *   of high degree, found by two level-synchronous searches, usually the
+ *   giant component;
+ * - coloring, for the rest: the largest vertex reaching every vertex is
+ *   propagated along the edges, then every vertex keeping its own color
+ *   collects the vertices of its color reaching it, backward. The rounds
+ *   repeat over the vertices left.
+ *
+ * Components are found as representative vertices, then numbered in
+ * reverse topological order, like strong_components_tarjan: an edge never
+ * leads to a component with a larger id.
+ */
+template <typename G>
+class ParallelScc {
+   private:
+    static const constexpr size_t none = -1;
+    using word_type = uint64_t;
+    using bitmap_type = Array<std::atomic<word_type>>;
+    static const constexpr size_t word_bits = 64;
+
+    Bfs_ns::AdjacencyIndex m_out;
+    Bfs_ns::AdjacencyIndex m_in;
+    ThreadPool m_pool;
+    // the representative of the component of every vertex, none while live
+    Array<size_t> m_component;
+    Array<Vector<size_t>> m_found;
+
+    size_t count() const { return m_component.size(); }
+    bool live(size_t v) const { return m_component[v] == none; }
+
+    static void clear(bitmap_type& bits) {
+        for (auto& word : bits) word.store(0, std::memory_order_relaxed);
+    }
+    // sets the bit of v, returning whether it was clear
+    static bool claim(bitmap_type& bits, size_t v) {
+        auto mask = word_type(1) << v % word_bits;
+        return !(bits[v / word_bits].fetch_or(mask,
+                                              std::memory_order_relaxed) &
+                 mask);
+    }
+    static bool test(const bitmap_type& bits, size_t v) {
+        return bits[v / word_bits].load(std::memory_order_relaxed) >>
+                   v % word_bits &
+               1;
+    }
+
+    // moves the vertices found by the threads to one list
+    void gather(Vector<size_t>& list) {
+        list.clear();
+        for (auto& found : m_found) {
+            for (auto v : found) list.push_back(v);
+            found.clear();
+        }
+    }
+
+    void trim() {
+        Array<std::atomic<size_t>> in_degrees(count());
+        Array<std::atomic<size_t>> out_degrees(count());
+        bitmap_type trimmed((count() + word_bits - 1) / word_bits);
+        clear(trimmed);
+        m_pool.blocks(count(), [&](size_t t, size_t b, size_t e) {
+            for (auto v = b; v < e; ++v) {
+                in_degrees[v].store(m_in.degree(v), std::memory_order_relaxed);
+                out_degrees[v].store(m_out.degree(v),
+                                     std::memory_order_relaxed);
+                if (m_in.degree(v) == 0 || m_out.degree(v) == 0) {
+                    claim(trimmed, v);
+                    m_found[t].push_back(v);
+                }
+            }
+        });
+        auto release = [&](auto& degrees, size_t w, Vector<size_t>& found) {
+            if (degrees[w].fetch_sub(1, std::memory_order_relaxed) == 1 &&
+                claim(trimmed, w))
+                found.push_back(w);
+        };
+        Vector<size_t> frontier;
+        for (gather(frontier); !frontier.empty(); gather(frontier))
+            m_pool.blocks(frontier.size(), [&](size_t t, size_t b, size_t e) {
+                for (auto i = b; i < e; ++i) {
+                    auto v = frontier[i];
+                    m_component[v] = v;
+                    for (auto w = m_out.cbegin(v); w != m_out.cend(v); ++w)
+                        release(in_degrees, *w, m_found[t]);
+                    for (auto u = m_in.cbegin(v); u != m_in.cend(v); ++u)
+                        release(out_degrees, *u, m_found[t]);
+                }
+            });
+    }
+
+    // marks the live vertices reached from s along the index
+    void reach(size_t s, const Bfs_ns::AdjacencyIndex& index,
+               bitmap_type& reached) {
+        clear(reached);
+        claim(reached, s);
+        Vector<size_t> frontier;
+        frontier.push_back(s);
+        for (; !frontier.empty(); gather(frontier))
+            m_pool.blocks(frontier.size(), [&](size_t t, size_t b, size_t e) {
+                for (auto i = b; i < e; ++i) {
+                    auto v = frontier[i];
+                    for (auto w = index.cbegin(v); w != index.cend(v); ++w)
+                        if (live(*w) && claim(reached, *w))
+                            m_found[t].push_back(*w);
+                }
+            });
+    }
+
+    void forward_backward() {
+        size_t pivot = none;
+        size_t max_degree = 0;
+        for (size_t v = 0; v < count(); ++v) {
+            auto degree = m_in.degree(v) * m_out.degree(v);
+            if (live(v) && degree >= max_degree) {
+                pivot = v;
+                max_degree = degree;
+            }
+        }
+        if (pivot == none) return;
+        auto words = (count() + word_bits - 1) / word_bits;
+        bitmap_type forward(words), backward(words);
+        reach(pivot, m_out, forward);
+        reach(pivot, m_in, backward);
+        m_pool.for_each(count(), [&](size_t v) {
+            if (test(forward, v) && test(backward, v)) m_component[v] = pivot;
+        });
+    }
+
+    // one coloring round, false when no vertex was live
+    bool color() {
+        Array<size_t> colors(count()), next(count());
+        m_pool.for_each(count(),
+                        [&](size_t v) { colors[v] = live(v) ? v : none; });
+        for (bool changed = true; changed;) {
+            Array<char> changes(m_pool.threads(), false);
+            m_pool.blocks(count(), [&](size_t t, size_t b, size_t e) {
+                for (auto v = b; v < e; ++v) {
+                    auto c = colors[v];
+                    if (c != none)
+                        for (auto u = m_in.cbegin(v); u != m_in.cend(v); ++u)
+                            if (colors[*u] != none && colors[*u] > c)
+                                c = colors[*u];
+                    next[v] = c;
+                    if (c != colors[v]) changes[t] = true;
+                }
+            });
+            std::swap(colors, next);
+            changed = false;
+            for (size_t t = 0; t < m_pool.threads(); ++t)
+                changed = changed || changes[t];
+        }
+
+        m_pool.blocks(count(), [&](size_t t, size_t b, size_t e) {
+            for (auto v = b; v < e; ++v)
+                if (colors[v] == v) m_found[t].push_back(v);
+        });
+        Vector<size_t> roots;
+        gather(roots);
+        // every root owns the vertices of its color
+        m_pool.for_each(roots.size(), [&](size_t i) {
+            auto root = roots[i];
+            ArrayStack<size_t> stack;
+            stack.push(root);
+            m_component[root] = root;
+            while (!stack.empty()) {
+                auto v = stack.pop();
+                for (auto u = m_in.cbegin(v); u != m_in.cend(v); ++u)
+                    if (colors[*u] == root && m_component[*u] != root) {
+                        m_component[*u] = root;
+                        stack.push(*u);
+                    }
+            }
+        });
+        return !roots.empty();
+    }
+
+    Array<size_t> number() const {
+        Array<size_t> index(count(), none);
+        size_t components = 0;
+        for (size_t v = 0; v < count(); ++v)
+            if (m_component[v] == v) index[v] = components++;
+        Array<size_t> component(count());
+        Array<size_t> offsets(components + 1, 0);
+        Array<size_t> out_degrees(components, 0);
+        for (size_t v = 0; v < count(); ++v) {
+            auto c = component[v] = index[m_component[v]];
+            ++offsets[c + 1];
+            for (auto w = m_out.cbegin(v); w != m_out.cend(v); ++w)
+                if (m_component[*w] != m_component[v]) ++out_degrees[c];
+        }
+        for (size_t c = 0; c < components; ++c) offsets[c + 1] += offsets[c];
+        Array<size_t> members(count());
+        Array<size_t> next(components);
+        for (size_t c = 0; c < components; ++c) next[c] = offsets[c];
+        for (size_t v = 0; v < count(); ++v) members[next[component[v]]++] = v;
+
+        // Kahn's algorithm from the sinks, over the edges entering
+        Array<size_t> ids(components);
+        ArrayQueue<size_t> queue(components);
+        for (size_t c = 0; c < components; ++c)
+            if (out_degrees[c] == 0) queue.push(c);
+        for (size_t id = 0; !queue.empty(); ++id) {
+            auto c = queue.pop();
+            ids[c] = id;
+            for (auto i = offsets[c]; i < offsets[c + 1]; ++i) {
+                auto v = members[i];
+                for (auto u = m_in.cbegin(v); u != m_in.cend(v); ++u)
+                    if (component[*u] != c && --out_degrees[component[*u]] == 0)
+                        queue.push(component[*u]);
+            }
+        }
+        for (size_t v = 0; v < count(); ++v) component[v] = ids[component[v]];
+        return component;
+    }
+
+   public:
+    ParallelScc(const G& g, size_t threads)
+        : m_out(Bfs_ns::AdjacencyIndex::out_edges(g)),
+          m_in(Bfs_ns::AdjacencyIndex::in_edges(g)),
+          m_pool(threads),
+          m_component(g.vertices_count(), none),
+          m_found(m_pool.threads()) {}
+
+    Array<size_t> search() {
+        trim();
+        forward_backward();
+        while (color()) {
+        }
+        return number();
+    }
+};
+
+}  // namespace Scc_ns
+
+/**
+ * Strong components on threads, with the ids of strong_components_tarjan:
+ * 0 for a sink component, and an edge never leading to a larger id.
+ */
+template <typename G>
+Array<size_t> strong_components_parallel(const G& g,
+                                         size_t threads = hardware_threads()) {
+    return Scc_ns::ParallelScc<G>(g, threads).search();
+}
+
+}  // namespace Graph
@@ -0,0 +1,191 @@
+#pragma once
+
+#include <algorithm>
+#include <memory>
+
+#include "array_stack.h"
+#include "graph.h"
+#include "small_vector.h"
+#include "vector.h"
+
+namespace Graph {
+
+/**
+ * A topological order of a DAG kept current under edge insertions and
+ * removals (Pearce and Kelly). An edge v-w agreeing with the order is just
+ * linked. Otherwise the vertices between w and v in the order are searched:
+ * forward from w, where reaching v closes a cycle and rejects the edge, and
+ * backward from v. Those reaching v then move before those reached from w,
+ * within the positions they held, so the work is bounded by the region
+ * affected rather than by the graph.
+ *
+ * The graph is edited only through this class, which keeps the sources of
+ * the edges entering every vertex. The constructor throws
+ * InvalidDagException on a cyclic graph.
+ *
+ * snapshot() shares the order array, copied on the next reordering while a
+ * snapshot lives: taking one is O(1), and it never changes. Snapshots are
+ * taken by the editing thread, and read from any.
+ */
+template <typename G>
+class DynamicTopologicalOrder {
+   public:
+    using vertex_type = typename G::vertex_type;
+    using order_type = Vector<size_t>;
+
+   private:
+    using sources_type = SmallVector<size_t, 4>;
+
+    G& m_g;
+    // the vertices by position, and the position of every vertex
+    std::shared_ptr<order_type> m_order;
+    Vector<size_t> m_position;
+    Vector<sources_type> m_sources;
+
+    Vector<char> m_visited;
+    ArrayStack<size_t> m_stack;
+    Vector<size_t> m_forward;
+    Vector<size_t> m_backward;
+    Vector<size_t> m_positions;
+
+    order_type& order() {
+        if (m_order.use_count() > 1)
+            m_order = std::make_shared<order_type>(*m_order);
+        return *m_order;
+    }
+
+    // the vertices reached from w up to position ub, false when v is
+    bool search_forward(size_t w, size_t ub) {
+        m_visited[w] = true;
+        m_forward.push_back(w);
+        m_stack.push(w);
+        while (!m_stack.empty()) {
+            auto& x = m_g[m_stack.pop()];
+            for (auto y = x.cbegin(); y != x.cend(); ++y) {
+                if (m_position[*y] == ub) return false;
+                if (m_visited[*y] || m_position[*y] > ub) continue;
+                m_visited[*y] = true;
+                m_forward.push_back(*y);
+                m_stack.push(*y);
+            }
+        }
+        return true;
+    }
+    // the vertices reaching v down to position lb
+    void search_backward(size_t v, size_t lb) {
+        m_visited[v] = true;
+        m_backward.push_back(v);
+        m_stack.push(v);
+        while (!m_stack.empty()) {
+            auto x = m_stack.pop();
+            for (auto u : m_sources[x]) {
+                if (m_visited[u] || m_position[u] < lb) continue;
+                m_visited[u] = true;
+                m_backward.push_back(u);
+                m_stack.push(u);
+            }
+        }
+    }
+
+    // the backward vertices, then the forward ones, over their positions
+    void reorder() {
+        auto by_position = [this](size_t a, size_t b) {
+            return m_position[a] < m_position[b];
+        };
+        std::sort(m_backward.begin(), m_backward.end(), by_position);
+        std::sort(m_forward.begin(), m_forward.end(), by_position);
+        m_positions.clear();
+        for (auto v : m_backward) m_positions.push_back(m_position[v]);
+        for (auto v : m_forward) m_positions.push_back(m_position[v]);
+        std::inplace_merge(m_positions.begin(),
+                           m_positions.begin() + m_backward.size(),
+                           m_positions.end());
+        auto& order = this->order();
+        size_t i = 0;
+        for (auto& list : {&m_backward, &m_forward})
+            for (auto v : *list) {
+                m_position[v] = m_positions[i++];
+                order[m_position[v]] = v;
+            }
+    }
+
+    void clear_search() {
+        for (auto v : m_forward) m_visited[v] = false;
+        for (auto v : m_backward) m_visited[v] = false;
+        m_forward.clear();
+        m_backward.clear();
+        m_stack.clear();
+    }
+
+   public:
+    explicit DynamicTopologicalOrder(G& g)
+        : m_g(g), m_order(std::make_shared<order_type>()) {
+        validate_dag(g);
+        auto count = g.vertices_count();
+        auto order = topological_sort_relabel(g);
+        for (size_t i = 0; i < count; ++i) {
+            m_order->push_back(order[i]);
+            m_position.push_back(0);
+            m_sources.push_back(sources_type());
+            m_visited.push_back(false);
+        }
+        for (size_t i = 0; i < count; ++i) m_position[order[i]] = i;
+        for (auto v = g.cbegin(); v != g.cend(); ++v)
+            for (auto w = v->cbegin(); w != v->cend(); ++w)
+                m_sources[*w].push_back(*v);
+    }
+    DynamicTopologicalOrder(const DynamicTopologicalOrder&) = delete;
+    DynamicTopologicalOrder& operator=(const DynamicTopologicalOrder&) =
+        delete;
+
+    const G& graph() const { return m_g; }
+    size_t position(const vertex_type& v) const { return m_position[v]; }
+    std::shared_ptr<const order_type> snapshot() const { return m_order; }
+
+    // the new vertex goes last
+    vertex_type& create_vertex(const typename vertex_type::value_type& t) {
+        auto& v = m_g.create_vertex(t);
+        m_position.push_back(m_order->size());
+        order().push_back(v);
+        m_sources.push_back(sources_type());
+        m_visited.push_back(false);
+        return v;
+    }
+
+    /**
+     * Adds the edge v-w unless it closes a cycle, returning false then with
+     * the graph and the order unchanged. Existing edges are kept as they
+     * are.
+     */
+    template <typename... E>
+    bool add_edge(const vertex_type& v, const vertex_type& w,
+                  const E&... edge) {
+        if (m_g.has_edge(v, w)) return true;
+        if (v == w) return false;
+        auto lb = m_position[w];
+        auto ub = m_position[v];
+        if (ub > lb) {
+            bool acyclic = search_forward(w, ub);
+            if (acyclic) {
+                search_backward(v, lb);
+                reorder();
+            }
+            clear_search();
+            if (!acyclic) return false;
+        }
+        m_g.add_edge(m_g[v], m_g[w], edge...);
+        m_sources[w].push_back(v);
+        return true;
+    }
+
+    // the order stays valid without the edge
+    void remove_edge(const vertex_type& v, const vertex_type& w) {
+        if (!m_g.has_edge(v, w)) return;
+        m_g.remove_edge(m_g[v], m_g[w]);
+        size_t source = v;
+        m_sources[w].remove_first_if(
+            [source](size_t u) { return u == source; });
+    }
+};
+
+}  // namespace Graph
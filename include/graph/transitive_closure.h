@@ -0,0 +1,125 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+#include "array.h"
+#include "bfs.h"
+#include "parallel.h"
+#include "strong_components.h"
+#include "two_dimensional_array.h"
+
+namespace Graph {
+
+/**
+ * Reflexive transitive closure of a digraph as a bit matrix over its strong
+ * components: reachable(v, w) is one lookup, and the vertices of a component
+ * share a row.
+ *
+ * The components are numbered in reverse topological order, so the row of
+ * component c is bit c ORed with the rows of its successors, which have
+ * smaller ids and set no bit above their own. Components of the same level
+ * (the longest path to a sink) don't reach one another, and their rows are
+ * computed in parallel.
+ */
+template <typename G>
+class TransitiveClosure {
+   private:
+    using word_type = uint64_t;
+    static const constexpr size_t word_bits = 64;
+
+    Array<size_t> m_component;
+    size_t m_components_count;
+    Two_dimensional_array<word_type> m_rows;
+
+    // the distinct successors of every component, as offsets into targets
+    void condense(const Bfs_ns::AdjacencyIndex& out, Array<size_t>& offsets,
+                  Array<size_t>& targets) const {
+        auto count = m_component.size();
+        Array<size_t> member_offsets(m_components_count + 1, 0);
+        for (size_t v = 0; v < count; ++v) ++member_offsets[m_component[v] + 1];
+        for (size_t c = 0; c < m_components_count; ++c)
+            member_offsets[c + 1] += member_offsets[c];
+        Array<size_t> members(count);
+        Array<size_t> next(m_components_count);
+        for (size_t c = 0; c < m_components_count; ++c)
+            next[c] = member_offsets[c];
+        for (size_t v = 0; v < count; ++v) members[next[m_component[v]]++] = v;
+
+        const size_t unseen = -1;
+        Array<size_t> seen(m_components_count, unseen);
+        offsets = Array<size_t>(m_components_count + 1);
+        targets = Array<size_t>(out.edges_count());
+        size_t p = 0;
+        for (size_t c = 0; c < m_components_count; ++c) {
+            offsets[c] = p;
+            seen[c] = c;
+            for (auto i = member_offsets[c]; i < member_offsets[c + 1]; ++i)
+                for (auto w = out.cbegin(members[i]); w != out.cend(members[i]);
+                     ++w) {
+                    auto d = m_component[*w];
+                    if (seen[d] == c) continue;
+                    seen[d] = c;
+                    targets[p++] = d;
+                }
+        }
+        offsets[m_components_count] = p;
+    }
+
+   public:
+    TransitiveClosure(const G& g, size_t threads = hardware_threads())
+        : m_component(strong_components_parallel(g, threads)),
+          m_components_count(0),
+          m_rows(0, 0) {
+        for (auto c : m_component)
+            m_components_count = std::max(m_components_count, c + 1);
+        Array<size_t> offsets, targets;
+        condense(Bfs_ns::AdjacencyIndex::out_edges(g), offsets, targets);
+
+        Array<size_t> levels(m_components_count, 0);
+        size_t levels_count = 0;
+        for (size_t c = 0; c < m_components_count; ++c) {
+            for (auto i = offsets[c]; i < offsets[c + 1]; ++i)
+                levels[c] = std::max(levels[c], levels[targets[i]] + 1);
+            levels_count = std::max(levels_count, levels[c] + 1);
+        }
+        // the components by level
+        Array<size_t> level_offsets(levels_count + 1, 0);
+        for (auto l : levels) ++level_offsets[l + 1];
+        for (size_t l = 0; l < levels_count; ++l)
+            level_offsets[l + 1] += level_offsets[l];
+        Array<size_t> by_level(m_components_count);
+        Array<size_t> next(levels_count);
+        for (size_t l = 0; l < levels_count; ++l) next[l] = level_offsets[l];
+        for (size_t c = 0; c < m_components_count; ++c)
+            by_level[next[levels[c]]++] = c;
+
+        auto words = (m_components_count + word_bits - 1) / word_bits;
+        m_rows = Two_dimensional_array<word_type>(m_components_count, words);
+        m_rows.fill(0);
+        ThreadPool pool(threads);
+        for (size_t l = 0; l < levels_count; ++l)
+            pool.for_each(
+                level_offsets[l + 1] - level_offsets[l], [&](size_t i) {
+                    auto c = by_level[level_offsets[l] + i];
+                    auto row = m_rows[c];
+                    row[c / word_bits] |= word_type(1) << c % word_bits;
+                    for (auto j = offsets[c]; j < offsets[c + 1]; ++j) {
+                        auto d = targets[j];
+                        auto successor = m_rows[d];
+                        for (size_t k = 0; k <= d / word_bits; ++k)
+                            row[k] |= successor[k];
+                    }
+                });
+    }
+
+    bool reachable(size_t v, size_t w) const {
+        auto c = m_component[v];
+        auto d = m_component[w];
+        return m_rows.get(c, d / word_bits) >> d % word_bits & 1;
+    }
+    size_t component(size_t v) const { return m_component[v]; }
+    size_t components_count() const { return m_components_count; }
+};
+
+}  // namespace Graph
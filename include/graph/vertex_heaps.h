@@ -0,0 +1,280 @@
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+#include "array.h"
+#include "graph_common.h"
+
+namespace Graph {
+
+/**
+ * The priority queues of the vertex searches (Spt, pq_mst, MaxFlow) are a
+ * template-template policy H<V, W>: H(size, weights) holds vertex pointers
+ * keyed by weights[*v], smallest first. push(v) inserts, move_up(v) follows
+ * a decrease of weights[*v], pop() extracts a minimum and clear() empties
+ * the heap without releasing its storage. VertexHeap is the default; the
+ * heaps below take a copy of the key on push and move_up.
+ */
+
+/**
+ * Indexed d-ary heap of (key, vertex) pairs. Sifting moves a hole instead
+ * of swapping, and the children of a node share one or two cache lines.
+ */
+template <typename V, typename W, size_t D>
+class DaryVertexHeap {
+   private:
+    struct Entry {
+        W m_key;
+        V m_v;
+    };
+
+    const Array<W>& m_weights;
+    Array<Entry> m_entries;
+    Array<size_t> m_positions;
+    size_t m_size;
+
+    void place(size_t i, Entry&& e) {
+        m_positions[*e.m_v] = i;
+        m_entries[i] = std::move(e);
+    }
+    void sift_up(size_t i, Entry&& e) {
+        for (; i > 0; i = (i - 1) / D) {
+            auto parent = (i - 1) / D;
+            if (!(e.m_key < m_entries[parent].m_key)) break;
+            place(i, std::move(m_entries[parent]));
+        }
+        place(i, std::move(e));
+    }
+    void sift_down(size_t i, Entry&& e) {
+        for (size_t first; (first = i * D + 1) < m_size;) {
+            auto last = std::min(first + D, m_size);
+            auto child = first;
+            for (auto c = first + 1; c < last; ++c)
+                if (m_entries[c].m_key < m_entries[child].m_key) child = c;
+            if (!(m_entries[child].m_key < e.m_key)) break;
+            place(i, std::move(m_entries[child]));
+            i = child;
+        }
+        place(i, std::move(e));
+    }
+
+   public:
+    DaryVertexHeap(size_t size, const Array<W>& weights)
+        : m_weights(weights),
+          m_entries(size),
+          m_positions(size),
+          m_size(0) {}
+
+    bool empty() const { return m_size == 0; }
+    size_t size() const { return m_size; }
+    void clear() { m_size = 0; }
+    void push(V v) { sift_up(m_size++, {m_weights[*v], v}); }
+    void move_up(V v) {
+        auto i = m_positions[*v];
+        sift_up(i, {m_weights[*v], v});
+    }
+    V pop() {
+        V v = m_entries[0].m_v;
+        if (--m_size) sift_down(0, std::move(m_entries[m_size]));
+        return v;
+    }
+};
+
+template <typename V, typename W>
+using QuaternaryVertexHeap = DaryVertexHeap<V, W, 4>;
+
+template <typename V, typename W>
+using OctonaryVertexHeap = DaryVertexHeap<V, W, 8>;
+
+/**
+ * Pairing heap over one preallocated node per vertex: push and move_up are
+ * a single link with the root, pop melds the children in two passes.
+ */
+template <typename V, typename W>
+class PairingVertexHeap {
+   private:
+    struct Node {
+        W m_key;
+        V m_v;
+        Node* m_child;
+        Node* m_next;
+        // previous sibling, or the parent for a first child
+        Node* m_previous;
+    };
+
+    const Array<W>& m_weights;
+    Array<Node> m_nodes;
+    Node* m_root;
+    size_t m_size;
+
+    static Node* link(Node* a, Node* b) {
+        if (!a) return b;
+        if (!b) return a;
+        if (b->m_key < a->m_key) std::swap(a, b);
+        b->m_previous = a;
+        b->m_next = a->m_child;
+        if (a->m_child) a->m_child->m_previous = b;
+        a->m_child = b;
+        a->m_next = a->m_previous = nullptr;
+        return a;
+    }
+    static Node* merge_pairs(Node* first) {
+        Node* paired = nullptr;
+        while (first) {
+            auto a = first;
+            auto b = a->m_next;
+            first = b ? b->m_next : nullptr;
+            a->m_next = a->m_previous = nullptr;
+            if (b) b->m_next = b->m_previous = nullptr;
+            auto pair = link(a, b);
+            // collect the pairs in reverse for the right-to-left pass
+            pair->m_next = paired;
+            paired = pair;
+        }
+        Node* root = nullptr;
+        while (paired) {
+            auto next = paired->m_next;
+            paired->m_next = nullptr;
+            root = link(root, paired);
+            paired = next;
+        }
+        return root;
+    }
+
+   public:
+    PairingVertexHeap(size_t size, const Array<W>& weights)
+        : m_weights(weights), m_nodes(size), m_root(nullptr), m_size(0) {}
+
+    bool empty() const { return m_size == 0; }
+    size_t size() const { return m_size; }
+    void clear() {
+        m_root = nullptr;
+        m_size = 0;
+    }
+    void push(V v) {
+        auto& node = m_nodes[*v];
+        node = {m_weights[*v], v, nullptr, nullptr, nullptr};
+        m_root = link(m_root, &node);
+        ++m_size;
+    }
+    void move_up(V v) {
+        auto node = &m_nodes[*v];
+        node->m_key = m_weights[*v];
+        if (node == m_root) return;
+        if (node->m_previous->m_child == node)
+            node->m_previous->m_child = node->m_next;
+        else
+            node->m_previous->m_next = node->m_next;
+        if (node->m_next) node->m_next->m_previous = node->m_previous;
+        node->m_next = node->m_previous = nullptr;
+        m_root = link(m_root, node);
+    }
+    V pop() {
+        auto root = m_root;
+        m_root = merge_pairs(root->m_child);
+        --m_size;
+        return root->m_v;
+    }
+};
+
+/**
+ * Radix heap for non-negative integer keys which are never smaller than the
+ * last popped key, as in Dijkstra's algorithm. Bucket i > 0 holds the keys
+ * whose highest bit differing from the last popped key is bit i - 1, so a
+ * key moves to lower buckets at most 64 times. Buckets are intrusive lists
+ * over the vertex indices.
+ */
+template <typename V, typename W>
+class RadixVertexHeap {
+   private:
+    static_assert(std::is_integral_v<W>, "radix heap keys must be integers");
+    static const constexpr size_t buckets_count = 65;
+    static const constexpr size_t none = -1;
+
+    struct Node {
+        uint64_t m_key;
+        V m_v;
+        size_t m_bucket;
+        size_t m_next;
+        size_t m_previous;
+    };
+
+    const Array<W>& m_weights;
+    Array<Node> m_nodes;
+    size_t m_heads[buckets_count];
+    uint64_t m_last;
+    size_t m_size;
+
+    size_t bucket(uint64_t key) const {
+        return key == m_last ? 0 : 64 - __builtin_clzll(key ^ m_last);
+    }
+    void insert(size_t i) {
+        auto& node = m_nodes[i];
+        node.m_bucket = bucket(node.m_key);
+        auto& head = m_heads[node.m_bucket];
+        node.m_previous = none;
+        node.m_next = head;
+        if (head != none) m_nodes[head].m_previous = i;
+        head = i;
+    }
+    void remove(size_t i) {
+        auto& node = m_nodes[i];
+        if (node.m_previous != none)
+            m_nodes[node.m_previous].m_next = node.m_next;
+        else
+            m_heads[node.m_bucket] = node.m_next;
+        if (node.m_next != none)
+            m_nodes[node.m_next].m_previous = node.m_previous;
+    }
+
+   public:
+    RadixVertexHeap(size_t size, const Array<W>& weights)
+        : m_weights(weights), m_nodes(size) {
+        clear();
+    }
+
+    bool empty() const { return m_size == 0; }
+    size_t size() const { return m_size; }
+    void clear() {
+        for (auto& head : m_heads) head = none;
+        m_last = 0;
+        m_size = 0;
+    }
+    void push(V v) {
+        auto& node = m_nodes[*v];
+        node.m_key = m_weights[*v];
+        node.m_v = v;
+        insert(*v);
+        ++m_size;
+    }
+    void move_up(V v) {
+        remove(*v);
+        m_nodes[*v].m_key = m_weights[*v];
+        insert(*v);
+    }
+    V pop() {
+        if (m_heads[0] == none) {
+            size_t b = 1;
+            for (; m_heads[b] == none; ++b)
+                ;
+            auto min = m_nodes[m_heads[b]].m_key;
+            for (auto i = m_heads[b]; i != none; i = m_nodes[i].m_next)
+                if (m_nodes[i].m_key < min) min = m_nodes[i].m_key;
+            m_last = min;
+            auto i = m_heads[b];
+            m_heads[b] = none;
+            while (i != none) {
+                auto next = m_nodes[i].m_next;
+                insert(i);
+                i = next;
+            }
+        }
+        auto i = m_heads[0];
+        remove(i);
+        --m_size;
+        return m_nodes[i].m_v;
+    }
+};
+
+}  // namespace Graph
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+
+#include "array.h"
+
+/**
+ * Open-addressing hash map with linear probing. Slots live in one flat
+ * array and erasing shifts the following entries back, so there are no
+ * tombstones. An empty map allocates nothing.
+ */
+template <typename K, typename V, typename H = std::hash<K>>
+class HashMap {
+   private:
+    struct Slot {
+        K m_key;
+        V m_value;
+    };
+    static const constexpr size_t min_capacity = 8;
+
+    Array<Slot> m_slots;
+    Array<unsigned char> m_used;
+    size_t m_size;
+    size_t m_shift;
+    H m_hash;
+
+    // Fibonacci hashing spreads the weak std::hash of integers.
+    size_t home(const K& key) const {
+        return (m_hash(key) * 11400714819323198485ull) >> m_shift;
+    }
+    size_t next(size_t i) const { return (i + 1) & (m_slots.size() - 1); }
+    size_t locate(const K& key) const {
+        size_t i = home(key);
+        for (; m_used[i] && !(m_slots[i].m_key == key); i = next(i))
+            ;
+        return i;
+    }
+    void rehash(size_t capacity) {
+        Array<Slot> slots(std::move(m_slots));
+        Array<unsigned char> used(std::move(m_used));
+        m_slots = Array<Slot>(capacity);
+        m_used = Array<unsigned char>(capacity, 0);
+        m_shift = 64;
+        for (size_t c = capacity; c > 1; c >>= 1) --m_shift;
+        for (size_t i = 0; i < slots.size(); ++i)
+            if (used[i]) {
+                auto j = locate(slots[i].m_key);
+                m_slots[j] = std::move(slots[i]);
+                m_used[j] = 1;
+            }
+    }
+
+   public:
+    HashMap() : m_size(0), m_shift(64) {}
+
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    void reserve(size_t size) {
+        size_t capacity = m_slots.size() ? m_slots.size() : min_capacity;
+        while (capacity * 3 < size * 4) capacity *= 2;
+        if (capacity != m_slots.size()) rehash(capacity);
+    }
+
+    V* find(const K& key) {
+        return const_cast<V*>(static_cast<const HashMap*>(this)->find(key));
+    }
+    const V* find(const K& key) const {
+        if (m_size == 0) return nullptr;
+        auto i = locate(key);
+        return m_used[i] ? &m_slots[i].m_value : nullptr;
+    }
+
+    /**
+     * Returns the value stored for the key and whether it was just inserted;
+     * an existing value is left untouched.
+     */
+    template <typename VV>
+    std::pair<V*, bool> insert(const K& key, VV&& value) {
+        reserve(m_size + 1);
+        auto i = locate(key);
+        if (m_used[i]) return {&m_slots[i].m_value, false};
+        m_slots[i].m_key = key;
+        m_slots[i].m_value = std::forward<VV>(value);
+        m_used[i] = 1;
+        ++m_size;
+        return {&m_slots[i].m_value, true};
+    }
+
+    bool erase(const K& key) {
+        if (m_size == 0) return false;
+        auto i = locate(key);
+        if (!m_used[i]) return false;
+        for (auto j = next(i); m_used[j]; j = next(j)) {
+            auto h = home(m_slots[j].m_key);
+            // move j back unless its home lies cyclically in (i, j]
+            if (i <= j ? (i < h && h <= j) : (i < h || h <= j)) continue;
+            m_slots[i] = std::move(m_slots[j]);
+            i = j;
+        }
+        m_used[i] = 0;
+        --m_size;
+        return true;
+    }
+
+    void clear() {
+        m_slots = Array<Slot>();
+        m_used = Array<unsigned char>();
+        m_size = 0;
+        m_shift = 64;
+    }
+
+    template <typename F>
+    void for_each(F f) const {
+        for (size_t i = 0; i < m_slots.size(); ++i)
+            if (m_used[i]) f(m_slots[i].m_key, m_slots[i].m_value);
+    }
+};
@@ -122,6 +122,7 @@ class HeapBase {
     }
     inline bool empty() const { return m_size == 0; }
     inline size_t size() const { return m_size; }
+    void clear() { m_size = 0; }
 };
 
 template <typename T, typename D>
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "array.h"
+
+inline size_t hardware_threads() {
+    auto count = std::thread::hardware_concurrency();
+    return count ? count : 1;
+}
+
+/**
+ * Splits [0, count) into one contiguous block per thread and calls
+ * f(block, begin, end) for each of them; the calling thread runs the first
+ * block. The first exception thrown by a block is rethrown after all
+ * threads have joined.
+ */
+template <typename F>
+void parallel_blocks(size_t count, size_t threads, F f) {
+    threads = std::max<size_t>(1, std::min(threads, count));
+    if (threads == 1) {
+        if (count) f(0, 0, count);
+        return;
+    }
+    Array<std::thread> workers(threads - 1);
+    Array<std::exception_ptr> errors(threads, nullptr);
+    auto run = [&](size_t block) {
+        try {
+            f(block, count * block / threads, count * (block + 1) / threads);
+        } catch (...) {
+            errors[block] = std::current_exception();
+        }
+    };
+    for (size_t block = 1; block < threads; ++block)
+        workers[block - 1] = std::thread(run, block);
+    run(0);
+    for (auto& worker : workers) worker.join();
+    for (auto& error : errors)
+        if (error) std::rethrow_exception(error);
+}
+
+/**
+ * Calls f(i) for every i in [0, count), spreading the indices over threads
+ * in contiguous blocks.
+ */
+template <typename F>
+void parallel_for(size_t count, F f, size_t threads = hardware_threads()) {
+    parallel_blocks(count, threads, [&f](size_t, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) f(i);
+    });
+}
+
+/**
+ * Fixed set of worker threads for algorithms which run many short parallel
+ * rounds, where starting threads for every round would dominate. blocks()
+ * has the semantics of parallel_blocks over the pool's threads.
+ */
+class ThreadPool {
+   private:
+    Array<std::thread> m_workers;
+    Array<std::exception_ptr> m_errors;
+    std::mutex m_mutex;
+    std::condition_variable m_start;
+    std::condition_variable m_done;
+    std::function<void(size_t)> m_task;
+    size_t m_blocks;
+    size_t m_generation;
+    size_t m_pending;
+    bool m_stop;
+
+    void run(size_t block) {
+        try {
+            m_task(block);
+        } catch (...) {
+            m_errors[block] = std::current_exception();
+        }
+    }
+    void work(size_t block) {
+        for (size_t generation = 0;;) {
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_start.wait(lock, [&] {
+                    return m_stop || m_generation != generation;
+                });
+                if (m_stop) return;
+                generation = m_generation;
+            }
+            if (block < m_blocks) run(block);
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (--m_pending == 0) m_done.notify_one();
+        }
+    }
+
+   public:
+    explicit ThreadPool(size_t threads = hardware_threads())
+        : m_workers(std::max<size_t>(1, threads) - 1),
+          m_errors(std::max<size_t>(1, threads), nullptr),
+          m_blocks(0),
+          m_generation(0),
+          m_pending(0),
+          m_stop(false) {
+        for (size_t i = 0; i < m_workers.size(); ++i)
+            m_workers[i] = std::thread(&ThreadPool::work, this, i + 1);
+    }
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_start.notify_all();
+        for (auto& worker : m_workers) worker.join();
+    }
+
+    size_t threads() const { return m_errors.size(); }
+
+    template <typename F>
+    void blocks(size_t count, F f) {
+        size_t blocks = std::max<size_t>(1, std::min(threads(), count));
+        if (blocks == 1) {
+            if (count) f(0, 0, count);
+            return;
+        }
+        m_task = [&](size_t block) {
+            f(block, count * block / blocks, count * (block + 1) / blocks);
+        };
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_blocks = blocks;
+            m_pending = m_workers.size();
+            ++m_generation;
+        }
+        m_start.notify_all();
+        run(0);
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_done.wait(lock, [&] { return m_pending == 0; });
+        }
+        for (auto& error : m_errors)
+            if (error) {
+                auto e = error;
+                for (auto& other : m_errors) other = nullptr;
+                std::rethrow_exception(e);
+            }
+    }
+    template <typename F>
+    void for_each(size_t count, F f) {
+        blocks(count, [&f](size_t, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) f(i);
+        });
+    }
+};
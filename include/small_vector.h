@@ -0,0 +1,159 @@
+#pragma once
+
+#include <cstddef>
+#include <iostream>
+#include <new>
+#include <utility>
+
+/**
+ * Growable contiguous array keeping its first N elements inline, so short
+ * sequences never touch the heap. Elements need not be default
+ * constructible; removal keeps the order of the remaining elements.
+ */
+template <typename T, size_t N>
+class SmallVector {
+   private:
+    static_assert(N > 0, "inline capacity must be positive");
+    static const constexpr int size_multiplier = 2;
+
+    alignas(T) unsigned char m_inline[N * sizeof(T)];
+    T* m_array;
+    size_t m_array_size;
+    size_t m_size;
+
+    T* inline_array() { return reinterpret_cast<T*>(m_inline); }
+    bool is_inline() const {
+        return m_array == reinterpret_cast<const T*>(m_inline);
+    }
+    void reallocate(size_t array_size) {
+        T* array = static_cast<T*>(::operator new(array_size * sizeof(T)));
+        for (size_t i = 0; i < m_size; ++i) {
+            new (array + i) T(std::move(m_array[i]));
+            m_array[i].~T();
+        }
+        if (!is_inline()) ::operator delete(m_array);
+        m_array = array;
+        m_array_size = array_size;
+    }
+    void destroy() {
+        for (size_t i = 0; i < m_size; ++i) m_array[i].~T();
+        if (!is_inline()) ::operator delete(m_array);
+        m_array = inline_array();
+        m_array_size = N;
+        m_size = 0;
+    }
+    void add_all(const SmallVector& o) {
+        reserve(o.m_size);
+        for (; m_size < o.m_size; ++m_size)
+            new (m_array + m_size) T(o.m_array[m_size]);
+    }
+    void take(SmallVector& o) {
+        if (o.is_inline()) {
+            for (; m_size < o.m_size; ++m_size) {
+                new (m_array + m_size) T(std::move(o.m_array[m_size]));
+                o.m_array[m_size].~T();
+            }
+        } else {
+            m_array = o.m_array;
+            m_array_size = o.m_array_size;
+            m_size = o.m_size;
+            o.m_array = o.inline_array();
+            o.m_array_size = N;
+        }
+        o.m_size = 0;
+    }
+
+   public:
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    SmallVector() : m_array(inline_array()), m_array_size(N), m_size(0) {}
+
+    SmallVector(const SmallVector& o) : SmallVector() { add_all(o); }
+    SmallVector& operator=(const SmallVector& o) {
+        if (this != &o) {
+            clear();
+            add_all(o);
+        }
+        return *this;
+    }
+    SmallVector(SmallVector&& o) : SmallVector() { take(o); }
+    SmallVector& operator=(SmallVector&& o) {
+        if (this != &o) {
+            destroy();
+            take(o);
+        }
+        return *this;
+    }
+
+    ~SmallVector() { destroy(); }
+
+    inline size_t size() const { return m_size; }
+    inline bool empty() const { return m_size == 0; }
+    inline size_t capacity() const { return m_array_size; }
+
+    inline iterator begin() { return m_array; }
+    inline iterator end() { return m_array + m_size; }
+    inline const_iterator cbegin() const { return m_array; }
+    inline const_iterator cend() const { return m_array + m_size; }
+
+    T& operator[](size_t i) { return m_array[i]; }
+    const T& operator[](size_t i) const { return m_array[i]; }
+
+    void reserve(size_t size) {
+        if (size > m_array_size) reallocate(size);
+    }
+
+    template <typename... Args>
+    void emplace_back(Args&&... args) {
+        if (m_size == m_array_size) reallocate(m_array_size * size_multiplier);
+        new (m_array + m_size) T(std::forward<Args>(args)...);
+        ++m_size;
+    }
+    template <typename TT>
+    void push_back(TT&& t) {
+        emplace_back(std::forward<TT>(t));
+    }
+
+    void erase(size_t index) {
+        for (size_t i = index + 1; i < m_size; ++i)
+            m_array[i - 1] = std::move(m_array[i]);
+        m_array[--m_size].~T();
+    }
+    template <typename F>
+    bool remove_first_if(F f) {
+        for (size_t i = 0; i < m_size; ++i)
+            if (f(m_array[i])) {
+                erase(i);
+                return true;
+            }
+        return false;
+    }
+    template <typename F>
+    size_t remove_if(F f) {
+        size_t j = 0;
+        for (size_t i = 0; i < m_size; ++i)
+            if (!f(m_array[i])) {
+                if (i != j) m_array[j] = std::move(m_array[i]);
+                ++j;
+            }
+        size_t removed = m_size - j;
+        for (; m_size > j; --m_size) m_array[m_size - 1].~T();
+        return removed;
+    }
+    void clear() {
+        for (size_t i = 0; i < m_size; ++i) m_array[i].~T();
+        m_size = 0;
+    }
+};
+
+template <typename T, size_t N>
+std::ostream& operator<<(std::ostream& stream, const SmallVector<T, N>& v) {
+    stream << "[";
+    auto it = v.cbegin();
+    if (it != v.cend()) {
+        stream << *it;
+        for (++it; it != v.cend(); ++it) stream << ", " << *it;
+    }
+    return stream << "]";
+}
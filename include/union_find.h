@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+
+#include "array.h"
+
+/**
+ * Disjoint sets of 0..size-1, with union by rank and path compression.
+ */
+class UnionFind {
+   private:
+    Array<size_t> m_parents;
+    Array<unsigned char> m_ranks;
+    size_t m_count;
+
+   public:
+    explicit UnionFind(size_t size)
+        : m_parents(size), m_ranks(size, 0), m_count(size) {
+        for (size_t i = 0; i < size; ++i) m_parents[i] = i;
+    }
+
+    size_t find(size_t i) {
+        auto root = i;
+        while (m_parents[root] != root) root = m_parents[root];
+        while (m_parents[i] != root) {
+            auto parent = m_parents[i];
+            m_parents[i] = root;
+            i = parent;
+        }
+        return root;
+    }
+    // false when i and j are in the same set already
+    bool unite(size_t i, size_t j) {
+        i = find(i);
+        j = find(j);
+        if (i == j) return false;
+        if (m_ranks[i] < m_ranks[j]) std::swap(i, j);
+        m_parents[j] = i;
+        if (m_ranks[i] == m_ranks[j]) ++m_ranks[i];
+        --m_count;
+        return true;
+    }
+    bool connected(size_t i, size_t j) { return find(i) == find(j); }
+    // the number of sets
+    size_t count() const { return m_count; }
+    size_t size() const { return m_parents.size(); }
+};
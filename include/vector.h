@@ -68,6 +68,9 @@ class Vector {
     ~Vector() { delete[] m_array; }
 
     inline size_t size() const { return m_size; }
+    inline bool empty() const { return m_size == 0; }
+    // keeps the storage for the next elements
+    void clear() { m_size = 0; }
 
     inline iterator begin() { return m_array; }
     inline iterator end() { return m_array + m_size; }
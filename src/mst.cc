@@ -0,0 +1,58 @@
+#include <iostream>
+#include <string>
+
+#include "adjacency_lists.h"
+#include "graph.h"
+#include "mst.h"
+#include "parallel.h"
+#include "random.h"
+#include "stopwatch.h"
+
+using namespace Graph;
+
+using G = AdjacencyLists<GraphType::GRAPH, size_t, double>;
+
+G random_graph(size_t vertices_count, size_t edges_count) {
+    G g;
+    for (size_t i = 0; i < vertices_count; ++i) g.create_vertex(i);
+    RandomSequenceGenerator<size_t> generator(101, 0, vertices_count - 1);
+    for (size_t i = 0; i < edges_count; ++i) {
+        auto v = generator.generate();
+        auto w = generator.generate();
+        if (v != w)
+            g.add_edge(g[v], g[w], double(generator.generate()) /
+                                       double(vertices_count));
+    }
+    return g;
+}
+
+template <typename M>
+double weight(const M& mst) {
+    double weight = 0;
+    for (auto v = mst.cbegin(); v != mst.cend(); ++v)
+        for (auto e = v->cedges_begin(); e != v->cedges_end(); ++e)
+            weight += e->edge().weight();
+    return weight;
+}
+
+template <typename F>
+void measure(const std::string& label, F f) {
+    Stopwatch stopwatch;
+    auto mst = f();
+    std::cout << label << " took " << stopwatch.read_out() << " mls, weight "
+              << weight(mst) << std::endl;
+}
+
+int main(int argc, const char** argv) {
+    size_t vertices_count = argc > 1 ? std::stoul(argv[1]) : 100000;
+    size_t degree = argc > 2 ? std::stoul(argv[2]) : 8;
+    auto g = random_graph(vertices_count, vertices_count * degree / 2);
+    std::cout << vertices_count << " vertices, average degree " << degree
+              << std::endl;
+
+    measure("pq mst", [&] { return pq_mst(g); });
+    measure("kruskal mst", [&] { return kruskal_mst(g); });
+    for (size_t threads = 1; threads <= hardware_threads(); threads *= 2)
+        measure("boruvka mst (" + std::to_string(threads) + " threads)",
+                [&] { return boruvka_mst(g, threads); });
+}
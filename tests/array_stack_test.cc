@@ -0,0 +1,38 @@
+#include "array_stack.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+TEST(Array_stack_test, base) {
+    ArrayStack<int> stack;
+    ASSERT_TRUE(stack.empty());
+    for (int i = 0; i < 100; ++i) stack.push(i);
+    ASSERT_EQ(100, stack.size());
+    ASSERT_EQ(99, stack.top());
+    for (int i = 99; i >= 50; --i) ASSERT_EQ(i, stack.pop());
+
+    auto copy = stack;
+    copy.top() = -1;
+    ASSERT_EQ(49, stack.top());
+    ASSERT_EQ(-1, copy.pop());
+    ASSERT_EQ(48, copy.top());
+
+    auto moved = std::move(copy);
+    ASSERT_TRUE(copy.empty());
+    ASSERT_EQ(49, moved.size());
+    moved.clear();
+    ASSERT_TRUE(moved.empty());
+}
+
+TEST(Array_stack_test, no_default_constructor) {
+    struct Item {
+        std::string m_s;
+        explicit Item(const std::string& s) : m_s(s) {}
+    };
+    ArrayStack<Item> stack;
+    for (int i = 0; i < 20; ++i) stack.emplace(std::to_string(i));
+    ASSERT_EQ("19", stack.top().m_s);
+    ASSERT_EQ("19", stack.pop().m_s);
+    ASSERT_EQ("18", stack.top().m_s);
+}
@@ -0,0 +1,129 @@
+#include "bellman_ford.h"
+
+#include "graph.h"
+#include "gtest/gtest.h"
+#include "test_utils.h"
+
+using namespace Graph;
+
+namespace {
+
+using G = AdjacencyLists<GraphType::DIGRAPH, size_t, long>;
+using E = G::vertex_type::const_edges_iterator::entry_type;
+
+const long max_weight = 1L << 40;
+
+template <typename F>
+void for_both_searches(const G& g, F f) {
+    for (size_t threads : {0, 1, 3}) {
+        BellmanFord<long, E> bellman_ford(g.vertices_count(), max_weight);
+        bellman_ford.add_source(0);
+        bool converged = threads == 0 ? bellman_ford.search(edge_arcs(g))
+                                      : bellman_ford.search_parallel(
+                                            edge_arcs(g), threads);
+        f(bellman_ford, converged);
+    }
+}
+
+void check_negative_cycle(const G& g, const ArrayCycle& cycle) {
+    ASSERT_FALSE(cycle.empty());
+    auto v = cycle.cbegin();
+    auto first = *v;
+    long length = 0;
+    size_t count = 0;
+    do {
+        auto from = *v;
+        ++v;
+        long weight = max_weight;
+        for (auto e = g[from].cedges_begin(); e != g[from].cedges_end(); ++e)
+            if (size_t(e->target()) == *v)
+                weight = std::min(weight, e->edge().weight());
+        ASSERT_GT(max_weight, weight);
+        length += weight;
+        ASSERT_GE(g.vertices_count(), ++count);
+    } while (*v != first);
+    ASSERT_GT(0, length);
+}
+
+}  // namespace
+
+TEST(Bellman_ford_test, negative_arcs) {
+    ShiftedGraph<G> shifted(400, 2000, 41);
+    auto& g = shifted.m_shifted;
+    auto& base = shifted.m_base;
+    auto& p = shifted.m_p;
+    Spt spt(base, base[0], max_weight);
+    for_both_searches(g, [&](auto& bellman_ford, bool converged) {
+        ASSERT_TRUE(converged);
+        ASSERT_FALSE(bellman_ford.has_cycle());
+        for (size_t v = 0; v < g.vertices_count(); ++v) {
+            if (spt.m_distance[v] == max_weight) {
+                ASSERT_EQ(max_weight, bellman_ford.m_distance[v]);
+                continue;
+            }
+            ASSERT_EQ(spt.m_distance[v] + p[0] - p[v],
+                      bellman_ford.m_distance[v]);
+            if (v == 0) continue;
+            auto parent = bellman_ford.m_parent[v];
+            auto& arc = bellman_ford.m_parent_arc[v];
+            ASSERT_EQ(parent, size_t(arc.source()));
+            ASSERT_EQ(v, size_t(arc.target()));
+            ASSERT_EQ(bellman_ford.m_distance[parent] + arc.edge().weight(),
+                      bellman_ford.m_distance[v]);
+        }
+    });
+}
+
+TEST(Bellman_ford_test, negative_cycle) {
+    ShiftedGraph<G> shifted(300, 1200, 41);
+    auto& g = shifted.m_shifted;
+    g.add_edge(g[0], g[20], 5);
+    g.add_edge(g[20], g[21], 3);
+    g.add_edge(g[21], g[22], -10);
+    g.add_edge(g[22], g[20], 4);
+    for_both_searches(g, [&](auto& bellman_ford, bool converged) {
+        ASSERT_FALSE(converged);
+        ASSERT_TRUE(bellman_ford.has_cycle());
+        check_negative_cycle(g, bellman_ford.negative_cycle());
+    });
+    check_negative_cycle(g, find_negative_cycle(g, g[0], max_weight));
+}
+
+TEST(Bellman_ford_test, unreachable_cycle_and_reset) {
+    G g;
+    for (size_t i = 0; i < 4; ++i) g.create_vertex(i);
+    g.add_edge(g[0], g[1], 2);
+    g.add_edge(g[2], g[3], -1);
+    g.add_edge(g[3], g[2], -1);
+    BellmanFord<long, E> bellman_ford(g.vertices_count(), max_weight);
+    bellman_ford.add_source(0);
+    ASSERT_TRUE(bellman_ford.search(edge_arcs(g)));
+    ASSERT_EQ(2, bellman_ford.m_distance[1]);
+    ASSERT_EQ(max_weight, bellman_ford.m_distance[2]);
+    ASSERT_TRUE(bellman_ford.negative_cycle().empty());
+
+    bellman_ford.reset();
+    bellman_ford.add_source(3);
+    ASSERT_FALSE(bellman_ford.search(edge_arcs(g)));
+    check_negative_cycle(g, bellman_ford.negative_cycle());
+}
+
+TEST(Bellman_ford_test, parallel_reuse) {
+    ShiftedGraph<G> shifted(200, 800, 41);
+    auto& g = shifted.m_shifted;
+    BellmanFord<long, E> expected(g.vertices_count(), max_weight);
+    BellmanFord<long, E> kept(g.vertices_count(), max_weight);
+    BellmanFord<long, E> shared(g.vertices_count(), max_weight);
+    ThreadPool pool(3);
+    for (size_t s = 0; s < g.vertices_count(); s += 37) {
+        for (auto* bellman_ford : {&expected, &kept, &shared}) {
+            bellman_ford->reset();
+            bellman_ford->add_source(s);
+        }
+        ASSERT_TRUE(expected.search(edge_arcs(g)));
+        ASSERT_TRUE(kept.search_parallel(edge_arcs(g), 3));
+        ASSERT_TRUE(shared.search_parallel(edge_arcs(g), pool));
+        ASSERT_EQ(expected.m_distance, kept.m_distance);
+        ASSERT_EQ(expected.m_distance, shared.m_distance);
+    }
+}
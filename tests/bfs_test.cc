@@ -0,0 +1,84 @@
+#include "bfs.h"
+
+#include "adjacency_lists.h"
+#include "adjacency_matrix.h"
+#include "csr.h"
+#include "graphs.h"
+#include "gtest/gtest.h"
+#include "test_utils.h"
+
+using namespace Graph;
+
+namespace {
+
+template <typename G>
+Array<size_t> reference_distances(const G& g, size_t source) {
+    Array<size_t> distances(g.vertices_count(), size_t(-1));
+    Array<size_t> queue(g.vertices_count());
+    size_t front = 0, back = 0;
+    distances[source] = 0;
+    queue[back++] = source;
+    while (front != back) {
+        auto& v = g[queue[front++]];
+        for (auto w = v.cbegin(); w != v.cend(); ++w)
+            if (distances[*w] == size_t(-1)) {
+                distances[*w] = distances[v] + 1;
+                queue[back++] = *w;
+            }
+    }
+    return distances;
+}
+
+template <typename G>
+void test_bfs(const G& g, size_t threads) {
+    using Bfs = ParallelBfs<G>;
+    Bfs bfs(g, threads);
+    for (auto direction : {Bfs::Direction::AUTOMATIC, Bfs::Direction::TOP_DOWN,
+                           Bfs::Direction::BOTTOM_UP}) {
+        bfs.set_direction(direction);
+        for (size_t source = 0; source < g.vertices_count(); source += 7) {
+            bfs.search(source);
+            auto expected = reference_distances(g, source);
+            for (size_t v = 0; v < g.vertices_count(); ++v) {
+                ASSERT_EQ(expected[v], bfs.m_distances[v]);
+                if (v == source || !bfs.is_reached(v)) continue;
+                auto p = bfs.m_parents[v];
+                ASSERT_EQ(expected[p] + 1, expected[v]);
+                ASSERT_TRUE(g.has_edge(g[p], g[v]));
+            }
+        }
+    }
+}
+
+}  // namespace
+
+TEST(Bfs_test, samples) {
+    using L = AdjacencyLists<GraphType::DIGRAPH, int>;
+    test_bfs(Samples::digraph_sample<L>(), 2);
+    test_bfs(Samples::dag_sample<L>(), 1);
+    test_bfs(Samples::strong_components_sample<
+                 AdjacencyMatrix<GraphType::DIGRAPH, int>>(),
+             3);
+}
+
+TEST(Bfs_test, random) {
+    using D = AdjacencyLists<GraphType::DIGRAPH, size_t>;
+    using G = AdjacencyLists<GraphType::GRAPH, size_t>;
+    auto d = random_graph<D>(500, 3000, 7);
+    auto g = random_graph<G>(500, 700, 7);
+    for (size_t threads : {1, 4}) {
+        test_bfs(d, threads);
+        test_bfs(g, threads);
+        test_bfs(Csr<GraphType::DIGRAPH, size_t>(d), threads);
+    }
+}
+
+TEST(Bfs_test, switches_direction) {
+    auto g =
+        random_graph<AdjacencyLists<GraphType::GRAPH, size_t>>(2000, 20000, 7);
+    ParallelBfs bfs(g, 4);
+    bfs.search(0);
+    ASSERT_LT(0, bfs.bottom_up_levels());
+    ASSERT_EQ(0, bfs.m_distances[0]);
+    ASSERT_EQ(0, bfs.m_parents[0]);
+}
@@ -0,0 +1,149 @@
+#include "biconnectivity.h"
+
+#include <set>
+#include <utility>
+
+#include "graph.h"
+#include "graphs.h"
+#include "gtest/gtest.h"
+#include "random.h"
+#include "test_utils.h"
+#include "union_find.h"
+
+using namespace Graph;
+
+namespace {
+
+using G = AdjacencyLists<GraphType::GRAPH, int>;
+
+template <typename B>
+std::set<std::pair<size_t, size_t>> bridge_pairs(const B& blocks) {
+    std::set<std::pair<size_t, size_t>> pairs;
+    for (auto e = blocks.m_bridges.cbegin(); e != blocks.m_bridges.cend(); ++e)
+        pairs.emplace(blocks.edge_source(*e), blocks.edge_target(*e));
+    return pairs;
+}
+
+template <typename B>
+std::set<size_t> cut_vertices(const B& blocks) {
+    auto& points = blocks.m_articulation_points;
+    return std::set<size_t>(points.cbegin(), points.cend());
+}
+
+template <typename A, typename B>
+void check_same(const A& expected, const B& actual) {
+    ASSERT_EQ(expected.edges_count(), actual.edges_count());
+    ASSERT_EQ(expected.m_components_count, actual.m_components_count);
+    for (size_t e = 0; e < expected.edges_count(); ++e)
+        ASSERT_EQ(expected.component(e), actual.component(e));
+    ASSERT_EQ(bridge_pairs(expected), bridge_pairs(actual));
+    ASSERT_EQ(cut_vertices(expected), cut_vertices(actual));
+}
+
+// the components left without the edge or the vertex skipped
+template <typename B>
+size_t components_without(const B& blocks, size_t vertices_count,
+                          size_t skipped_edge, size_t skipped_vertex) {
+    UnionFind sets(vertices_count);
+    for (size_t e = 0; e < blocks.edges_count(); ++e) {
+        auto v = blocks.edge_source(e), w = blocks.edge_target(e);
+        if (e != skipped_edge && v != skipped_vertex && w != skipped_vertex)
+            sets.unite(v, w);
+    }
+    return sets.count() - (skipped_vertex < vertices_count);
+}
+
+}  // namespace
+
+TEST(Biconnectivity_test, sample) {
+    auto g = Samples::bridges_sample<G>();
+    Biconnectivity blocks(g);
+    // the constructor numbers the vertices as their values come
+    std::set<std::pair<int, int>> bridges;
+    for (auto& b : bridge_pairs(blocks)) {
+        auto v = g[b.first].value(), w = g[b.second].value();
+        bridges.emplace(std::min(v, w), std::max(v, w));
+    }
+    std::set<std::pair<int, int>> expected{{0, 5}, {6, 7}, {11, 12}};
+    ASSERT_EQ(expected, bridges);
+    std::set<int> cuts;
+    for (auto v : cut_vertices(blocks)) cuts.insert(g[v].value());
+    ASSERT_EQ(std::set<int>({0, 4, 5, 6, 7, 11}), cuts);
+    ASSERT_EQ(7, blocks.m_components_count);
+    ASSERT_EQ(16, blocks.edges_count());
+    for (size_t v = 0; v < g.vertices_count(); ++v) {
+        size_t i = 0;
+        for (auto w = g[v].cbegin(); w != g[v].cend(); ++w, ++i) {
+            auto e = blocks.edge(v, i);
+            ASSERT_EQ(std::min<size_t>(v, *w), blocks.edge_source(e));
+            ASSERT_EQ(std::max<size_t>(v, *w), blocks.edge_target(e));
+        }
+    }
+    // the cycle 0 - 1 - 2 - 6 and the triangle 3 - 4 - 5
+    auto block = [&](int v, int w) {
+        for (size_t i = 0; i < g.vertices_count(); ++i) {
+            if (g[i].value() != v) continue;
+            size_t j = 0;
+            for (auto t = g[i].cbegin(); t != g[i].cend(); ++t, ++j)
+                if (t->value() == w) return blocks.component(blocks.edge(i, j));
+        }
+        return size_t(-1);
+    };
+    ASSERT_EQ(block(0, 1), block(2, 6));
+    ASSERT_EQ(block(1, 2), block(6, 0));
+    ASSERT_EQ(block(5, 3), block(4, 3));
+    ASSERT_NE(block(0, 1), block(5, 3));
+    ASSERT_NE(block(0, 1), block(0, 5));
+
+    for (size_t threads : {1, 3})
+        check_same(blocks, ParallelBiconnectivity(g, threads));
+}
+
+TEST(Biconnectivity_test, random_graphs) {
+    for (size_t edges : {70, 100, 160}) {
+        const size_t n = 80;
+        G g;
+        for (size_t i = 0; i < n; ++i) g.create_vertex(i);
+        RandomSequenceGenerator<size_t> generator(edges, 0, n - 1);
+        for (size_t i = 0; i < edges; ++i)
+            g.add_edge(g[generator.generate()], g[generator.generate()]);
+        g.add_edge(g[3], g[3]);
+
+        Biconnectivity blocks(g);
+        auto whole = components_without(blocks, n, size_t(-1), size_t(-1));
+        std::set<std::pair<size_t, size_t>> bridges;
+        for (size_t e = 0; e < blocks.edges_count(); ++e)
+            if (components_without(blocks, n, e, size_t(-1)) > whole)
+                bridges.emplace(blocks.edge_source(e), blocks.edge_target(e));
+        ASSERT_EQ(bridges, bridge_pairs(blocks));
+        std::set<size_t> cuts;
+        for (size_t v = 0; v < n; ++v) {
+            // an isolated vertex leaves one component less
+            auto isolated = g[v].cbegin() == g[v].cend();
+            if (components_without(blocks, n, size_t(-1), v) + isolated >
+                whole)
+                cuts.insert(v);
+        }
+        ASSERT_EQ(cuts, cut_vertices(blocks));
+
+        for (size_t threads : {1, 2, 4})
+            check_same(blocks, ParallelBiconnectivity(g, threads));
+    }
+}
+
+TEST(Biconnectivity_test, deep_and_wide) {
+    // a long path closed into a cycle halfway, a star and a pendant chain
+    const size_t n = 3000;
+    G g;
+    for (size_t i = 0; i < n; ++i) g.create_vertex(i);
+    for (size_t i = 0; i + 1 < n / 2; ++i) g.add_edge(g[i], g[i + 1]);
+    g.add_edge(g[n / 4], g[n / 2 - 1]);
+    for (size_t i = n / 2 + 1; i < n - 10; ++i) g.add_edge(g[n / 2], g[i]);
+    g.add_edge(g[n / 2 + 1], g[n / 2 + 2]);
+    for (size_t i = n - 10; i + 1 < n; ++i) g.add_edge(g[i], g[i + 1]);
+    g.add_edge(g[0], g[n - 10]);
+
+    Biconnectivity blocks(g);
+    for (size_t threads : {1, 4})
+        check_same(blocks, ParallelBiconnectivity(g, threads));
+}
@@ -0,0 +1,216 @@
+#include "contraction_hierarchy.h"
+
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+
+#include "graph.h"
+#include "gtest/gtest.h"
+#include "test_utils.h"
+
+using namespace Graph;
+
+namespace {
+
+using G = AdjacencyLists<GraphType::DIGRAPH, size_t, long>;
+
+long random_weight(size_t r) { return 1 + long(r); }
+
+long edge_weight(const G& g, size_t v, size_t w) {
+    for (auto e = g[v].cedges_begin(); e != g[v].cedges_end(); ++e)
+        if (size_t(e->target()) == w) return e->edge().weight();
+    return -1;
+}
+
+using Arc = ContractionHierarchy<long>::Arc;
+using ArcLists = Array<Array<Arc>>;
+
+// the saved image of a hierarchy given by its ranks and arcs
+std::string image(const Array<size_t>& rank, const ArcLists& up,
+                  const ArcLists& down) {
+    using namespace Contraction_ns;
+    Header h;
+    std::memcpy(h.m_magic, Header::magic_value, sizeof(h.m_magic));
+    h.m_version = Header::current_version;
+    h.m_weight_size = sizeof(long);
+    h.m_vertices_count = rank.size();
+    h.m_up_count = h.m_down_count = 0;
+    for (size_t v = 0; v < rank.size(); ++v) {
+        h.m_up_count += up[v].size();
+        h.m_down_count += down[v].size();
+    }
+    std::stringstream ss;
+    ss.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    write_array(ss, rank);
+    for (auto* lists : {&up, &down}) {
+        Array<size_t> offsets(rank.size() + 1, 0);
+        Vector<Arc> arcs;
+        for (size_t v = 0; v < rank.size(); ++v) {
+            auto& list = (*lists)[v];
+            for (auto a = list.cbegin(); a != list.cend(); ++a)
+                arcs.push_back(*a);
+            offsets[v + 1] = arcs.size();
+        }
+        write_array(ss, offsets);
+        Array<Arc> flat(arcs.size());
+        std::copy(arcs.begin(), arcs.end(), flat.begin());
+        write_arcs(ss, flat);
+    }
+    return ss.str();
+}
+
+template <typename W>
+void test_against_spt(const G& g, const ContractionHierarchy<W>& ch) {
+    const long max_weight = 1L << 40;
+    ChQuery query(ch);
+    for (size_t s = 0; s < g.vertices_count(); s += 29) {
+        Spt spt(g, g[s], max_weight);
+        for (size_t t = 0; t < g.vertices_count(); t += 3) {
+            bool found = query.search(s, t);
+            ASSERT_EQ(spt.m_distance[t] != max_weight, found);
+            if (!found) continue;
+            ASSERT_EQ(spt.m_distance[t], query.distance());
+            auto path = query.path();
+            ASSERT_EQ(s, path[0]);
+            ASSERT_EQ(t, path[path.size() - 1]);
+            long length = 0;
+            for (size_t i = 1; i < path.size(); ++i) {
+                auto weight = edge_weight(g, path[i - 1], path[i]);
+                ASSERT_LE(0, weight);
+                length += weight;
+            }
+            ASSERT_EQ(query.distance(), length);
+        }
+    }
+}
+
+}  // namespace
+
+TEST(Contraction_hierarchy_test, queries) {
+    auto g = random_graph<G>(400, 1600, 23, random_weight);
+    for (size_t threads : {1, 3}) {
+        ContractionHierarchy ch(g, threads);
+        ASSERT_EQ(g.vertices_count(), ch.vertices_count());
+        Array<bool> ranked(g.vertices_count(), false);
+        for (size_t v = 0; v < g.vertices_count(); ++v) {
+            ASSERT_FALSE(ranked[ch.rank(v)]);
+            ranked[ch.rank(v)] = true;
+            for (auto a = ch.up_begin(v); a != ch.up_end(v); ++a)
+                ASSERT_LT(ch.rank(v), ch.rank(a->m_vertex));
+            for (auto a = ch.down_begin(v); a != ch.down_end(v); ++a)
+                ASSERT_LT(ch.rank(v), ch.rank(a->m_vertex));
+        }
+        test_against_spt(g, ch);
+    }
+}
+
+TEST(Contraction_hierarchy_test, save_and_load) {
+    auto g = random_graph<G>(300, 1000, 23, random_weight);
+    ContractionHierarchy ch(g, 2);
+    std::stringstream ss;
+    ch.save(ss);
+    auto loaded = ContractionHierarchy<long>::load(ss);
+    ASSERT_EQ(ch.arcs_count(), loaded.arcs_count());
+    for (size_t v = 0; v < g.vertices_count(); ++v)
+        ASSERT_EQ(ch.rank(v), loaded.rank(v));
+    test_against_spt(g, loaded);
+
+    std::stringstream truncated(ss.str().substr(0, 100));
+    ASSERT_THROW(ContractionHierarchy<long>::load(truncated),
+                 ContractionHierarchyException);
+    std::stringstream garbage("not a hierarchy at all, just some text");
+    ASSERT_THROW(ContractionHierarchy<long>::load(garbage),
+                 ContractionHierarchyException);
+    std::stringstream doubles;
+    ch.save(doubles);
+    ASSERT_THROW(ContractionHierarchy<int>::load(doubles),
+                 ContractionHierarchyException);
+
+    // a shortcut through its own head, which has no arc from its tail
+    using Arc = ContractionHierarchy<long>::Arc;
+    size_t n = ch.vertices_count();
+    const Arc* shortcut = nullptr;
+    for (size_t v = 0; v < n && !shortcut; ++v)
+        for (auto a = ch.up_begin(v); a != ch.up_end(v); ++a)
+            if (a->m_middle != Contraction_ns::no_middle) {
+                shortcut = a;
+                break;
+            }
+    ASSERT_NE(nullptr, shortcut);
+    auto image = ss.str();
+    size_t position = sizeof(Contraction_ns::Header) +
+                      (2 * n + 1) * sizeof(size_t) +
+                      (shortcut - ch.up_begin(0)) *
+                          Contraction_ns::arc_record_size<long> +
+                      sizeof(uint64_t);
+    std::memcpy(&image[position], &shortcut->m_vertex, sizeof(size_t));
+    std::stringstream corrupt(image);
+    ASSERT_THROW(ContractionHierarchy<long>::load(corrupt),
+                 ContractionHierarchyException);
+}
+
+TEST(Contraction_hierarchy_test, saved_arcs_unpadded) {
+    // an int weight leaves padding in Arc, none in the file
+    using GI = AdjacencyLists<GraphType::DIGRAPH, size_t, int>;
+    auto g = random_graph<GI>(50, 200, 23, [](size_t r) { return 1 + int(r); });
+    ContractionHierarchy ch(g, 1);
+    std::stringstream ss;
+    ch.save(ss);
+    size_t n = ch.vertices_count();
+    ASSERT_EQ(sizeof(Contraction_ns::Header) + (3 * n + 2) * sizeof(size_t) +
+                  ch.arcs_count() * (2 * sizeof(uint64_t) + sizeof(int)),
+              ss.str().size());
+    auto loaded = ContractionHierarchy<int>::load(ss);
+    std::stringstream again;
+    loaded.save(again);
+    ASSERT_EQ(ss.str(), again.str());
+}
+
+TEST(Contraction_hierarchy_test, load_checks_ranks) {
+    using Contraction_ns::no_middle;
+    auto load = [](const std::string& image) {
+        std::stringstream ss(image);
+        return ContractionHierarchy<long>::load(ss);
+    };
+    // 0 -> 1 -> 2, 1 contracted first with the shortcut 0 -> 2 through it
+    ArcLists up{Array<Arc>{{2, 2, 1}}, Array<Arc>{{2, 1, no_middle}},
+                Array<Arc>{}};
+    ArcLists down{Array<Arc>{}, Array<Arc>{{0, 1, no_middle}}, Array<Arc>{}};
+    auto ch = load(image({1, 0, 2}, up, down));
+    ChQuery query(ch);
+    ASSERT_TRUE(query.search(0, 2));
+    ASSERT_EQ(2, query.distance());
+    ASSERT_EQ("[0, 1, 2]", stringify(query.path()));
+
+    // the ranks are no permutation
+    ASSERT_THROW(load(image({1, 1, 2}, up, down)),
+                 ContractionHierarchyException);
+    // the middle ranks above an end
+    ASSERT_THROW(load(image({0, 1, 2}, up, down)),
+                 ContractionHierarchyException);
+    // 0 -> 1 through 2 and 0 -> 2 through 1, unpacking into each other
+    ArcLists cyclic_up{Array<Arc>{{1, 2, 2}, {2, 2, 1}},
+                       Array<Arc>{{2, 1, no_middle}},
+                       Array<Arc>{{1, 1, no_middle}}};
+    ArcLists cyclic_down{Array<Arc>{}, Array<Arc>{{0, 2, 2}},
+                         Array<Arc>{{0, 2, 1}}};
+    for (auto& rank : {Array<size_t>{2, 0, 1}, Array<size_t>{2, 1, 0}})
+        ASSERT_THROW(load(image(rank, cyclic_up, cyclic_down)),
+                     ContractionHierarchyException);
+}
+
+TEST(Contraction_hierarchy_test, same_vertex_and_unreachable) {
+    G g;
+    for (size_t i = 0; i < 3; ++i) g.create_vertex(i);
+    g.add_edge(g[0], g[1], 2);
+    ContractionHierarchy ch(g, 1);
+    ChQuery query(ch);
+    ASSERT_TRUE(query.search(1, 1));
+    ASSERT_EQ(0, query.distance());
+    ASSERT_EQ(1, query.path().size());
+    ASSERT_TRUE(query.search(0, 1));
+    ASSERT_EQ(2, query.distance());
+    ASSERT_FALSE(query.search(1, 0));
+    ASSERT_FALSE(query.search(0, 2));
+    ASSERT_EQ(0, query.path().size());
+}
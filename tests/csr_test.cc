@@ -0,0 +1,131 @@
+#include "csr.h"
+
+#include "graphs.h"
+#include "gtest/gtest.h"
+#include "network_flow.h"
+#include "test_utils.h"
+
+using namespace Graph;
+
+TEST(Csr_test, base) {
+    using G = AdjacencyLists<GraphType::GRAPH, int, int>;
+    G g;
+    auto& v1 = g.create_vertex(1);
+    auto& v2 = g.create_vertex(2);
+    auto& v3 = g.create_vertex(3);
+    g.add_edge(v1, v2, 4).add_edge(v1, v3, 8);
+
+    Csr<GraphType::GRAPH, int, int> csr(g);
+    ASSERT_EQ(3, csr.vertices_count());
+    ASSERT_EQ(4, csr.edges_count());
+    ASSERT_EQ(2, csr[0].degree());
+    ASSERT_EQ(4, csr.get_edge(csr[0], csr[1])->weight());
+    ASSERT_EQ(8, csr.get_edge(csr[2], csr[0])->weight());
+    ASSERT_EQ(nullptr, csr.get_edge(csr[1], csr[2]));
+    ASSERT_TRUE(csr.has_edge(csr[1], csr[0]));
+
+    csr.get_edge(0, 1)->set_weight(10);
+    std::stringstream ss;
+    for (auto e = csr[0].cedges_begin(); e != csr[0].cedges_end(); ++e)
+        ss << e->source() << " " << e->target() << " " << e->edge().weight()
+           << "; ";
+    ASSERT_EQ("1 2 10; 1 3 8; ", ss.str());
+
+    auto copy = csr;
+    ASSERT_EQ(1, copy[1].index());
+    ASSERT_EQ(10, copy.get_edge(copy[0], copy[1])->weight());
+}
+
+TEST(Csr_test, edge_list) {
+    using G = Csr<GraphType::DIGRAPH, int, double>;
+    Array<G::edge_list_item_type> edges{
+        {0, 1, .41}, {0, 5, .29}, {1, 2, .51}, {1, 4, .32}, {2, 3, .5},
+        {3, 0, .45}, {3, 5, .38}, {4, 2, .32}, {4, 3, .36}, {5, 1, .29},
+        {5, 4, .21}};
+    G g({0, 1, 2, 3, 4, 5}, edges.cbegin(), edges.cend());
+    std::stringstream ss;
+    print_representation(g, reset_with_new_line(ss));
+    ASSERT_EQ(R"(
+0: 1 5
+1: 2 4
+2: 3
+3: 0 5
+4: 2 3
+5: 1 4
+)",
+              ss.str());
+    print_representation(invert(g), reset_with_new_line(ss));
+    ASSERT_EQ(R"(
+0: 3
+1: 0 5
+2: 1 4
+3: 2 4
+4: 1 5
+5: 0 3
+)",
+              ss.str());
+
+    Spt spt(g, g[0], 10);
+    ASSERT_EQ("[0, 0.41, 0.82, 0.86, 0.5, 0.29]", stringify(spt.m_distance));
+}
+
+TEST(Csr_test, digraph) {
+    using G = AdjacencyLists<GraphType::DIGRAPH, int>;
+    using C = Csr<GraphType::DIGRAPH, int>;
+
+    auto g = Samples::strong_components_sample<G>();
+    C csr(g);
+    ASSERT_EQ(trace(g), trace(csr));
+    ASSERT_EQ(stringify(topological_sort_relabel(g)),
+              stringify(topological_sort_relabel(csr)));
+    ASSERT_EQ(stringify(strong_components_kosaraju(g)),
+              stringify(strong_components_kosaraju(csr)));
+    ASSERT_EQ(stringify(strong_components_tarjan(g)),
+              stringify(strong_components_tarjan(csr)));
+
+    g = Samples::dag_sample<G>();
+    C dag(g);
+    ASSERT_TRUE(is_dag(dag));
+    TopologicalSorter<G> sorter(g);
+    sorter.search();
+    TopologicalSorter<C> csr_sorter(dag);
+    csr_sorter.search();
+    ASSERT_EQ(stringify(sorter.m_post_i), stringify(csr_sorter.m_post_i));
+}
+
+TEST(Csr_test, weighted_graph) {
+    using G = AdjacencyLists<GraphType::GRAPH, int, double>;
+    using C = Csr<GraphType::GRAPH, int, double>;
+
+    auto g = Samples::weighted_graph_sample<G>();
+    C csr(g);
+    ASSERT_EQ(trace(pq_mst(g)), trace(pq_mst(csr)));
+
+    g = Samples::spt_sample<G>();
+    C spt_csr(g);
+    Spt spt(g, g[0], g.vertices_count());
+    Spt csr_spt(spt_csr, spt_csr[0], spt_csr.vertices_count());
+    ASSERT_EQ(stringify(spt.m_distance), stringify(csr_spt.m_distance));
+    ASSERT_EQ(trace(compose_path_tree(g, spt.m_spt.cbegin() + 1,
+                                      spt.m_spt.cend())),
+              trace(compose_path_tree(spt_csr, csr_spt.m_spt.cbegin() + 1,
+                                      csr_spt.m_spt.cend())));
+}
+
+TEST(Csr_test, max_flow) {
+    auto g = Samples::flow_sample();
+    CsrNetworkFlow<int, int> csr(g);
+    Network_flow_ns::MaxFlow m(csr, csr[0], csr[5], csr.vertices_count() * 10);
+    std::stringstream ss;
+    print_representation(csr, reset_with_new_line(ss));
+    ASSERT_EQ(R"(
+0: ->1(2/2) ->2(2/3) 
+1: <-0(2/2) ->3(1/3) ->4(1/1) 
+2: <-0(2/3) ->3(1/1) ->4(1/1) 
+3: <-1(1/3) <-2(1/1) ->5(2/2) 
+4: <-1(1/1) <-2(1/1) ->5(2/3) 
+5: <-3(2/2) <-4(2/3) 
+)",
+              ss.str());
+    ASSERT_EQ(csr.get_link(1, 3), csr.get_link(3, 1));
+}
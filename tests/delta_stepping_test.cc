@@ -0,0 +1,69 @@
+#include "delta_stepping.h"
+
+#include "graph.h"
+#include "graphs.h"
+#include "gtest/gtest.h"
+#include "test_utils.h"
+
+using namespace Graph;
+
+namespace {
+
+template <typename G, typename W>
+void test_against_spt(const G& g, W max_weight) {
+    for (size_t threads : {1, 3})
+        for (W delta : {W(0), W(1), max_weight}) {
+            // the engine is reused across the sources
+            DeltaSteppingEngine<G> engine(g, threads, delta);
+            for (size_t s = 0; s < g.vertices_count(); s += 41) {
+                Spt expected(g, g[s], max_weight);
+                DeltaStepping<G> spt(engine, g[s], max_weight);
+                for (size_t v = 0; v < g.vertices_count(); ++v) {
+                    ASSERT_EQ(expected.m_distance[v], spt.m_distance[v]);
+                    auto& e = spt.m_spt[v];
+                    ASSERT_EQ(!expected.m_spt[v].m_target, !e.m_target);
+                    if (!e.m_target) continue;
+                    ASSERT_EQ(v, size_t(e.target()));
+                    ASSERT_EQ(spt.m_distance[e.source()] + e.edge().weight(),
+                              spt.m_distance[v]);
+                }
+            }
+        }
+    DeltaStepping<G> spt(g, g[0], max_weight, 2);
+    ASSERT_EQ(Spt(g, g[0], max_weight).m_distance, spt.m_distance);
+}
+
+}  // namespace
+
+TEST(Delta_stepping_test, integer_weights) {
+    using G = AdjacencyLists<GraphType::DIGRAPH, size_t, long>;
+    auto g =
+        random_graph<G>(400, 2000, 13, [](size_t r) { return 1 + long(r); });
+    test_against_spt(g, 1L << 40);
+}
+
+TEST(Delta_stepping_test, real_weights) {
+    using G = AdjacencyLists<GraphType::GRAPH, size_t, double>;
+    auto g = random_graph<G>(300, 600, 13,
+                             [](size_t r) { return (1 + r) * 0.01; });
+    test_against_spt(g, 1e9);
+}
+
+TEST(Delta_stepping_test, full_spts) {
+    using G = AdjacencyLists<GraphType::GRAPH, int, double>;
+    auto g = Samples::spt_sample<G>();
+    FullSpts<G, DeltaStepping<G>> full_spts(g, 1);
+    auto diameter = full_spts.diameter();
+    ASSERT_EQ(1, diameter.first->value());
+    ASSERT_EQ(3, diameter.second->value());
+    ASSERT_EQ(.86, full_spts.distance(*diameter.first, *diameter.second));
+
+    // one engine on the caller's pool serves every search
+    ThreadPool pool(3);
+    DeltaSteppingEngine<G> engine(g, pool);
+    FullSpts<G, DeltaStepping<G>> shared(g, engine, 1);
+    FullSpts<G> expected(g, 1);
+    for (size_t v = 0; v < g.vertices_count(); ++v)
+        for (size_t w = 0; w < g.vertices_count(); ++w)
+            ASSERT_EQ(expected.distance(v, w), shared.distance(v, w));
+}
@@ -0,0 +1,112 @@
+#include "edge_list.h"
+
+#include <sstream>
+
+#include "graphs.h"
+#include "gtest/gtest.h"
+#include "test_utils.h"
+
+using namespace Graph;
+
+TEST(Edge_list_test, text) {
+    std::stringstream input(R"(# comment
+10 20
+20 30
+
+10 30 ignored
+% another comment
+30 10
+40 20)");
+    for (size_t threads = 1; threads <= 4; ++threads)
+        for (size_t chunk_size : {3, 7, 1000}) {
+            input.clear();
+            input.seekg(0);
+            EdgeList<int> list(threads, chunk_size);
+            list.read_text(input);
+            ASSERT_EQ(5, list.edges_count());
+            ASSERT_EQ("[10, 20, 30, 40]", stringify(list.values()));
+
+            auto g = list.to_csr<GraphType::DIGRAPH>();
+            std::stringstream ss;
+            print_representation(g, reset_with_new_line(ss));
+            ASSERT_EQ(R"(
+10: 1 2
+20: 2
+30: 0
+40: 1
+)",
+                      ss.str());
+        }
+}
+
+TEST(Edge_list_test, weighted) {
+    std::stringstream input("a b 0.5\nb c 1.5\na b 2\nc a 3\n");
+    EdgeList<std::string, Adjacency_lists_ns::Edge<double>> list(2);
+    list.read_text(input);
+
+    AdjacencyLists<GraphType::GRAPH, std::string, double> g;
+    list.fill(g);
+    ASSERT_FALSE(g.bulk_loading());
+    ASSERT_EQ(3, g.vertices_count());
+    ASSERT_EQ(0.5, g.get_edge(g[1], g[0])->weight());
+    ASSERT_EQ(1.5, g.get_edge(g[1], g[2])->weight());
+    ASSERT_EQ(3, g.get_edge(g[0], g[2])->weight());
+    ASSERT_EQ(2, count_vertex_edges(g[0]));
+
+    std::stringstream bad("a b\n");
+    ASSERT_THROW(list.read_text(bad), EdgeListException);
+    std::stringstream bad_weight("a b x\n");
+    ASSERT_THROW(list.read_text(bad_weight), EdgeListException);
+}
+
+TEST(Edge_list_test, fill_appends) {
+    EdgeList<int> list;
+    for (int i = 1; i < 10; ++i) list.add_edge(0, i);
+    list.add_edge(3, 0);
+    list.add_edge(0, 3);
+
+    AdjacencyLists<GraphType::DIGRAPH, int> g;
+    g.create_vertex(-1);
+    list.fill(g);
+    ASSERT_EQ(11, g.vertices_count());
+    ASSERT_EQ(9, count_vertex_edges(g[1]));
+    ASSERT_TRUE(g.has_edge(g[4], g[1]));
+
+    AdjacencyLists<GraphType::GRAPH, int, bool, Adjacency_lists_ns::Edge<bool>,
+                   Adjacency_lists_ns::ForwardListLinks>
+        u;
+    list.fill(u);
+    ASSERT_EQ(9, count_vertex_edges(u[0]));
+    ASSERT_EQ(1, count_vertex_edges(u[3]));
+}
+
+TEST(Edge_list_test, binary) {
+    std::stringstream input;
+    auto write = [&input](int s, int t, double w) {
+        input.write(reinterpret_cast<const char*>(&s), sizeof(s));
+        input.write(reinterpret_cast<const char*>(&t), sizeof(t));
+        input.write(reinterpret_cast<const char*>(&w), sizeof(w));
+    };
+    write(7, 5, 0.25);
+    write(5, 3, 0.5);
+    write(3, 7, 0.75);
+    EdgeList<int, Adjacency_lists_ns::Edge<double>> list(1, 32);
+    list.read_binary(input);
+    ASSERT_EQ("[7, 5, 3]", stringify(list.values()));
+    auto g = list.to_csr<GraphType::DIGRAPH>();
+    ASSERT_EQ(0.75, g.get_edge(g[2], g[0])->weight());
+
+    input.clear();
+    input.write("xyz", 3);
+    ASSERT_THROW(list.read_binary(input), EdgeListException);
+}
+
+TEST(Edge_list_test, constructor) {
+    using G = AdjacencyLists<GraphType::DIGRAPH, int>;
+    G g;
+    Constructor c(g);
+    c.add_edge(5, 6).add_edge(6, 7).add_edge(5, 7);
+    ASSERT_EQ(3, g.vertices_count());
+    ASSERT_EQ(2, c.get_vertex(7).index());
+    ASSERT_THROW(c.get_vertex(8), std::runtime_error);
+}
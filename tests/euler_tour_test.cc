@@ -0,0 +1,106 @@
+#include "euler_tour.h"
+
+#include "csr.h"
+#include "graph.h"
+#include "graphs.h"
+#include "gtest/gtest.h"
+#include "random.h"
+#include "test_utils.h"
+
+using namespace Graph;
+
+namespace {
+
+using G = AdjacencyLists<GraphType::GRAPH, int>;
+using D = AdjacencyLists<GraphType::DIGRAPH, int>;
+
+// the tour is closed and takes every arc of g as many times as g has it
+template <typename Graph>
+void check_tour(const Graph& g, const Vector<size_t>& tour, size_t s) {
+    auto count = g.vertices_count();
+    Array<size_t> arcs(count * count, 0);
+    size_t edges = 0;
+    for (auto v = g.cbegin(); v != g.cend(); ++v)
+        for (auto w = v->cbegin(); w != v->cend(); ++w) {
+            ++arcs[*v * count + *w];
+            ++edges;
+        }
+    if (is_undirected_v<Graph>) edges /= 2;
+    ASSERT_EQ(edges + 1, tour.size());
+    ASSERT_EQ(s, tour[0]);
+    ASSERT_EQ(s, tour[tour.size() - 1]);
+    for (size_t i = 1; i < tour.size(); ++i) {
+        auto v = tour[i - 1];
+        auto w = tour[i];
+        ASSERT_LT(0, arcs[v * count + w]);
+        --arcs[v * count + w];
+        if (is_undirected_v<Graph>) --arcs[w * count + v];
+    }
+}
+
+}  // namespace
+
+TEST(Euler_tour_test, sample) {
+    auto g = Samples::euler_tour_sample<G>();
+    Vector<size_t> expected;
+    for (auto v : {0, 6, 4, 3, 2, 4, 5, 0, 2, 1, 0})
+        expected.push_back(g[v]);
+    auto tour = EulerTour<G>(g).tour(g[0]);
+    ASSERT_EQ(expected.size(), tour.size());
+    for (size_t i = 0; i < tour.size(); ++i) ASSERT_EQ(expected[i], tour[i]);
+    // the graph keeps its edges
+    check_tour(g, EulerTour<G>(g).tour(g[3]), g[3]);
+
+    g.add_edge(g[0], g[3]);
+    ASSERT_TRUE(EulerTour<G>(g).tour(g[0]).empty());
+}
+
+TEST(Euler_tour_test, loops) {
+    // two triangles on 0
+    G g;
+    for (int i = 0; i < 5; ++i) g.create_vertex(i);
+    g.add_edge(g[0], g[1]).add_edge(g[1], g[1]).add_edge(g[1], g[2]);
+    g.add_edge(g[2], g[0]).add_edge(g[0], g[0]).add_edge(g[0], g[3]);
+    g.add_edge(g[3], g[4]).add_edge(g[4], g[4]).add_edge(g[4], g[0]);
+    EulerTour<G> euler_tour(g);
+    for (size_t s = 0; s < 5; ++s) check_tour(g, euler_tour.tour(s), s);
+}
+
+TEST(Euler_tour_test, digraphs) {
+    D d;
+    for (int i = 0; i < 4; ++i) d.create_vertex(i);
+    d.add_edge(d[0], d[1]).add_edge(d[1], d[2]).add_edge(d[2], d[0]);
+    d.add_edge(d[0], d[3]).add_edge(d[3], d[0]).add_edge(d[2], d[2]);
+    check_tour(d, EulerTour<D>(d).tour(0), 0);
+    check_tour(d, EulerTour<D>(d).tour(2), 2);
+    // walked in place over any representation
+    using C = Csr<GraphType::DIGRAPH, int>;
+    C c(d);
+    check_tour(c, EulerTour<C>(c).tour(1), 1);
+
+    // even out degrees, unbalanced
+    d.add_edge(d[1], d[3]).add_edge(d[3], d[1]).add_edge(d[1], d[0]);
+    d.add_edge(d[0], d[2]);
+    ASSERT_TRUE(EulerTour<D>(d).tour(0).empty());
+}
+
+TEST(Euler_tour_test, complete_graphs) {
+    // even degrees, and equal in and out degrees
+    const size_t n = 9;
+    G g;
+    D d;
+    for (size_t i = 0; i < n; ++i) {
+        g.create_vertex(i);
+        d.create_vertex(i);
+    }
+    for (size_t v = 0; v < n; ++v)
+        for (size_t w = 0; w < n; ++w)
+            if (v != w) {
+                g.add_edge(g[v], g[w]);
+                d.add_edge(d[v], d[w]);
+            }
+    for (size_t s : {0, 4}) {
+        check_tour(g, EulerTour<G>(g).tour(s), s);
+        check_tour(d, EulerTour<D>(d).tour(s), s);
+    }
+}
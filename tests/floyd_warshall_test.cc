@@ -0,0 +1,109 @@
+#include "floyd_warshall.h"
+
+#include "graph.h"
+#include "graphs.h"
+#include "gtest/gtest.h"
+#include "random.h"
+#include "test_utils.h"
+
+using namespace Graph;
+
+namespace {
+
+// the weights 1 to 100 times scale
+template <typename T>
+auto scaled_weights(T scale) {
+    return [scale](size_t r) { return T(1 + r % 100) * scale; };
+}
+
+template <typename G, typename W>
+void test_against_full_spts(const G& g, W max_weight) {
+    FullSpts expected(g, max_weight);
+    for (size_t threads : {1, 3}) {
+        FloydWarshall fw(g, max_weight, threads);
+        for (size_t v = 0; v < g.vertices_count(); ++v)
+            for (size_t w = 0; w < g.vertices_count(); ++w) {
+                ASSERT_EQ(expected.distance(v, w), fw.distance(v, w));
+                ASSERT_EQ(!expected.path_r(v, w).m_target,
+                          !fw.path_r(v, w).m_target);
+                // walk back from w, summing the weights
+                W length = 0;
+                for (size_t t = w; fw.path_r(v, t).m_target;) {
+                    auto& e = fw.path_r(v, t);
+                    ASSERT_EQ(t, size_t(e.target()));
+                    length += e.edge().weight();
+                    t = e.source();
+                }
+                if (v == w || fw.path_r(v, w).m_target) {
+                    ASSERT_EQ(fw.distance(v, w), length);
+                }
+            }
+    }
+}
+
+}  // namespace
+
+TEST(Floyd_warshall_test, integer_weights) {
+    using G = AdjacencyLists<GraphType::DIGRAPH, size_t, long>;
+    test_against_full_spts(random_graph<G>(150, 1200, 29, scaled_weights(1L)),
+                           1L << 40);
+    using G32 = AdjacencyLists<GraphType::DIGRAPH, size_t, int>;
+    test_against_full_spts(random_graph<G32>(100, 400, 29, scaled_weights(1)),
+                           1 << 29);
+}
+
+TEST(Floyd_warshall_test, real_weights) {
+    // multiples of a power of two add up exactly in any order
+    using G = AdjacencyLists<GraphType::GRAPH, size_t, double>;
+    auto g = random_graph<G>(140, 500, 29, scaled_weights(1. / 64));
+    test_against_full_spts(g, 1e9);
+    using GF = AdjacencyLists<GraphType::DIGRAPH, size_t, float>;
+    test_against_full_spts(random_graph<GF>(70, 500, 29, scaled_weights(.5f)),
+                           1e9f);
+}
+
+TEST(Floyd_warshall_test, diameter) {
+    using G = AdjacencyLists<GraphType::GRAPH, int, double>;
+    auto g = Samples::spt_sample<G>();
+    FloydWarshall fw(g, 1);
+    auto diameter = fw.diameter();
+    ASSERT_EQ(1, diameter.first->value());
+    ASSERT_EQ(3, diameter.second->value());
+    ASSERT_EQ(.86, fw.distance(*diameter.first, *diameter.second));
+    std::stringstream ss;
+    ss << diameter.first->value();
+    for (auto v = diameter.first; v != diameter.second;) {
+        v = &fw.path(*v, *diameter.second).source();
+        ss << " - " << v->value();
+    }
+    ASSERT_EQ("1 - 0 - 3", ss.str());
+}
+
+TEST(Floyd_warshall_test, kernels) {
+    using namespace Floyd_warshall_ns;
+    const size_t n = 37;
+    RandomSequenceGenerator<size_t> generator(31, 0, 1000);
+    auto test = [&](auto zero) {
+        using T = decltype(zero);
+        Array<T> b(n), c(n);
+        Array<uint32_t> b_last(n), c_last(n, 0);
+        for (size_t j = 0; j < n; ++j) {
+            b[j] = T(generator.generate());
+            c[j] = T(generator.generate() + 500);
+            b_last[j] = j + 1;
+        }
+        auto expected = c;
+        auto expected_last = c_last;
+        min_plus_scalar(expected.begin(), expected_last.begin(), b.cbegin(),
+                        b_last.cbegin(), T(100), n);
+        select_min_plus<T>()(c.begin(), c_last.begin(), b.cbegin(),
+                             b_last.cbegin(), T(100), n);
+        ASSERT_EQ(stringify(expected), stringify(c));
+        ASSERT_EQ(stringify(expected_last), stringify(c_last));
+    };
+    test(0.);
+    test(0.f);
+    test(0);
+    test(0L);
+    test(short(0));
+}
@@ -190,6 +190,35 @@ void test_digraph() {
               stringify(strong_components_tarjan(g)));
 }
 
+TEST(Graphs_algorithms_test, all_pairs_shortest_paths) {
+    using G = AdjacencyLists<GraphType::DIGRAPH, size_t>;
+    const size_t n = 150;
+    auto g = random_graph<G>(n, 2 * n, 3);
+    ParallelBfs bfs(g, 1);
+    for (size_t threads : {1, 3}) {
+        auto matrix = find_shortest_paths(g, threads);
+        for (size_t w = 0; w < n; ++w) {
+            bfs.search(w);
+            for (size_t v = 0; v < n; ++v) {
+                auto path = matrix.find_path(g[v], g[w]);
+                ASSERT_EQ(!bfs.is_reached(v), path.empty());
+                if (path.empty()) continue;
+                size_t length = 0;
+                const G::vertex_type* previous = nullptr;
+                for (auto t = path.cbegin(); t != path.cend(); ++t, ++length) {
+                    // the tree of w is walked against the edges
+                    if (previous) {
+                        ASSERT_TRUE(g.has_edge(**t, *previous));
+                    }
+                    previous = *t;
+                }
+                ASSERT_EQ(g[w], *previous);
+                ASSERT_EQ(bfs.m_distances[v] + 1, length);
+            }
+        }
+    }
+}
+
 TEST(Graphs_algorithms_test, digraph) {
     test_digraph<AdjacencyMatrix<GraphType::DIGRAPH, int>>();
     test_digraph<AdjacencyLists<GraphType::DIGRAPH, int>>();
@@ -211,6 +240,84 @@ TEST(Graphs_algorithms_test, digraph) {
               ss.str());
 }
 
+TEST(Graphs_algorithms_test, transitive_closure_past_inline_links) {
+    // rows longer than the inline links of a vertex move its storage
+    using L = AdjacencyLists<GraphType::DIGRAPH, int>;
+    L l;
+    for (int i = 0; i < 12; ++i) l.create_vertex(i);
+    for (int i = 1; i < 6; ++i) l.add_edge(l[0], l[i]);
+    for (int i = 6; i < 12; ++i) l.add_edge(l[i - 1], l[i]);
+    l.add_edge(l[11], l[0]);
+    auto closure = dfs_transitive_closure(l);
+    ASSERT_EQ(graph_to_str_matrix(closure),
+              graph_to_str_matrix(warshall_transitive_closure(l)));
+    for (int i = 0; i < 12; ++i)
+        ASSERT_TRUE(closure.has_edge(closure[0], closure[i]));
+}
+
+TEST(Graphs_algorithms_test, bit_matrix_transitive_closure) {
+    using M = AdjacencyMatrix<GraphType::DIGRAPH, int>;
+    using L = AdjacencyLists<GraphType::DIGRAPH, int>;
+    auto test = [](const M& m, const L& l) {
+        ASSERT_EQ(graph_to_str_matrix(dfs_transitive_closure(l)),
+                  graph_to_str_matrix(warshall_transitive_closure(m)));
+    };
+    test(Samples::digraph_sample<M>(), Samples::digraph_sample<L>());
+    test(Samples::dag_sample<M>(), Samples::dag_sample<L>());
+    test(Samples::strong_components_sample<M>(),
+         Samples::strong_components_sample<L>());
+
+    M m;
+    L l;
+    const int n = 200;
+    for (int i = 0; i < n; ++i) m.create_vertex(i), l.create_vertex(i);
+    for (int i = 0; i < n; ++i) {
+        int j = (i * 7 + 3) % n;
+        if (i % 5) m.add_edge(m[i], m[j]), l.add_edge(l[i], l[j]);
+        if (i % 50 == 49) continue;
+        m.add_edge(m[i], m[i + 1]), l.add_edge(l[i], l[i + 1]);
+    }
+    test(m, l);
+}
+
+TEST(Graphs_algorithms_test, or_row_kernels) {
+    using namespace Adjacency_matrix_ns;
+    const size_t n = 11;
+    uint64_t source[n], target[n], expected[n];
+    for (size_t w = 0; w < n; ++w) {
+        source[w] = 0x9e3779b97f4a7c15ull * (w + 1);
+        target[w] = expected[w] = 0xc2b2ae3d27d4eb4full * (w + 3);
+    }
+    or_row_scalar(expected, source, n);
+    select_or_row()(target, source, n);
+    for (size_t w = 0; w < n; ++w) ASSERT_EQ(expected[w], target[w]);
+}
+
+TEST(Graphs_algorithms_test, deep_chain) {
+    const size_t n = 300000;
+    AdjacencyLists<GraphType::DIGRAPH, size_t> d;
+    AdjacencyLists<GraphType::GRAPH, size_t> g;
+    for (size_t i = 0; i < n; ++i) d.create_vertex(i), g.create_vertex(i);
+    for (size_t i = 0; i + 1 < n; ++i)
+        d.add_edge(d[i], d[i + 1]), g.add_edge(g[i], g[i + 1]);
+
+    auto order = topological_sort_relabel(d);
+    for (size_t i = 0; i < n; ++i) ASSERT_EQ(i, order[i]);
+    auto components = strong_components_tarjan(d);
+    for (size_t i = 1; i < n; ++i)
+        ASSERT_NE(components[i - 1], components[i]);
+    ASSERT_TRUE(has_simple_path(d, d[0], d[n - 1]));
+    ASSERT_FALSE(has_simple_path(d, d[n - 1], d[0]));
+
+    auto bridges = find_bridges(g);
+    size_t bridges_count = 0;
+    for (auto b = bridges.cbegin(); b != bridges.cend(); ++b) ++bridges_count;
+    ASSERT_EQ(n - 1, bridges_count);
+    d.add_edge(d[n - 1], d[0]);
+    components = strong_components_tarjan(d);
+    for (size_t i = 1; i < n; ++i) ASSERT_EQ(components[0], components[i]);
+}
+
 template <typename G>
 void test_weighted_graph() {
     std::stringstream ss;
@@ -226,7 +333,6 @@ void test_weighted_graph() {
     5 (0.18) (down)
   1 (0.21) (down)
  2 (0.29) (down)
-  0 (0.29) (back)
 )",
               ss.str());
 
@@ -0,0 +1,150 @@
+#include "graph_file.h"
+
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <type_traits>
+
+#include "graphs.h"
+#include "gtest/gtest.h"
+#include "test_utils.h"
+
+using namespace Graph;
+
+std::string temp_path(const std::string& name) {
+    return testing::TempDir() + name;
+}
+
+TEST(Graph_file_test, digraph) {
+    using G = AdjacencyLists<GraphType::DIGRAPH, int>;
+    auto g = Samples::strong_components_sample<G>();
+    auto path = temp_path("digraph.bin");
+    write_graph_file(g, path);
+
+    MappedGraph<GraphType::DIGRAPH, int> mapped(path);
+    ASSERT_EQ(g.vertices_count(), mapped.vertices_count());
+    ASSERT_EQ(trace(g), trace(mapped));
+    ASSERT_EQ(stringify(strong_components_tarjan(g)),
+              stringify(strong_components_tarjan(mapped)));
+
+    auto moved = std::move(mapped);
+    ASSERT_EQ(trace(g), trace(moved));
+    std::remove(path.c_str());
+}
+
+TEST(Graph_file_test, weighted_graph) {
+    using G = AdjacencyLists<GraphType::GRAPH, int, double>;
+    auto g = Samples::weighted_graph_sample<G>();
+    auto path = temp_path("weighted_graph.bin");
+    write_graph_file(g, path);
+
+    using M = MappedGraph<GraphType::GRAPH, int, double>;
+    M mapped(path);
+    ASSERT_EQ(trace(pq_mst(g)), trace(pq_mst(mapped)));
+    for (auto v = g.cbegin(); v != g.cend(); ++v)
+        for (auto e = v->cedges_begin(); e != v->cedges_end(); ++e)
+            ASSERT_EQ(e->edge().weight(),
+                      mapped.get_edge(mapped[*v], mapped[e->target()])
+                          ->weight());
+
+    // the mapped graph is read-only; detach gives a copy to change
+    static_assert(std::is_same_v<decltype(mapped[0]), const M::vertex_type&>);
+    static_assert(std::is_same_v<decltype(mapped.get_edge(mapped[0],
+                                                          mapped[1])),
+                                 const M::edge_type*>);
+    auto copy = mapped.detach();
+    ASSERT_EQ(trace(g), trace(copy));
+    auto edge = copy.get_edge(copy[0], *copy[0].begin());
+    auto weight = edge->weight();
+    edge->set_weight(weight + 1);
+    ASSERT_EQ(weight + 1, copy.get_edge(copy[0], *copy[0].begin())->weight());
+    ASSERT_EQ(weight,
+              mapped.get_edge(mapped[0], *mapped[0].cbegin())->weight());
+
+    Csr<GraphType::GRAPH, int, double> csr(g);
+    write_graph_file(csr, path);
+    MappedGraph<GraphType::GRAPH, int, double> from_csr(path);
+    ASSERT_EQ(trace(csr), trace(from_csr));
+    auto copy_path = temp_path("weighted_graph_copy.bin");
+    write_graph_file(from_csr, copy_path);
+    ASSERT_EQ(trace(csr), trace(M(copy_path)));
+    std::remove(copy_path.c_str());
+
+    ASSERT_THROW((MappedGraph<GraphType::DIGRAPH, int, double>(path)),
+                 GraphFileException);
+    ASSERT_THROW((MappedGraph<GraphType::GRAPH, int, int>(path)),
+                 GraphFileException);
+    std::remove(path.c_str());
+    ASSERT_THROW((MappedGraph<GraphType::GRAPH, int, double>(path)),
+                 GraphFileException);
+}
+
+TEST(Graph_file_test, corrupt) {
+    using G = AdjacencyLists<GraphType::DIGRAPH, int>;
+    using M = MappedGraph<GraphType::DIGRAPH, int>;
+    using Graph_file_ns::Header;
+    auto g = Samples::strong_components_sample<G>();
+    auto path = temp_path("corrupt.bin");
+    write_graph_file(g, path);
+    std::string image;
+    {
+        std::ifstream in(path, std::ios::binary);
+        image.assign(std::istreambuf_iterator<char>(in), {});
+    }
+    Header h;
+    std::memcpy(&h, image.data(), sizeof(h));
+
+    // writes the image with a value patched in at position
+    auto corrupt = [&](size_t position, uint64_t value) {
+        auto copy = image;
+        std::memcpy(&copy[position], &value, sizeof(value));
+        std::ofstream(path, std::ios::binary) << copy;
+    };
+    auto target = [&](size_t e) {
+        return h.m_targets_position + e * sizeof(size_t);
+    };
+    auto offset = [&](size_t v) {
+        return h.m_offsets_position + v * sizeof(size_t);
+    };
+    ASSERT_NO_THROW(M{path});
+    corrupt(offsetof(Header, m_targets_position), image.size() + 64);
+    ASSERT_THROW(M{path}, GraphFileException);
+    corrupt(offsetof(Header, m_edges_position), h.m_edges_position + 8);
+    ASSERT_THROW(M{path}, GraphFileException);
+    corrupt(offsetof(Header, m_edges_count), uint64_t(1) << 61);
+    ASSERT_THROW(M{path}, GraphFileException);
+    corrupt(offsetof(Header, m_vertices_count), uint64_t(-1));
+    ASSERT_THROW(M{path}, GraphFileException);
+    corrupt(offset(0), 1);
+    ASSERT_THROW(M{path}, GraphFileException);
+    corrupt(offset(2), h.m_edges_count + 1);
+    ASSERT_NO_THROW((M{path, FileCheck::HEADER}));
+    ASSERT_THROW(M{path}, GraphFileException);
+    corrupt(offset(h.m_vertices_count), h.m_edges_count - 1);
+    ASSERT_THROW(M{path}, GraphFileException);
+    corrupt(target(h.m_edges_count - 1), h.m_vertices_count);
+    ASSERT_NO_THROW((M{path, FileCheck::HEADER}));
+    ASSERT_THROW(M{path}, GraphFileException);
+    std::remove(path.c_str());
+}
+
+TEST(Graph_file_test, flow) {
+    auto g = Samples::flow_sample();
+    Network_flow_ns::MaxFlow m(g, g[0], g[5], g.vertices_count() * 10);
+    auto path = temp_path("flow.bin");
+    write_graph_file(g, path);
+
+    using E = Adjacency_lists_ns::FlowEdge<int>;
+    MappedGraph<GraphType::DIGRAPH, int, int, E> mapped(path);
+    std::stringstream ss;
+    for (auto v = mapped.cbegin(); v != mapped.cend(); ++v)
+        for (auto e = v->cedges_begin(); e != v->cedges_end(); ++e)
+            ss << *v << "->" << e->target() << "(" << e->edge().flow() << "/"
+               << e->edge().cap() << ") ";
+    ASSERT_EQ(
+        "0->1(2/2) 0->2(2/3) 1->3(1/3) 1->4(1/1) 2->3(1/1) 2->4(1/1) "
+        "3->5(2/2) 4->5(2/3) ",
+        ss.str());
+    std::remove(path.c_str());
+}
@@ -128,3 +128,178 @@ TEST(Graph_test, base) {
     bool_edges_test<AdjacencyMatrix<GraphType::GRAPH, int>>();
     bool_edges_test<AdjacencyMatrix<GraphType::DIGRAPH, int>>(true);
 }
+
+TEST(Graph_test, links_policies) {
+    using Adjacency_lists_ns::Edge;
+    using Adjacency_lists_ns::ForwardListLinks;
+    using Adjacency_lists_ns::SmallVectorLinks;
+    weighted_graphs_test<AdjacencyLists<GraphType::GRAPH, int, int, Edge<int>,
+                                        ForwardListLinks>>();
+    weighted_graphs_test<AdjacencyLists<GraphType::DIGRAPH, int, int,
+                                        Edge<int>, ForwardListLinks>>(true);
+    weighted_graphs_test<AdjacencyLists<GraphType::GRAPH, int, int, Edge<int>,
+                                        SmallVectorLinks<1>>>();
+    bool_edges_test<AdjacencyLists<GraphType::GRAPH, int, bool, Edge<bool>,
+                                   ForwardListLinks>>();
+    bool_edges_test<AdjacencyLists<GraphType::DIGRAPH, int, bool, Edge<bool>,
+                                   SmallVectorLinks<1>>>(true);
+}
+
+template <typename G>
+std::string representation(const G& g) {
+    std::stringstream ss;
+    print_representation(g, ss);
+    return ss.str();
+}
+
+TEST(Graph_test, bulk_load) {
+    using G = AdjacencyLists<GraphType::GRAPH, int, int>;
+    G g;
+    for (int i = 0; i < 4; ++i) g.create_vertex(i);
+    g.begin_bulk_load();
+    ASSERT_TRUE(g.bulk_loading());
+    g.add_edge(g[0], g[1], 1)
+        .add_edge(g[0], g[2], 2)
+        .add_edge(g[1], g[0], 3)
+        .add_edge(g[2], g[2], 4)
+        .add_edge(g[2], g[2], 5)
+        .add_edge(g[0], g[2], 6)
+        .add_edge(g[3], g[1], 7);
+    g.commit_bulk_load();
+    ASSERT_FALSE(g.bulk_loading());
+    ASSERT_EQ(R"(0: 1(1) 2(2) 
+1: 0(1) 3(7) 
+2: 0(2) 2(4) 2(4) 
+3: 1(7) 
+)",
+              representation(g));
+    g.add_edge(g[1], g[3], 8);
+    ASSERT_EQ(7, g.get_edge(g[1], g[3])->weight());
+
+    using D = AdjacencyLists<GraphType::DIGRAPH, int, bool,
+                             Adjacency_lists_ns::Edge<bool>,
+                             Adjacency_lists_ns::ForwardListLinks>;
+    D d;
+    for (int i = 0; i < 3; ++i) d.create_vertex(i);
+    d.begin_bulk_load();
+    d.add_edge(d[0], d[1]).add_edge(d[1], d[1]).add_edge(d[0], d[1]);
+    d.add_edge(d[1], d[1]).add_edge(d[0], d[2]).add_edge(d[0], d[1]);
+    d.commit_bulk_load();
+    ASSERT_EQ(R"(0: 1 2 
+1: 1 
+2: 
+)",
+              representation(d));
+}
+
+TEST(Graph_test, hub_index) {
+    using G = AdjacencyLists<GraphType::DIGRAPH, int, int>;
+    G g;
+    for (int i = 0; i < 20; ++i) g.create_vertex(i);
+    g.set_hub_index_threshold(4);
+    ASSERT_EQ(4, g.hub_index_threshold());
+    for (int i = 1; i < 20; ++i) g.add_edge(g[0], g[i], i);
+    for (int i = 1; i < 20; ++i) {
+        g.add_edge(g[0], g[i], -i);
+        ASSERT_EQ(i, g.get_edge(g[0], g[i])->weight());
+    }
+    ASSERT_FALSE(g.has_edge(g[0], g[0]));
+
+    g.remove_edge(g[0], g[5]);
+    ASSERT_FALSE(g.has_edge(g[0], g[5]));
+    ASSERT_EQ(19, g.get_edge(g[0], g[19])->weight());
+    g.add_edge(g[0], g[5], 50);
+    ASSERT_EQ(50, g.get_edge(g[0], g[5])->weight());
+
+    auto copy = g;
+    copy.get_edge(copy[0], copy[7])->set_weight(70);
+    ASSERT_EQ(70, copy.get_edge(copy[0], copy[7])->weight());
+    ASSERT_EQ(7, g.get_edge(g[0], g[7])->weight());
+
+    g.set_hub_index_threshold(G::no_hub_index);
+    ASSERT_EQ(50, g.get_edge(g[0], g[5])->weight());
+    for (int i = 1; i < 4; ++i) g.remove_edge(g[0], g[i]);
+    g.set_hub_index_threshold(0);
+    ASSERT_EQ(nullptr, g.get_edge(g[0], g[2]));
+    ASSERT_EQ(4, g.get_edge(g[0], g[4])->weight());
+}
+
+TEST(Graph_test, hub_index_bulk_load) {
+    using G = AdjacencyLists<GraphType::GRAPH, int, int>;
+    G g;
+    for (int i = 0; i < 12; ++i) g.create_vertex(i);
+    g.set_hub_index_threshold(4);
+    for (int i = 1; i < 8; ++i) g.add_edge(g[0], g[i], i);
+    g.add_edge(g[0], g[0], 0);
+    g.begin_bulk_load();
+    for (int i = 8; i < 12; ++i) {
+        g.add_edge(g[0], g[i], i);
+        ASSERT_TRUE(g.has_edge(g[0], g[i]));
+        ASSERT_EQ(i, g.get_edge(g[0], g[i])->weight());
+    }
+    g.add_edge(g[0], g[9], -9);
+    g.remove_edge(g[0], g[3]);
+    ASSERT_FALSE(g.has_edge(g[0], g[3]));
+    ASSERT_EQ(10, g.get_edge(g[0], g[10])->weight());
+    g.commit_bulk_load();
+    ASSERT_EQ(9, g.get_edge(g[0], g[9])->weight());
+    ASSERT_EQ(11, g.get_edge(g[11], g[0])->weight());
+
+    // removals repair the index in place, self loops included
+    g.remove_edge(g[0], g[0]);
+    ASSERT_FALSE(g.has_edge(g[0], g[0]));
+    for (int i = 1; i < 12; ++i) {
+        if (i == 3) continue;
+        ASSERT_EQ(i, g.get_edge(g[0], g[i])->weight());
+    }
+    g.remove_edge(g[0], g[1]);
+    g.add_edge(g[0], g[1], 100);
+    for (int i = 2; i < 12; ++i) {
+        g.remove_edge(g[0], g[i]);
+        ASSERT_FALSE(g.has_edge(g[0], g[i]));
+        ASSERT_EQ(100, g.get_edge(g[0], g[1])->weight());
+    }
+}
+
+TEST(Graph_test, bool_matrix_get_edge) {
+    using G = AdjacencyMatrix<GraphType::DIGRAPH, int>;
+    G g;
+    for (int i = 0; i < 70; ++i) g.create_vertex(i);
+    g.add_edge(g[3], g[65]);
+    const G& c = g;
+    ASSERT_TRUE(g.get_edge(g[3], g[65])->weight());
+    ASSERT_TRUE(c.get_edge(c[3], c[65])->exists());
+    ASSERT_EQ(nullptr, g.get_edge(g[65], g[3]));
+    g.remove_edge(g[3], g[65]);
+    ASSERT_EQ(nullptr, c.get_edge(c[3], c[65]));
+}
+
+TEST(Graph_test, matrix_growth) {
+    using G = AdjacencyMatrix<GraphType::DIGRAPH, int, int>;
+    G g;
+    for (int i = 0; i < 300; ++i) {
+        g.create_vertex(i);
+        if (i > 0) g.add_edge(g[i - 1], g[i], i);
+    }
+    g.add_edge(g[299], g[0], 300);
+    ASSERT_EQ(300, g.vertices_count());
+    ASSERT_EQ(150, g.get_edge(g[149], g[150])->weight());
+    ASSERT_FALSE(g.has_edge(g[150], g[149]));
+
+    auto copy = g;
+    copy.get_edge(copy[10], copy[11])->set_weight(-5);
+    ASSERT_EQ(11, g.get_edge(g[10], g[11])->weight());
+    ASSERT_EQ(-5, copy.get_edge(copy[10], copy[11])->weight());
+
+    size_t count = 0;
+    for (auto& v : copy)
+        for (auto e = v.cedges_begin(); e != v.cedges_end(); ++e) {
+            ASSERT_EQ((v.index() + 1) % 300, e->target().index());
+            ++count;
+        }
+    ASSERT_EQ(300, count);
+
+    auto moved = std::move(copy);
+    ASSERT_EQ(300, moved.get_edge(moved[299], moved[0])->weight());
+    ASSERT_EQ(&moved[0], &*moved[299].begin());
+}
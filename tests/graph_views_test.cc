@@ -0,0 +1,97 @@
+#include "graph_views.h"
+
+#include "graph.h"
+#include "graphs.h"
+#include "gtest/gtest.h"
+#include "test_utils.h"
+
+using namespace Graph;
+
+namespace {
+
+using G = AdjacencyLists<GraphType::DIGRAPH, int>;
+using W = AdjacencyLists<GraphType::DIGRAPH, int, double>;
+
+template <typename Graph>
+std::string adjacency(const Graph& g) {
+    std::stringstream ss;
+    for (auto v = g.cbegin(); v != g.cend(); ++v) {
+        ss << *v << ":";
+        for (auto w = v->cbegin(); w != v->cend(); ++w) ss << " " << *w;
+        ss << std::endl;
+    }
+    return ss.str();
+}
+
+}  // namespace
+
+TEST(Graph_views_test, reversed) {
+    for (auto& g : {Samples::digraph_sample<G>(), Samples::dag_sample<G>(),
+                    Samples::strong_components_sample<G>()}) {
+        ReversedView reversed(g);
+        ASSERT_EQ(g.vertices_count(), reversed.vertices_count());
+        ASSERT_EQ(adjacency(invert(g)), adjacency(reversed));
+        ASSERT_EQ(trace(invert(g)), trace(reversed));
+    }
+
+    // the shortest paths to a vertex
+    auto g = Samples::spt_sample<W>();
+    ReversedView reversed(g);
+    auto inverted = invert(g);
+    for (size_t t = 0; t < g.vertices_count(); ++t) {
+        Spt spt(reversed, reversed[t], 10.0);
+        Spt expected(inverted, inverted[t], 10.0);
+        ASSERT_EQ(stringify(expected.m_distance), stringify(spt.m_distance));
+        for (size_t v = 0; v < g.vertices_count(); ++v)
+            if (spt.m_spt[v].m_target) {
+                auto& e = spt.m_spt[v];
+                ASSERT_TRUE(g.has_edge(g[e.target()], g[e.source()]));
+                ASSERT_EQ(g.get_edge(g[e.target()], g[e.source()])->weight(),
+                          e.edge().weight());
+            }
+    }
+}
+
+TEST(Graph_views_test, filtered) {
+    auto g = Samples::spt_sample<W>();
+    auto light = [](const auto& e) { return e.edge().weight() < .45; };
+    FilteredView filtered(g, light);
+    W expected;
+    for (auto v = g.cbegin(); v != g.cend(); ++v)
+        expected.create_vertex(v->value());
+    for (auto v = g.cbegin(); v != g.cend(); ++v)
+        for (auto e = v->cedges_begin(); e != v->cedges_end(); ++e)
+            if (light(*e))
+                expected.add_edge(expected[*v], expected[e->target()],
+                                  e->edge().weight());
+    ASSERT_EQ(adjacency(expected), adjacency(filtered));
+    ASSERT_EQ(trace(expected), trace(filtered));
+    Spt spt(filtered, filtered[0], 10.0);
+    Spt expected_spt(expected, expected[0], 10.0);
+    ASSERT_EQ(stringify(expected_spt.m_distance), stringify(spt.m_distance));
+
+    // views compose
+    ReversedView reversed(filtered);
+    ASSERT_EQ(adjacency(invert(expected)), adjacency(reversed));
+}
+
+TEST(Graph_views_test, subset) {
+    auto g = Samples::strong_components_sample<G>();
+    Array<size_t> vertices = {12, 9, 10, 11, 3, 2};
+    SubsetView subset(g, vertices);
+    ASSERT_EQ(vertices.size(), subset.vertices_count());
+    G expected;
+    for (auto v : vertices) expected.create_vertex(g[v].value());
+    for (size_t i = 0; i < vertices.size(); ++i)
+        for (size_t j = 0; j < vertices.size(); ++j)
+            if (g.has_edge(g[vertices[i]], g[vertices[j]]))
+                expected.add_edge(expected[i], expected[j]);
+    ASSERT_EQ(adjacency(expected), adjacency(subset));
+    ASSERT_EQ(trace(expected), trace(subset));
+    ASSERT_EQ(stringify(strong_components_tarjan(expected)),
+              stringify(strong_components_tarjan(subset)));
+    ASSERT_EQ(stringify(topological_sort_relabel(expected)),
+              stringify(topological_sort_relabel(subset)));
+    for (size_t i = 0; i < vertices.size(); ++i)
+        ASSERT_EQ(&g[vertices[i]], &subset[i].base());
+}
@@ -0,0 +1,113 @@
+#include "hamilton.h"
+
+#include "graph.h"
+#include "graphs.h"
+#include "gtest/gtest.h"
+#include "random.h"
+#include "test_utils.h"
+
+using namespace Graph;
+
+namespace {
+
+using G = AdjacencyLists<GraphType::GRAPH, int>;
+using D = AdjacencyLists<GraphType::DIGRAPH, int>;
+
+template <typename Graph, typename P>
+void check_path(const Graph& g, const P& path, size_t s, size_t t) {
+    ASSERT_EQ(g.vertices_count(), path.size());
+    ASSERT_EQ(s, size_t(*path[0]));
+    ASSERT_EQ(t, size_t(*path[path.size() - 1]));
+    Array<char> visited(g.vertices_count(), false);
+    for (size_t i = 0; i < path.size(); ++i) {
+        ASSERT_FALSE(visited[*path[i]]);
+        visited[*path[i]] = true;
+        if (i > 0) {
+            ASSERT_TRUE(g.has_edge(*path[i - 1], *path[i]));
+        }
+    }
+}
+
+// every search agrees with compose_hamilton_path on the existence
+template <typename Graph>
+void check_searches(const Graph& g, size_t s, size_t t) {
+    bool expected = compose_hamilton_path(g, g[s], g[t]).size() > 0;
+    auto path = held_karp_hamilton_path(g, g[s], g[t]);
+    ASSERT_EQ(expected, path.size() > 0);
+    if (expected) check_path(g, path, s, t);
+    for (size_t threads : {1, 3}) {
+        path = HamiltonSearch<Graph>(g, threads).search(g[s], g[t]);
+        ASSERT_EQ(expected, path.size() > 0);
+        if (expected) check_path(g, path, s, t);
+    }
+}
+
+}  // namespace
+
+TEST(Hamilton_test, sample) {
+    auto g = Samples::hamilton_path_sample<G>();
+    for (auto& path :
+         {held_karp_hamilton_path(g, g[0], g[1]), hamilton_path(g, g[0], g[1]),
+          HamiltonSearch<G>(g, 2).search(g[0], g[1])})
+        check_path(g, path, 0, 1);
+    check_searches(g, 0, 1);
+    check_searches(g, 2, 5);
+}
+
+TEST(Hamilton_test, trivial) {
+    G g;
+    g.create_vertex(0);
+    ASSERT_EQ(1, held_karp_hamilton_path(g, g[0], g[0]).size());
+    g.create_vertex(1);
+    ASSERT_EQ(0, held_karp_hamilton_path(g, g[0], g[1]).size());
+    ASSERT_EQ(0, HamiltonSearch<G>(g, 2).search(g[0], g[1]).size());
+    g.add_edge(g[0], g[1]);
+    check_searches(g, 1, 0);
+    ASSERT_EQ(0, hamilton_path(g, g[0], g[0]).size());
+
+    while (g.vertices_count() <= Hamilton_ns::held_karp_max_vertices)
+        g.create_vertex(g.vertices_count());
+    ASSERT_THROW(held_karp_hamilton_path(g, g[0], g[1]),
+                 Hamilton_ns::TooManyVerticesException);
+}
+
+TEST(Hamilton_test, random_graphs) {
+    for (size_t seed = 1; seed <= 12; ++seed) {
+        auto g = random_graph<G>(10, 8 + seed, seed);
+        check_searches(g, 0, seed % 9 + 1);
+        auto d = random_graph<D>(9, 18 + 2 * seed, seed);
+        check_searches(d, seed % 9, 0);
+    }
+}
+
+TEST(Hamilton_test, large_graphs) {
+    // a hidden path among random edges
+    const size_t n = 60;
+    auto g = random_graph<G>(n, 60, 7);
+    RandomSequenceGenerator<size_t> generator(13, 0, n - 1);
+    Array<size_t> order(n);
+    for (size_t i = 0; i < n; ++i) order[i] = i;
+    for (size_t i = n - 1; i > 0; --i)
+        std::swap(order[i], order[generator.generate() % (i + 1)]);
+    for (size_t i = 1; i < n; ++i)
+        if (!g.has_edge(g[order[i - 1]], g[order[i]]))
+            g.add_edge(g[order[i - 1]], g[order[i]]);
+    for (size_t threads : {1, 4}) {
+        auto path = hamilton_path(g, g[order[0]], g[order[n - 1]], threads);
+        check_path(g, path, order[0], order[n - 1]);
+    }
+
+    // a vertex of degree one inside
+    g.create_vertex(n);
+    g.add_edge(g[n], g[order[n / 2]]);
+    ASSERT_EQ(0, hamilton_path(g, g[order[0]], g[order[n - 1]], 3).size());
+}
+
+TEST(Hamilton_test, dispatch) {
+    // past the dispatch cutoff a plain path skips the Held-Karp table
+    const size_t n = Hamilton_ns::held_karp_max_vertices;
+    G g;
+    for (size_t i = 0; i < n; ++i) g.create_vertex(i);
+    for (size_t i = 1; i < n; ++i) g.add_edge(g[i - 1], g[i]);
+    check_path(g, hamilton_path(g, g[0], g[n - 1]), 0, n - 1);
+}
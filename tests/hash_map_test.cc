@@ -0,0 +1,42 @@
+#include "hash_map.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+TEST(Hash_map_test, base) {
+    HashMap<size_t, std::string> map;
+    ASSERT_TRUE(map.empty());
+    ASSERT_EQ(nullptr, map.find(1));
+    ASSERT_FALSE(map.erase(1));
+
+    for (size_t i = 0; i < 100; ++i)
+        ASSERT_TRUE(map.insert(i * 7, std::to_string(i)).second);
+    ASSERT_EQ(100, map.size());
+    auto r = map.insert(14, "x");
+    ASSERT_FALSE(r.second);
+    ASSERT_EQ("2", *r.first);
+    for (size_t i = 0; i < 100; ++i)
+        ASSERT_EQ(std::to_string(i), *map.find(i * 7));
+    ASSERT_EQ(nullptr, map.find(3));
+
+    for (size_t i = 0; i < 100; i += 2) ASSERT_TRUE(map.erase(i * 7));
+    ASSERT_EQ(50, map.size());
+    for (size_t i = 0; i < 100; ++i)
+        if (i % 2)
+            ASSERT_EQ(std::to_string(i), *map.find(i * 7));
+        else
+            ASSERT_EQ(nullptr, map.find(i * 7));
+
+    size_t sum = 0;
+    map.for_each([&sum](size_t key, const std::string&) { sum += key; });
+    ASSERT_EQ(7 * 50 * 50, sum);
+
+    auto copy = map;
+    *copy.find(7) = "y";
+    ASSERT_EQ("1", *map.find(7));
+    map.clear();
+    ASSERT_TRUE(map.empty());
+    ASSERT_EQ(nullptr, map.find(7));
+    ASSERT_EQ("y", *copy.find(7));
+}
@@ -0,0 +1,68 @@
+#include "johnson.h"
+
+#include "graph.h"
+#include "gtest/gtest.h"
+#include "test_utils.h"
+
+using namespace Graph;
+
+namespace {
+
+using G = AdjacencyLists<GraphType::DIGRAPH, size_t, long>;
+
+}  // namespace
+
+TEST(Johnson_test, negative_arcs) {
+    ShiftedGraph<G> g(300, 1500, 37);
+    size_t negative = 0;
+    for (auto v = g.m_shifted.cbegin(); v != g.m_shifted.cend(); ++v)
+        for (auto e = v->cedges_begin(); e != v->cedges_end(); ++e)
+            if (e->edge().weight() < 0) ++negative;
+    ASSERT_LT(0, negative);
+
+    const long max_weight = 1L << 40;
+    for (size_t threads : {1, 3}) {
+        Johnson johnson(g.m_shifted, max_weight, threads);
+        ASSERT_FALSE(johnson.has_negative_cycle());
+        for (size_t s = 0; s < g.m_base.vertices_count(); s += 7) {
+            Spt spt(g.m_base, g.m_base[s], max_weight);
+            for (size_t t = 0; t < g.m_base.vertices_count(); ++t)
+                if (spt.m_distance[t] == max_weight) {
+                    ASSERT_EQ(max_weight, johnson.distance(s, t));
+                } else {
+                    ASSERT_EQ(spt.m_distance[t] + g.m_p[s] - g.m_p[t],
+                              johnson.distance(s, t));
+                }
+        }
+    }
+}
+
+TEST(Johnson_test, negative_cycle) {
+    ShiftedGraph<G> g(50, 200, 37);
+    auto& s = g.m_shifted;
+    s.add_edge(s[10], s[11], -100);
+    s.add_edge(s[11], s[12], 10);
+    s.add_edge(s[12], s[10], 10);
+    for (size_t threads : {1, 3}) {
+        Johnson johnson(s, 1L << 40, threads);
+        ASSERT_TRUE(johnson.has_negative_cycle());
+
+        // walk into the cycle, then around it
+        auto v = johnson.negative_cycle().cbegin();
+        for (size_t i = 0; i < s.vertices_count(); ++i) ++v;
+        auto first = *v;
+        long length = 0;
+        do {
+            auto from = *v;
+            ++v;
+            long weight = 1L << 40;
+            for (auto e = s[from].cedges_begin(); e != s[from].cedges_end();
+                 ++e)
+                if (size_t(e->target()) == *v)
+                    weight = std::min(weight, e->edge().weight());
+            ASSERT_GT(1L << 40, weight);
+            length += weight;
+        } while (*v != first);
+        ASSERT_GT(0, length);
+    }
+}
@@ -0,0 +1,60 @@
+#include "mst.h"
+
+#include <set>
+#include <utility>
+
+#include "adjacency_matrix.h"
+#include "graph.h"
+#include "graphs.h"
+#include "gtest/gtest.h"
+#include "test_utils.h"
+
+using namespace Graph;
+
+namespace {
+
+template <typename M>
+auto edges_and_weight(const M& mst) {
+    std::set<std::pair<size_t, size_t>> edges;
+    double weight = 0;
+    for (auto v = mst.cbegin(); v != mst.cend(); ++v)
+        for (auto e = v->cedges_begin(); e != v->cedges_end(); ++e) {
+            size_t s = e->source(), t = e->target();
+            edges.emplace(std::min(s, t), std::max(s, t));
+            weight += e->edge().weight();
+        }
+    return std::make_pair(edges, weight);
+}
+
+template <typename G>
+void test_sample() {
+    auto g = Samples::weighted_graph_sample<G>();
+    auto expected = edges_and_weight(pq_mst(g));
+    ASSERT_EQ(g.vertices_count() - 1, expected.first.size());
+    ASSERT_EQ(expected, edges_and_weight(kruskal_mst(g)));
+    for (size_t threads : {1, 3})
+        ASSERT_EQ(expected, edges_and_weight(boruvka_mst(g, threads)));
+}
+
+}  // namespace
+
+TEST(Mst_test, sample) {
+    test_sample<AdjacencyLists<GraphType::GRAPH, int, double>>();
+    test_sample<AdjacencyMatrix<GraphType::GRAPH, int, double>>();
+}
+
+TEST(Mst_test, random_forest_with_ties) {
+    using G = AdjacencyLists<GraphType::GRAPH, size_t, long>;
+    const size_t n = 2000;
+    // the last vertices stay isolated, the weights repeat
+    auto g = random_graph<G>(n - 10, 3 * n, 29,
+                             [](size_t r) { return long(r % 20); });
+    for (size_t i = n - 10; i < n; ++i) g.create_vertex(i);
+    auto kruskal = edges_and_weight(kruskal_mst(g));
+    ASSERT_EQ(edges_and_weight(pq_mst(g)).second, kruskal.second);
+    UnionFind components(n);
+    for (auto& e : kruskal.first)
+        ASSERT_TRUE(components.unite(e.first, e.second));
+    for (size_t threads : {1, 2, 3})
+        ASSERT_EQ(kruskal, edges_and_weight(boruvka_mst(g, threads)));
+}
@@ -0,0 +1,103 @@
+#include "point_to_point.h"
+
+#include <cstdlib>
+
+#include "graph.h"
+#include "gtest/gtest.h"
+#include "random.h"
+#include "test_utils.h"
+
+using namespace Graph;
+
+namespace {
+
+template <typename P, typename G>
+void check_path(const P& engine, const G& g, size_t s, size_t t) {
+    auto path = engine.path();
+    size_t v = s;
+    typename G::edge_type::value_type length = 0;
+    for (auto e = path.cbegin(); e != path.cend(); ++e) {
+        ASSERT_EQ(v, size_t(e->source()));
+        ASSERT_TRUE(g.has_edge(e->source(), e->target()));
+        length += e->edge().weight();
+        v = e->target();
+    }
+    ASSERT_EQ(t, v);
+    ASSERT_EQ(engine.distance(), length);
+}
+
+}  // namespace
+
+TEST(Point_to_point_test, bidirectional_dijkstra) {
+    using G = AdjacencyLists<GraphType::DIGRAPH, size_t, long>;
+    const size_t n = 400;
+    auto g =
+        random_graph<G>(n, 3 * n, 17, [](size_t r) { return 1 + long(r); });
+    const long max_weight = 1L << 40;
+    PointToPoint engine(g);
+    for (size_t s = 0; s < n; s += 23) {
+        Spt spt(g, g[s], max_weight);
+        for (size_t t = 0; t < n; t += 7) {
+            bool found = engine.search(g[s], g[t]);
+            ASSERT_EQ(spt.m_distance[t] != max_weight, found);
+            if (!found) continue;
+            ASSERT_EQ(spt.m_distance[t], engine.distance());
+            check_path(engine, g, s, t);
+        }
+    }
+}
+
+TEST(Point_to_point_test, a_star) {
+    // grid whose vertex values are the coordinates x * side + y
+    using G = AdjacencyLists<GraphType::GRAPH, size_t, long>;
+    const size_t side = 40;
+    G g;
+    for (size_t i = 0; i < side * side; ++i) g.create_vertex(i);
+    RandomSequenceGenerator<size_t> generator(19, 1, 3);
+    for (size_t x = 0; x < side; ++x)
+        for (size_t y = 0; y < side; ++y) {
+            auto& v = g[x * side + y];
+            if (x + 1 < side)
+                g.add_edge(v, g[(x + 1) * side + y], generator.generate());
+            if (y + 1 < side)
+                g.add_edge(v, g[x * side + y + 1], generator.generate());
+        }
+    auto manhattan = [&](size_t v, size_t w) {
+        return long(std::labs(long(v / side) - long(w / side)) +
+                    std::labs(long(v % side) - long(w % side)));
+    };
+
+    PointToPoint dijkstra(g);
+    PointToPoint a_star(g);
+    for (size_t s = 0; s < side * side; s += 97)
+        for (size_t t = 5; t < side * side; t += 131) {
+            ASSERT_TRUE(dijkstra.search(g[s], g[t]));
+            ASSERT_TRUE(a_star.search(g[s], g[t], [&](auto& v) {
+                return manhattan(v.value(), t);
+            }));
+            ASSERT_EQ(dijkstra.distance(), a_star.distance());
+            check_path(a_star, g, s, t);
+            check_path(dijkstra, g, s, t);
+        }
+
+    // the heuristic steers the search toward the target
+    ASSERT_TRUE(a_star.search(g[0], g[side - 1], [&](auto& v) {
+        return manhattan(v.value(), side - 1);
+    }));
+    Spt spt(g, g[0], 1L << 40);
+    ASSERT_EQ(spt.m_distance[side - 1], a_star.distance());
+    ASSERT_GT(side * side / 2, a_star.settled_count());
+}
+
+TEST(Point_to_point_test, same_vertex) {
+    using G = AdjacencyLists<GraphType::DIGRAPH, size_t, long>;
+    G g;
+    g.create_vertex(0);
+    g.create_vertex(1);
+    PointToPoint engine(g);
+    ASSERT_TRUE(engine.search(g[0], g[0]));
+    ASSERT_EQ(0, engine.distance());
+    ASSERT_EQ(0, engine.path().size());
+    ASSERT_FALSE(engine.search(g[0], g[1]));
+    ASSERT_EQ(0, engine.path().size());
+}
@@ -0,0 +1,47 @@
+#include "small_vector.h"
+
+#include <sstream>
+#include <string>
+
+#include "gtest/gtest.h"
+
+TEST(Small_vector_test, base) {
+    auto to_string = [](const auto& v) {
+        std::stringstream ss;
+        ss << v;
+        return ss.str();
+    };
+    SmallVector<int, 4> v;
+    ASSERT_TRUE(v.empty());
+    for (int i = 0; i < 4; ++i) v.push_back(i);
+    ASSERT_EQ(4, v.capacity());
+    ASSERT_EQ("[0, 1, 2, 3]", to_string(v));
+    for (int i = 4; i < 10; ++i) v.emplace_back(i);
+    ASSERT_EQ(10, v.size());
+    ASSERT_EQ("[0, 1, 2, 3, 4, 5, 6, 7, 8, 9]", to_string(v));
+
+    ASSERT_TRUE(v.remove_first_if([](int i) { return i == 3; }));
+    ASSERT_FALSE(v.remove_first_if([](int i) { return i == 3; }));
+    ASSERT_EQ("[0, 1, 2, 4, 5, 6, 7, 8, 9]", to_string(v));
+
+    auto copy = v;
+    copy[0] = 10;
+    ASSERT_EQ("[10, 1, 2, 4, 5, 6, 7, 8, 9]", to_string(copy));
+    ASSERT_EQ("[0, 1, 2, 4, 5, 6, 7, 8, 9]", to_string(v));
+
+    auto moved = std::move(copy);
+    ASSERT_TRUE(copy.empty());
+    ASSERT_EQ("[10, 1, 2, 4, 5, 6, 7, 8, 9]", to_string(moved));
+
+    SmallVector<std::string, 2> s;
+    s.push_back("a");
+    auto s_moved = std::move(s);
+    ASSERT_TRUE(s.empty());
+    ASSERT_EQ("[a]", to_string(s_moved));
+    s = s_moved;
+    s.push_back("b");
+    s.push_back("c");
+    ASSERT_EQ("[a, b, c]", to_string(s));
+    s.clear();
+    ASSERT_TRUE(s.empty());
+}
@@ -0,0 +1,70 @@
+#include "strong_components.h"
+
+#include "csr.h"
+#include "graph.h"
+#include "graphs.h"
+#include "gtest/gtest.h"
+#include "test_utils.h"
+
+using namespace Graph;
+
+namespace {
+
+using G = AdjacencyLists<GraphType::DIGRAPH, size_t>;
+
+// the same partition as the reference, numbered from 0 in reverse
+// topological order
+template <typename C>
+void check_components(const C& g, const Array<size_t>& expected,
+                      const Array<size_t>& actual) {
+    auto count = g.vertices_count();
+    size_t components = 0;
+    for (size_t v = 0; v < count; ++v) {
+        components = std::max(components, expected[v] + 1);
+        for (size_t w = 0; w < v; ++w)
+            ASSERT_EQ(expected[v] == expected[w], actual[v] == actual[w]);
+    }
+    for (size_t v = 0; v < count; ++v) ASSERT_GT(components, actual[v]);
+    for (auto v = g.cbegin(); v != g.cend(); ++v)
+        for (auto w = v->cbegin(); w != v->cend(); ++w)
+            ASSERT_GE(actual[*v], actual[*w]);
+}
+
+}  // namespace
+
+TEST(Strong_components_test, sample) {
+    auto g = Samples::strong_components_sample<G>();
+    auto expected = strong_components_tarjan(g);
+    ASSERT_EQ(stringify(expected), stringify(strong_components_kosaraju(g)));
+    for (size_t threads : {1, 3})
+        check_components(g, expected, strong_components_parallel(g, threads));
+}
+
+TEST(Strong_components_test, random_digraphs) {
+    // below, near and above the threshold of a giant component
+    for (size_t degree : {1, 2, 4}) {
+        auto g = random_graph<G>(600, 600 * degree, 7 + degree);
+        auto expected = strong_components_tarjan(g);
+        check_components(g, expected, strong_components_kosaraju(g));
+        for (size_t threads : {1, 2, 4})
+            check_components(g, expected,
+                             strong_components_parallel(g, threads));
+    }
+}
+
+TEST(Strong_components_test, csr_and_cycles) {
+    G g;
+    const size_t n = 300;
+    for (size_t i = 0; i < n; ++i) g.create_vertex(i);
+    // rings of 10 chained one way, each with a self loop and a tail
+    for (size_t i = 0; i < n; i += 15) {
+        for (size_t j = 0; j < 10; ++j)
+            g.add_edge(g[i + j], g[i + (j + 1) % 10]);
+        g.add_edge(g[i], g[i]);
+        for (size_t j = 10; j < 15; ++j) g.add_edge(g[i + j - 1], g[i + j]);
+        if (i + 15 < n) g.add_edge(g[i + 14], g[i + 15]);
+    }
+    Csr<GraphType::DIGRAPH, size_t> csr(g);
+    auto expected = strong_components_tarjan(g);
+    check_components(g, expected, strong_components_parallel(csr, 3));
+}
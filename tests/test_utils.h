@@ -1,7 +1,12 @@
 #pragma once
 
+#include <cstddef>
 #include <sstream>
 #include <string>
+#include <type_traits>
+
+#include "random.h"
+
 template <typename T>
 std::string stringify(const T& t) {
     std::stringstream ss;
@@ -19,3 +24,66 @@ inline std::stringstream& reset(std::stringstream& ss) {
     ss.str("");
     return ss;
 }
+
+// the DFS trace of a graph, found by argument-dependent lookup
+template <typename G>
+std::string trace(const G& g) {
+    std::stringstream ss;
+    trace_dfs(g, reset_with_new_line(ss));
+    return ss.str();
+}
+
+/**
+ * A graph G on vertices_count vertices, with an edge for each of edges_count
+ * random pairs from seed, less the self loops and the pairs drawn before. A
+ * weighted edge takes weight_fn(r), r a further draw below vertices_count.
+ */
+template <typename G, typename F = std::nullptr_t>
+G random_graph(size_t vertices_count, size_t edges_count, unsigned long seed,
+               F weight_fn = nullptr) {
+    G g;
+    for (size_t i = 0; i < vertices_count; ++i) g.create_vertex(i);
+    RandomSequenceGenerator<size_t> generator(seed, 0, vertices_count - 1);
+    for (size_t i = 0; i < edges_count; ++i) {
+        auto& v = g[generator.generate()];
+        auto& w = g[generator.generate()];
+        if (v == w || g.has_edge(v, w)) continue;
+        if constexpr (std::is_null_pointer_v<F>)
+            g.add_edge(v, w);
+        else
+            g.add_edge(v, w, weight_fn(generator.generate()));
+    }
+    return g;
+}
+
+/**
+ * A random digraph G with the weights base(v, w) + p(v) - p(w), p random
+ * too: negative arcs, but no negative cycle, and the distances are those of
+ * the base weights shifted by p.
+ */
+template <typename G>
+struct ShiftedGraph {
+    G m_base;
+    G m_shifted;
+    Array<long> m_p;
+
+    ShiftedGraph(size_t vertices_count, size_t edges_count,
+                 unsigned long seed)
+        : m_p(vertices_count) {
+        RandomSequenceGenerator<size_t> generator(seed, 0, vertices_count - 1);
+        for (size_t i = 0; i < vertices_count; ++i) {
+            m_base.create_vertex(i);
+            m_shifted.create_vertex(i);
+            m_p[i] = long(generator.generate() % 50);
+        }
+        for (size_t i = 0; i < edges_count; ++i) {
+            auto v = generator.generate();
+            auto w = generator.generate();
+            if (v == w || m_base.has_edge(m_base[v], m_base[w])) continue;
+            long weight = 1 + long(generator.generate() % 100);
+            m_base.add_edge(m_base[v], m_base[w], weight);
+            m_shifted.add_edge(m_shifted[v], m_shifted[w],
+                               weight + m_p[v] - m_p[w]);
+        }
+    }
+};
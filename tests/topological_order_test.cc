@@ -0,0 +1,85 @@
+#include "topological_order.h"
+
+#include "graph.h"
+#include "graphs.h"
+#include "gtest/gtest.h"
+#include "random.h"
+#include "test_utils.h"
+
+using namespace Graph;
+
+namespace {
+
+using G = AdjacencyLists<GraphType::DIGRAPH, int>;
+
+void check_order(const DynamicTopologicalOrder<G>& order) {
+    auto& g = order.graph();
+    auto snapshot = order.snapshot();
+    ASSERT_EQ(g.vertices_count(), snapshot->size());
+    for (size_t i = 0; i < snapshot->size(); ++i)
+        ASSERT_EQ(i, order.position(g[(*snapshot)[i]]));
+    for (auto v = g.cbegin(); v != g.cend(); ++v)
+        for (auto w = v->cbegin(); w != v->cend(); ++w)
+            ASSERT_LT(order.position(*v), order.position(*w));
+}
+
+}  // namespace
+
+TEST(Topological_order_test, sample) {
+    auto g = Samples::dag_sample<G>();
+    DynamicTopologicalOrder order(g);
+    check_order(order);
+    auto snapshot = order.snapshot();
+    auto first = *snapshot;
+
+    // 2 -> 3 -> 5 -> 4 in the sample
+    ASSERT_FALSE(order.add_edge(g[4], g[2]));
+    ASSERT_FALSE(order.add_edge(g[3], g[3]));
+    ASSERT_TRUE(order.add_edge(g[3], g[2]) || order.add_edge(g[2], g[3]));
+    check_order(order);
+    ASSERT_TRUE(order.add_edge(g[12], g[0]) || order.add_edge(g[0], g[12]));
+    check_order(order);
+
+    // the snapshot taken before keeps its order
+    ASSERT_EQ(first.size(), snapshot->size());
+    for (size_t i = 0; i < first.size(); ++i)
+        ASSERT_EQ(first[i], (*snapshot)[i]);
+
+    auto& v = order.create_vertex(13);
+    ASSERT_TRUE(order.add_edge(v, g[0]));
+    ASSERT_TRUE(order.add_edge(g[0], g[6]));
+    check_order(order);
+    order.remove_edge(v, g[0]);
+    ASSERT_FALSE(g.has_edge(v, g[0]));
+    ASSERT_TRUE(order.add_edge(g[4], v));
+    check_order(order);
+}
+
+TEST(Topological_order_test, cyclic_graph) {
+    auto g = Samples::digraph_sample<G>();
+    ASSERT_THROW(DynamicTopologicalOrder<G>{g}, InvalidDagException);
+}
+
+TEST(Topological_order_test, random_edits) {
+    const size_t n = 60;
+    G g;
+    for (size_t i = 0; i < n; ++i) g.create_vertex(i);
+    DynamicTopologicalOrder order(g);
+    RandomSequenceGenerator<size_t> generator(11, 0, n - 1);
+    for (size_t i = 0; i < 1500; ++i) {
+        auto& v = g[generator.generate()];
+        auto& w = g[generator.generate()];
+        if (i % 5 == 4) {
+            order.remove_edge(v, w);
+            ASSERT_FALSE(g.has_edge(v, w));
+            continue;
+        }
+        bool existed = g.has_edge(v, w);
+        bool acyclic = existed || !has_simple_path(g, w, v);
+        ASSERT_EQ(acyclic, order.add_edge(v, w));
+        ASSERT_EQ(acyclic, g.has_edge(v, w));
+        if (i % 50 == 0) check_order(order);
+    }
+    check_order(order);
+    ASSERT_TRUE(is_dag(g));
+}
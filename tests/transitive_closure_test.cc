@@ -0,0 +1,56 @@
+#include "transitive_closure.h"
+
+#include "graph.h"
+#include "graphs.h"
+#include "gtest/gtest.h"
+#include "random.h"
+#include "test_utils.h"
+
+using namespace Graph;
+
+namespace {
+
+using G = AdjacencyLists<GraphType::DIGRAPH, int>;
+
+void check_closure(const G& g) {
+    auto expected = dfs_transitive_closure(g);
+    for (size_t threads : {1, 3}) {
+        TransitiveClosure closure(g, threads);
+        for (size_t v = 0; v < g.vertices_count(); ++v)
+            for (size_t w = 0; w < g.vertices_count(); ++w)
+                ASSERT_EQ(expected.has_edge(expected[v], expected[w]),
+                          closure.reachable(v, w));
+    }
+}
+
+}  // namespace
+
+TEST(Transitive_closure_test, samples) {
+    check_closure(Samples::digraph_sample<G>());
+    check_closure(Samples::dag_sample<G>());
+    check_closure(Samples::strong_components_sample<G>());
+
+    auto g = Samples::strong_components_sample<G>();
+    TransitiveClosure closure(g, 2);
+    ASSERT_EQ(4, closure.components_count());
+    ASSERT_EQ(closure.component(0), closure.component(5));
+    ASSERT_TRUE(closure.reachable(7, 12));
+    ASSERT_FALSE(closure.reachable(12, 7));
+}
+
+TEST(Transitive_closure_test, random_digraphs) {
+    // a sparse DAG-like graph and one with cycles, over 64 components
+    for (size_t edges : {250, 400}) {
+        G g;
+        const size_t n = 200;
+        for (size_t i = 0; i < n; ++i) g.create_vertex(i);
+        RandomSequenceGenerator<size_t> generator(edges, 0, n - 1);
+        for (size_t i = 0; i < edges; ++i) {
+            auto v = generator.generate();
+            auto w = generator.generate();
+            if (edges < 300 && v > w) std::swap(v, w);
+            if (!g.has_edge(g[v], g[w])) g.add_edge(g[v], g[w]);
+        }
+        check_closure(g);
+    }
+}
@@ -0,0 +1,27 @@
+#include "union_find.h"
+
+#include "gtest/gtest.h"
+
+TEST(Union_find_test, base) {
+    UnionFind sets(10);
+    ASSERT_EQ(10, sets.count());
+    ASSERT_TRUE(sets.unite(0, 1));
+    ASSERT_TRUE(sets.unite(2, 3));
+    ASSERT_TRUE(sets.unite(1, 3));
+    ASSERT_FALSE(sets.unite(0, 2));
+    ASSERT_EQ(7, sets.count());
+    ASSERT_TRUE(sets.connected(0, 3));
+    ASSERT_FALSE(sets.connected(0, 4));
+    for (size_t i = 4; i < 9; ++i) sets.unite(i, i + 1);
+    ASSERT_EQ(2, sets.count());
+    ASSERT_EQ(sets.find(4), sets.find(9));
+    ASSERT_NE(sets.find(0), sets.find(9));
+}
+
+TEST(Union_find_test, chain) {
+    const size_t n = 1000;
+    UnionFind sets(n);
+    for (size_t i = 1; i < n; ++i) ASSERT_TRUE(sets.unite(i - 1, i));
+    ASSERT_EQ(1, sets.count());
+    for (size_t i = 0; i < n; ++i) ASSERT_EQ(sets.find(0), sets.find(i));
+}
@@ -0,0 +1,110 @@
+#include "vertex_heaps.h"
+
+#include "graph.h"
+#include "graphs.h"
+#include "gtest/gtest.h"
+#include "network_flow.h"
+#include "random.h"
+#include "test_utils.h"
+
+using namespace Graph;
+
+namespace {
+
+template <template <typename, typename> class H>
+void test_heap() {
+    const size_t n = 500;
+    Array<size_t> ids(n);
+    for (size_t i = 0; i < n; ++i) ids[i] = i;
+    Array<long> weights(n);
+    Array<bool> in_heap(n, true);
+    RandomSequenceGenerator<size_t> generator(5, 0, 1000);
+
+    H<const size_t*, long> heap(n, weights);
+    for (size_t i = 0; i < n; ++i) {
+        weights[i] = 1000 + generator.generate();
+        heap.push(&ids[i]);
+    }
+    long last = 0;
+    for (size_t popped = 0; popped < n; ++popped) {
+        // keys only drop to values not below the last minimum, as in
+        // Dijkstra, so that the radix heap applies as well
+        for (size_t k = 0; k < 3; ++k) {
+            auto i = generator.generate() % n;
+            if (!in_heap[i]) continue;
+            auto key = last + long(generator.generate());
+            if (key < weights[i]) {
+                weights[i] = key;
+                heap.move_up(&ids[i]);
+            }
+        }
+        long min = -1;
+        for (size_t i = 0; i < n; ++i)
+            if (in_heap[i] && (min < 0 || weights[i] < min)) min = weights[i];
+        ASSERT_EQ(n - popped, heap.size());
+        auto v = *heap.pop();
+        ASSERT_TRUE(in_heap[v]);
+        ASSERT_EQ(min, weights[v]);
+        in_heap[v] = false;
+        last = min;
+    }
+    ASSERT_TRUE(heap.empty());
+}
+
+template <typename G>
+std::string representation(const G& g) {
+    std::stringstream ss;
+    print_representation(g, ss);
+    return ss.str();
+}
+
+}  // namespace
+
+TEST(Vertex_heaps_test, heaps) {
+    test_heap<VertexHeap>();
+    test_heap<QuaternaryVertexHeap>();
+    test_heap<OctonaryVertexHeap>();
+    test_heap<PairingVertexHeap>();
+    test_heap<RadixVertexHeap>();
+}
+
+TEST(Vertex_heaps_test, spt) {
+    using G = AdjacencyLists<GraphType::DIGRAPH, size_t, long>;
+    auto g =
+        random_graph<G>(300, 1500, 11, [](size_t r) { return 1 + long(r); });
+    const long max_weight = 1 << 30;
+    for (size_t s = 0; s < g.vertices_count(); s += 37) {
+        Spt expected(g, g[s], max_weight);
+        auto test = [&](const auto& spt) {
+            ASSERT_EQ(stringify(expected.m_distance),
+                      stringify(spt.m_distance));
+        };
+        test(Spt<G, QuaternaryVertexHeap>(g, g[s], max_weight));
+        test(Spt<G, OctonaryVertexHeap>(g, g[s], max_weight));
+        test(Spt<G, PairingVertexHeap>(g, g[s], max_weight));
+        test(Spt<G, RadixVertexHeap>(g, g[s], max_weight));
+    }
+}
+
+TEST(Vertex_heaps_test, pq_mst) {
+    using G = AdjacencyLists<GraphType::GRAPH, int, double>;
+    auto g = Samples::weighted_graph_sample<G>();
+    auto expected = representation(pq_mst(g));
+    ASSERT_EQ(expected, representation(pq_mst<QuaternaryVertexHeap>(g)));
+    ASSERT_EQ(expected, representation(pq_mst<PairingVertexHeap>(g)));
+}
+
+TEST(Vertex_heaps_test, max_flow) {
+    using namespace Network_flow_ns;
+    auto g = Samples::flow_sample();
+    MaxFlow m(g, g[0], g[5], g.vertices_count() * 10);
+    auto expected = representation(g);
+    g = Samples::flow_sample();
+    MaxFlow<decltype(g), OctonaryVertexHeap> m8(g, g[0], g[5],
+                                                g.vertices_count() * 10);
+    ASSERT_EQ(expected, representation(g));
+    g = Samples::flow_sample();
+    MaxFlow<decltype(g), PairingVertexHeap> mp(g, g[0], g[5],
+                                               g.vertices_count() * 10);
+    ASSERT_EQ(expected, representation(g));
+}